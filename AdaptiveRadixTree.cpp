@@ -0,0 +1,546 @@
+/**
+ * @file AdaptiveRadixTree.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "AdaptiveRadixTree.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace ECE141 {
+
+struct AdaptiveRadixTree::Node {
+  Kind kind;
+  explicit Node(Kind aKind) : kind{aKind} {}
+  virtual ~Node() = default;
+};
+
+struct AdaptiveRadixTree::Leaf : Node {
+  std::string key;  // the whole key
+  uint32_t value;
+  Leaf(std::string aKey, uint32_t aValue)
+      : Node{Kind::leaf}, key{std::move(aKey)}, value{aValue} {}
+};
+
+struct AdaptiveRadixTree::Inner : Node {
+  std::string prefix;  // bytes shared by every key below, after the edge
+  std::unique_ptr<Leaf> terminal;  // the key that ends at this node
+  uint16_t children{0};
+  using Node::Node;
+};
+
+// 4 and 16: sorted edge bytes next to their children
+struct AdaptiveRadixTree::Node4 : Inner {
+  std::array<uint8_t, 4> bytes{};
+  std::array<NodePtr, 4> slots;
+  Node4() : Inner{Kind::node4} {}
+};
+
+struct AdaptiveRadixTree::Node16 : Inner {
+  std::array<uint8_t, 16> bytes{};
+  std::array<NodePtr, 16> slots;
+  Node16() : Inner{Kind::node16} {}
+};
+
+// 48: a byte -> slot table (0 = none, else slot + 1)
+struct AdaptiveRadixTree::Node48 : Inner {
+  std::array<uint8_t, 256> index{};
+  std::array<NodePtr, 48> slots;
+  Node48() : Inner{Kind::node48} {}
+};
+
+struct AdaptiveRadixTree::Node256 : Inner {
+  std::array<NodePtr, 256> slots;
+  Node256() : Inner{Kind::node256} {}
+};
+
+AdaptiveRadixTree::AdaptiveRadixTree() = default;
+AdaptiveRadixTree::~AdaptiveRadixTree() = default;
+AdaptiveRadixTree::AdaptiveRadixTree(AdaptiveRadixTree &&) noexcept = default;
+AdaptiveRadixTree &AdaptiveRadixTree::operator=(AdaptiveRadixTree &&) noexcept =
+    default;
+
+// --------------------------------------------------------------------------
+// children
+
+// a sorted small node: slot of aByte, or where it would go
+template <typename T>
+static size_t slotOf(const T &aNode, uint8_t aByte) {
+  return static_cast<size_t>(
+      std::lower_bound(aNode.bytes.begin(), aNode.bytes.begin() + aNode.children,
+                       aByte) -
+      aNode.bytes.begin());
+}
+
+AdaptiveRadixTree::NodePtr *AdaptiveRadixTree::findChild(Inner &aNode,
+                                                         uint8_t aByte) {
+  switch (aNode.kind) {
+    case Kind::node4: {
+      auto &theNode = static_cast<Node4 &>(aNode);
+      for (size_t i = 0; i < theNode.children; i++) {
+        if (theNode.bytes[i] == aByte) {
+          return &theNode.slots[i];
+        }
+      }
+      return nullptr;
+    }
+    case Kind::node16: {
+      auto &theNode = static_cast<Node16 &>(aNode);
+      size_t theSlot = slotOf(theNode, aByte);
+      return (theSlot < theNode.children && theNode.bytes[theSlot] == aByte)
+                 ? &theNode.slots[theSlot]
+                 : nullptr;
+    }
+    case Kind::node48: {
+      auto &theNode = static_cast<Node48 &>(aNode);
+      uint8_t theSlot = theNode.index[aByte];
+      return theSlot ? &theNode.slots[theSlot - 1] : nullptr;
+    }
+    case Kind::node256: {
+      auto &theSlot = static_cast<Node256 &>(aNode).slots[aByte];
+      return theSlot ? &theSlot : nullptr;
+    }
+    default:
+      return nullptr;
+  }
+}
+
+// move the prefix, terminal and children of aFrom into a node of another size
+template <typename T, typename S>
+static std::unique_ptr<T> moveHeader(S &aFrom) {
+  auto theNode = std::make_unique<T>();
+  theNode->prefix = std::move(aFrom.prefix);
+  theNode->terminal = std::move(aFrom.terminal);
+  return theNode;
+}
+
+void AdaptiveRadixTree::addChild(NodePtr &aRef, uint8_t aByte, NodePtr aChild) {
+  auto &theInner = static_cast<Inner &>(*aRef);
+  switch (aRef->kind) {
+    case Kind::node4:
+    case Kind::node16: {
+      bool isSmall = Kind::node4 == aRef->kind;
+      size_t theCapacity = isSmall ? 4 : 16;
+      if (theInner.children == theCapacity) {
+        // grow: 4 -> 16, 16 -> 48
+        NodePtr theBigger;
+        if (isSmall) {
+          auto theNode = moveHeader<Node16>(theInner);
+          auto &theOld = static_cast<Node4 &>(*aRef);
+          for (size_t i = 0; i < 4; i++) {
+            theNode->bytes[i] = theOld.bytes[i];
+            theNode->slots[i] = std::move(theOld.slots[i]);
+          }
+          theNode->children = 4;
+          theBigger = std::move(theNode);
+        } else {
+          auto theNode = moveHeader<Node48>(theInner);
+          auto &theOld = static_cast<Node16 &>(*aRef);
+          for (size_t i = 0; i < 16; i++) {
+            theNode->index[theOld.bytes[i]] = static_cast<uint8_t>(i + 1);
+            theNode->slots[i] = std::move(theOld.slots[i]);
+          }
+          theNode->children = 16;
+          theBigger = std::move(theNode);
+        }
+        aRef = std::move(theBigger);
+        addChild(aRef, aByte, std::move(aChild));
+        return;
+      }
+      auto insertSorted = [&](auto &aNode) {
+        size_t theSlot = slotOf(aNode, aByte);
+        for (size_t i = aNode.children; i > theSlot; i--) {
+          aNode.bytes[i] = aNode.bytes[i - 1];
+          aNode.slots[i] = std::move(aNode.slots[i - 1]);
+        }
+        aNode.bytes[theSlot] = aByte;
+        aNode.slots[theSlot] = std::move(aChild);
+        aNode.children++;
+      };
+      if (isSmall) {
+        insertSorted(static_cast<Node4 &>(*aRef));
+      } else {
+        insertSorted(static_cast<Node16 &>(*aRef));
+      }
+      return;
+    }
+    case Kind::node48: {
+      auto &theNode = static_cast<Node48 &>(*aRef);
+      if (48 == theNode.children) {
+        auto theBigger = moveHeader<Node256>(theInner);
+        for (unsigned b = 0; b < 256; b++) {
+          if (theNode.index[b]) {
+            theBigger->slots[b] = std::move(theNode.slots[theNode.index[b] - 1]);
+          }
+        }
+        theBigger->children = 48;
+        aRef = std::move(theBigger);
+        addChild(aRef, aByte, std::move(aChild));
+        return;
+      }
+      size_t theSlot{0};
+      while (theNode.slots[theSlot]) {
+        theSlot++;
+      }
+      theNode.slots[theSlot] = std::move(aChild);
+      theNode.index[aByte] = static_cast<uint8_t>(theSlot + 1);
+      theNode.children++;
+      return;
+    }
+    case Kind::node256: {
+      auto &theNode = static_cast<Node256 &>(*aRef);
+      theNode.slots[aByte] = std::move(aChild);
+      theNode.children++;
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+void AdaptiveRadixTree::removeChild(NodePtr &aRef, uint8_t aByte) {
+  auto &theInner = static_cast<Inner &>(*aRef);
+  switch (aRef->kind) {
+    case Kind::node4:
+    case Kind::node16: {
+      auto removeSorted = [&](auto &aNode) {
+        size_t theSlot = slotOf(aNode, aByte);
+        for (size_t i = theSlot; i + 1 < aNode.children; i++) {
+          aNode.bytes[i] = aNode.bytes[i + 1];
+          aNode.slots[i] = std::move(aNode.slots[i + 1]);
+        }
+        aNode.slots[--aNode.children].reset();
+      };
+      if (Kind::node4 == aRef->kind) {
+        removeSorted(static_cast<Node4 &>(*aRef));
+        return;
+      }
+      auto &theNode = static_cast<Node16 &>(*aRef);
+      removeSorted(theNode);
+      if (theNode.children <= 3) {  // shrink 16 -> 4
+        auto theSmaller = moveHeader<Node4>(theInner);
+        for (size_t i = 0; i < theNode.children; i++) {
+          theSmaller->bytes[i] = theNode.bytes[i];
+          theSmaller->slots[i] = std::move(theNode.slots[i]);
+        }
+        theSmaller->children = theNode.children;
+        aRef = std::move(theSmaller);
+      }
+      return;
+    }
+    case Kind::node48: {
+      auto &theNode = static_cast<Node48 &>(*aRef);
+      theNode.slots[theNode.index[aByte] - 1].reset();
+      theNode.index[aByte] = 0;
+      theNode.children--;
+      if (theNode.children <= 12) {  // shrink 48 -> 16
+        auto theSmaller = moveHeader<Node16>(theInner);
+        size_t theSlot{0};
+        for (unsigned b = 0; b < 256; b++) {
+          if (theNode.index[b]) {
+            theSmaller->bytes[theSlot] = static_cast<uint8_t>(b);
+            theSmaller->slots[theSlot++] =
+                std::move(theNode.slots[theNode.index[b] - 1]);
+          }
+        }
+        theSmaller->children = static_cast<uint16_t>(theSlot);
+        aRef = std::move(theSmaller);
+      }
+      return;
+    }
+    case Kind::node256: {
+      auto &theNode = static_cast<Node256 &>(*aRef);
+      theNode.slots[aByte].reset();
+      theNode.children--;
+      if (theNode.children <= 40) {  // shrink 256 -> 48
+        auto theSmaller = moveHeader<Node48>(theInner);
+        size_t theSlot{0};
+        for (unsigned b = 0; b < 256; b++) {
+          if (theNode.slots[b]) {
+            theSmaller->index[b] = static_cast<uint8_t>(theSlot + 1);
+            theSmaller->slots[theSlot++] = std::move(theNode.slots[b]);
+          }
+        }
+        theSmaller->children = static_cast<uint16_t>(theSlot);
+        aRef = std::move(theSmaller);
+      }
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+bool AdaptiveRadixTree::eachChild(
+    const Inner &aNode, unsigned aFirst,
+    const std::function<bool(uint8_t, const Node *)> &aCall) {
+  switch (aNode.kind) {
+    case Kind::node4:
+    case Kind::node16: {
+      auto eachSorted = [&](const auto &aSorted) {
+        for (size_t i = 0; i < aSorted.children; i++) {
+          if (aSorted.bytes[i] >= aFirst &&
+              !aCall(aSorted.bytes[i], aSorted.slots[i].get())) {
+            return false;
+          }
+        }
+        return true;
+      };
+      return Kind::node4 == aNode.kind
+                 ? eachSorted(static_cast<const Node4 &>(aNode))
+                 : eachSorted(static_cast<const Node16 &>(aNode));
+    }
+    case Kind::node48: {
+      const auto &theNode = static_cast<const Node48 &>(aNode);
+      for (unsigned b = aFirst; b < 256; b++) {
+        if (theNode.index[b] &&
+            !aCall(static_cast<uint8_t>(b),
+                   theNode.slots[theNode.index[b] - 1].get())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case Kind::node256: {
+      const auto &theNode = static_cast<const Node256 &>(aNode);
+      for (unsigned b = aFirst; b < 256; b++) {
+        if (theNode.slots[b] &&
+            !aCall(static_cast<uint8_t>(b), theNode.slots[b].get())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+// --------------------------------------------------------------------------
+// insert / find / erase
+
+// length of the common run of aKey (from aDepth) and aPrefix
+static size_t matchPrefix(const std::string &aPrefix, const std::string &aKey,
+                          size_t aDepth) {
+  size_t theMax = std::min(aPrefix.size(), aKey.size() - aDepth);
+  size_t theLength{0};
+  while (theLength < theMax && aPrefix[theLength] == aKey[aDepth + theLength]) {
+    theLength++;
+  }
+  return theLength;
+}
+
+bool AdaptiveRadixTree::insert(NodePtr &aRef, const std::string &aKey,
+                               size_t aDepth, uint32_t aValue) {
+  if (!aRef) {
+    aRef = std::make_unique<Leaf>(aKey, aValue);
+    return true;
+  }
+  auto hang = [&](NodePtr &aNode, size_t aAt, std::unique_ptr<Leaf> aLeaf) {
+    auto &theInner = static_cast<Inner &>(*aNode);
+    if (aLeaf->key.size() == aAt) {
+      theInner.terminal = std::move(aLeaf);
+    } else {
+      auto theByte = static_cast<uint8_t>(aLeaf->key[aAt]);
+      addChild(aNode, theByte, std::move(aLeaf));
+    }
+  };
+
+  if (Kind::leaf == aRef->kind) {
+    auto &theLeaf = static_cast<Leaf &>(*aRef);
+    if (theLeaf.key == aKey) {
+      return false;
+    }
+    // split: a node for the bytes both keys share
+    size_t theShared = matchPrefix(theLeaf.key.substr(aDepth), aKey, aDepth);
+    NodePtr theNode = std::make_unique<Node4>();
+    static_cast<Inner &>(*theNode).prefix = aKey.substr(aDepth, theShared);
+    std::unique_ptr<Leaf> theOld{static_cast<Leaf *>(aRef.release())};
+    hang(theNode, aDepth + theShared, std::move(theOld));
+    hang(theNode, aDepth + theShared, std::make_unique<Leaf>(aKey, aValue));
+    aRef = std::move(theNode);
+    return true;
+  }
+
+  auto &theInner = static_cast<Inner &>(*aRef);
+  size_t theMatch = matchPrefix(theInner.prefix, aKey, aDepth);
+  if (theMatch < theInner.prefix.size()) {
+    // the key leaves the stored prefix: split it
+    NodePtr theNode = std::make_unique<Node4>();
+    static_cast<Inner &>(*theNode).prefix = theInner.prefix.substr(0, theMatch);
+    auto theByte = static_cast<uint8_t>(theInner.prefix[theMatch]);
+    theInner.prefix.erase(0, theMatch + 1);
+    addChild(theNode, theByte, std::move(aRef));
+    hang(theNode, aDepth + theMatch, std::make_unique<Leaf>(aKey, aValue));
+    aRef = std::move(theNode);
+    return true;
+  }
+  size_t theDepth = aDepth + theInner.prefix.size();
+  if (aKey.size() == theDepth) {
+    if (theInner.terminal) {
+      return false;
+    }
+    theInner.terminal = std::make_unique<Leaf>(aKey, aValue);
+    return true;
+  }
+  auto theByte = static_cast<uint8_t>(aKey[theDepth]);
+  if (NodePtr *theChild = findChild(theInner, theByte)) {
+    return insert(*theChild, aKey, theDepth + 1, aValue);
+  }
+  addChild(aRef, theByte, std::make_unique<Leaf>(aKey, aValue));
+  return true;
+}
+
+bool AdaptiveRadixTree::insert(const std::string &aKey, uint32_t aValue) {
+  bool theAdded = insert(root, aKey, 0, aValue);
+  count += theAdded ? 1 : 0;
+  return theAdded;
+}
+
+std::optional<uint32_t> AdaptiveRadixTree::find(const std::string &aKey) const {
+  const Node *theNode = root.get();
+  size_t theDepth{0};
+  while (nullptr != theNode) {
+    if (Kind::leaf == theNode->kind) {
+      const auto *theLeaf = static_cast<const Leaf *>(theNode);
+      return theLeaf->key == aKey ? std::optional<uint32_t>{theLeaf->value}
+                                  : std::nullopt;
+    }
+    auto &theInner = const_cast<Inner &>(static_cast<const Inner &>(*theNode));
+    if (matchPrefix(theInner.prefix, aKey, theDepth) != theInner.prefix.size()) {
+      return std::nullopt;
+    }
+    theDepth += theInner.prefix.size();
+    if (aKey.size() == theDepth) {
+      return theInner.terminal ? std::optional<uint32_t>{theInner.terminal->value}
+                               : std::nullopt;
+    }
+    NodePtr *theChild =
+        findChild(theInner, static_cast<uint8_t>(aKey[theDepth++]));
+    theNode = theChild ? theChild->get() : nullptr;
+  }
+  return std::nullopt;
+}
+
+bool AdaptiveRadixTree::erase(NodePtr &aRef, const std::string &aKey,
+                              size_t aDepth) {
+  if (!aRef) {
+    return false;
+  }
+  if (Kind::leaf == aRef->kind) {
+    if (static_cast<Leaf &>(*aRef).key != aKey) {
+      return false;
+    }
+    aRef.reset();
+    return true;
+  }
+  auto *theInner = static_cast<Inner *>(aRef.get());
+  if (matchPrefix(theInner->prefix, aKey, aDepth) != theInner->prefix.size()) {
+    return false;
+  }
+  size_t theDepth = aDepth + theInner->prefix.size();
+  if (aKey.size() == theDepth) {
+    if (!theInner->terminal) {
+      return false;
+    }
+    theInner->terminal.reset();
+  } else {
+    auto theByte = static_cast<uint8_t>(aKey[theDepth]);
+    NodePtr *theChild = findChild(*theInner, theByte);
+    if (nullptr == theChild || !erase(*theChild, aKey, theDepth + 1)) {
+      return false;
+    }
+    if (!*theChild) {
+      removeChild(aRef, theByte);
+      theInner = static_cast<Inner *>(aRef.get());
+    }
+  }
+
+  // collapse a node left with a single key or child
+  if (0 == theInner->children) {
+    aRef = theInner->terminal ? NodePtr{std::move(theInner->terminal)} : nullptr;
+  } else if (1 == theInner->children && !theInner->terminal) {
+    uint8_t theByte{0};
+    eachChild(*theInner, 0, [&](uint8_t aByte, const Node *) {
+      theByte = aByte;
+      return false;
+    });
+    NodePtr theOnly = std::move(*findChild(*theInner, theByte));
+    if (Kind::leaf != theOnly->kind) {
+      auto &theChild = static_cast<Inner &>(*theOnly);
+      theChild.prefix = theInner->prefix + static_cast<char>(theByte) +
+                        theChild.prefix;
+    }
+    aRef = std::move(theOnly);
+  }
+  return true;
+}
+
+bool AdaptiveRadixTree::erase(const std::string &aKey) {
+  bool theErased = erase(root, aKey, 0);
+  count -= theErased ? 1 : 0;
+  return theErased;
+}
+
+void AdaptiveRadixTree::clear() {
+  root.reset();
+  count = 0;
+}
+
+size_t AdaptiveRadixTree::size() const { return count; }
+bool AdaptiveRadixTree::isEmpty() const { return 0 == count; }
+
+// --------------------------------------------------------------------------
+// ordered visits
+
+// aLow: the lower bound while the walk is still on its path, else nullptr
+bool AdaptiveRadixTree::visit(const Node *aNode, size_t aDepth,
+                              const std::string *aLow,
+                              const Visitor &aVisitor) {
+  if (Kind::leaf == aNode->kind) {
+    const auto &theLeaf = static_cast<const Leaf &>(*aNode);
+    return (aLow && theLeaf.key < *aLow) || aVisitor(theLeaf.key, theLeaf.value);
+  }
+  const auto &theInner = static_cast<const Inner &>(*aNode);
+  if (aLow) {
+    int theOrder = aLow->compare(std::min(aDepth, aLow->size()),
+                                 theInner.prefix.size(), theInner.prefix);
+    if (theOrder > 0) {
+      return true;  // every key below is smaller
+    }
+    if (theOrder < 0) {
+      aLow = nullptr;  // every key below is larger
+    }
+  }
+  size_t theDepth = aDepth + theInner.prefix.size();
+  if (aLow && aLow->size() == theDepth) {
+    aLow = nullptr;  // the terminal equals it, children are larger
+  }
+  if (theInner.terminal && !aLow &&
+      !aVisitor(theInner.terminal->key, theInner.terminal->value)) {
+    return false;
+  }
+  unsigned theFirst = aLow ? static_cast<uint8_t>((*aLow)[theDepth]) : 0;
+  return eachChild(theInner, theFirst, [&](uint8_t aByte, const Node *aChild) {
+    bool onPath = aLow && aByte == theFirst;
+    return visit(aChild, theDepth + 1, onPath ? aLow : nullptr, aVisitor);
+  });
+}
+
+bool AdaptiveRadixTree::each(const Visitor &aVisitor) const {
+  return !root || visit(root.get(), 0, nullptr, aVisitor);
+}
+
+bool AdaptiveRadixTree::eachFrom(const std::string &aLow,
+                                 const Visitor &aVisitor) const {
+  return !root || visit(root.get(), 0, &aLow, aVisitor);
+}
+
+}  // namespace ECE141
@@ -0,0 +1,86 @@
+/**
+ * @file AdaptiveRadixTree.hpp
+ * @author Yifan Wu
+ * @brief ordered byte-string -> uint32_t map (adaptive radix tree)
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef AdaptiveRadixTree_hpp
+#define AdaptiveRadixTree_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace ECE141 {
+
+// USE: a trie over the key bytes where each inner node picks the smallest of
+//      four layouts for its fan-out (4, 16, 48 or 256 children) and chains of
+//      single children collapse into a stored prefix. A lookup reads one byte
+//      per level instead of comparing whole keys, and keys come out in byte
+//      (memcmp) order, so binary-comparable keys (KeyEncoder, big-endian
+//      ints) iterate in value order. A key may be a prefix of another one.
+class AdaptiveRadixTree {
+ public:
+  using Visitor = std::function<bool(const std::string &, uint32_t)>;
+
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+  AdaptiveRadixTree(AdaptiveRadixTree &&) noexcept;
+  AdaptiveRadixTree &operator=(AdaptiveRadixTree &&) noexcept;
+  AdaptiveRadixTree(const AdaptiveRadixTree &) = delete;
+  AdaptiveRadixTree &operator=(const AdaptiveRadixTree &) = delete;
+
+  // false if aKey was already present (existing value is kept)
+  bool insert(const std::string &aKey, uint32_t aValue);
+  [[nodiscard]] std::optional<uint32_t> find(const std::string &aKey) const;
+  bool erase(const std::string &aKey);
+  void clear();
+
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool isEmpty() const;
+
+  // visit keys in ascending order; stops when aVisitor returns false
+  bool each(const Visitor &aVisitor) const;
+  // same, starting at the first key >= aLow
+  bool eachFrom(const std::string &aLow, const Visitor &aVisitor) const;
+
+ protected:
+  enum class Kind : uint8_t { leaf, node4, node16, node48, node256 };
+  struct Node;
+  struct Leaf;
+  struct Inner;
+  struct Node4;
+  struct Node16;
+  struct Node48;
+  struct Node256;
+  using NodePtr = std::unique_ptr<Node>;
+
+  static bool insert(NodePtr &aRef, const std::string &aKey, size_t aDepth,
+                     uint32_t aValue);
+  static bool erase(NodePtr &aRef, const std::string &aKey, size_t aDepth);
+  static bool visit(const Node *aNode, size_t aDepth, const std::string *aLow,
+                    const Visitor &aVisitor);
+
+  static NodePtr *findChild(Inner &aNode, uint8_t aByte);
+  static void addChild(NodePtr &aRef, uint8_t aByte, NodePtr aChild);
+  static void removeChild(NodePtr &aRef, uint8_t aByte);
+  // visit (byte, child) in byte order from aFirst
+  static bool eachChild(const Inner &aNode, unsigned aFirst,
+                        const std::function<bool(uint8_t, const Node *)> &aCall);
+
+  NodePtr root;
+  size_t count{0};
+};
+
+}  // namespace ECE141
+
+#endif /* AdaptiveRadixTree_hpp */
@@ -11,14 +11,20 @@
 
 #include "Application.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <set>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "Config.hpp"
 #include "Errors.hpp"
@@ -26,13 +32,25 @@
 #include "ScriptRunner.hpp"
 #include "Statement.hpp"
 #include "TableFormatter.hpp"
+#include "TaskScheduler.hpp"
 #include "Timer.hpp"
 #include "Tokenizer.hpp"
 
 namespace fs = std::filesystem;
 namespace ECE141 {
 
-std::array<size_t, 3> Config::cacheSize = {0, 0, 0};
+std::array<size_t, 4> Config::cacheSize = {0, 0, 0, 0};
+size_t Config::bloomBitsPerKey = 10;  // ~1% false positives
+size_t Config::sortRunLimit = 1 << 16;
+size_t Config::sortChunkRows = 1 << 14;
+size_t Config::sortMemoryBytes = 256 << 20;
+size_t Config::zoneBlocks = 16;
+size_t Config::batchSize = 1024;
+size_t Config::hashJoinLimit = 1 << 20;
+size_t Config::workerThreads =
+    std::max(std::thread::hardware_concurrency(), 1u);
+size_t Config::scanWorkers = Config::workerThreads;
+size_t Config::morselBlocks = 256;
 
 Application::Application(std::ostream &anOutput)
     : CmdProcessor(anOutput, "App"),
@@ -163,6 +181,46 @@ StatusResult Application::showDatabases() const {
   return StatusResult{Errors::noError};
 }
 
+// USE: the task scheduler's threads, the tasks they ran and how busy they were
+StatusResult Application::showWorkers() const {
+  TaskScheduler::Stats theStats = TaskScheduler::get().getStats();
+  std::vector<std::streamsize> theWidths = {10, 10, 10, 14, 14};
+
+  output.setf(std::ios::left, std::ios::adjustfield);
+  TableFormatter::printBreak(output, theWidths);
+  const char *theTitles[] = {"| threads", "| tasks", "| steals", "| busy",
+                             "| utilization"};
+  for (size_t i{0}; i < theWidths.size(); i++) {
+    output.fill(' ');
+    output.width(theWidths[i]);
+    output << theTitles[i];
+  }
+  output << "|\n";
+  TableFormatter::printBreak(output, theWidths);
+
+  std::ostringstream theBusy;
+  std::ostringstream theUtilization;
+  theBusy << std::fixed << std::setprecision(6) << theStats.busySeconds
+          << " s";
+  theUtilization << std::fixed << std::setprecision(2)
+                 << theStats.utilization * 100 << " %";
+  std::string theCells[] = {std::to_string(theStats.threads),
+                            std::to_string(theStats.tasks),
+                            std::to_string(theStats.steals), theBusy.str(),
+                            theUtilization.str()};
+  for (size_t i{0}; i < theWidths.size(); i++) {
+    output.fill(' ');
+    output.width(theWidths[i]);
+    output << "| " + theCells[i];
+  }
+  output << "|\n";
+
+  TableFormatter::printBreak(output, theWidths);
+  TableFormatter::printRowsInSet(output, 1);
+  TableFormatter::printDuration(output, Config::getTimer().elapsed());
+  return StatusResult{Errors::noError};
+}
+
 // USE: call this to perform the dropping of a database (remove the file)...
 auto Application::dropDatabase(const std::string &aName) -> StatusResult {
   StatusResult theResult{Errors::databaseDoNotExists};
@@ -181,21 +239,35 @@ auto Application::dropDatabase(const std::string &aName) -> StatusResult {
   return theResult;
 }
 
+// USE: open an existing database; nullptr (and a read error) if its meta
+//      or lookup block can't be decoded, e.g. an unknown on-disk format
+static std::unique_ptr<Database> openDatabase(const std::string &aName,
+                                              StatusResult &aResult) {
+  try {
+    return std::make_unique<Database>(aName, OpenDB{});
+  } catch (const std::runtime_error &anError) {
+    std::cerr << aName << ": " << anError.what() << '\n';
+    aResult.error = Errors::readError;
+  }
+  return nullptr;
+}
+
 // USE: DB dump all storage blocks
 auto Application::dumpDatabase(const std::string &aName) -> StatusResult {
   StatusResult theResult{Errors::databaseDoNotExists};
   if (dbExists(aName)) {
-    if (hasActiveDB()) {
-      std::string theActiveDBName = activeDB->getName();
-      activeDB = std::make_unique<Database>(aName, OpenDB{});
-      theResult = activeDB->dump(output);
-      activeDB = std::make_unique<Database>(theActiveDBName, OpenDB{});
-    } else {
-      Database theDatabase = Database(aName, OpenDB{});
-      theDatabase.setDebugInfo("Dump Database");
-      theResult = theDatabase.dump(output);
+    // close the active database first, so its changes are on disk
+    std::string theActiveDBName = hasActiveDB() ? activeDB->getName() : "";
+    activeDB.reset();
+    if (auto theDatabase = openDatabase(aName, theResult)) {
+      theDatabase->setDebugInfo("Dump Database");
+      theResult = theDatabase->dump(output);
+      TableFormatter::printDuration(output, Config::getTimer().elapsed());
+    }
+    if (!theActiveDBName.empty()) {
+      StatusResult theReopen;
+      activeDB = openDatabase(theActiveDBName, theReopen);
     }
-    TableFormatter::printDuration(output, Config::getTimer().elapsed());
   }
   return theResult;
 }
@@ -209,16 +281,18 @@ auto Application::useDatabase(const std::string &aName) -> StatusResult {
       // use same database -> no change
       if (activeDB->getName() == aName) {
         TableFormatter::printDBChange(output, false);
-      } else {
-        // invoke ~Database() to save data
-        // that switching between different databases;
-        activeDB = std::make_unique<Database>(aName, OpenDB{});
-        TableFormatter::printDBChange(output, true);
+        activeDB->setDebugInfo("use Database");
+        return {Errors::noError};
       }
-    } else {
-      activeDB = std::make_unique<Database>(aName, OpenDB{});
-      TableFormatter::printDBChange(output, true);
     }
+    auto theDatabase = openDatabase(aName, theResult);
+    if (!theDatabase) {
+      return theResult;  // the active database stays in use
+    }
+    // invoke ~Database() to save data
+    // that switching between different databases;
+    activeDB = std::move(theDatabase);
+    TableFormatter::printDBChange(output, true);
     activeDB->setDebugInfo("use Database");
     theResult.error = Errors::noError;
   }
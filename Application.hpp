@@ -62,6 +62,7 @@ class Application : public CmdProcessor {
   [[nodiscard]] StatusResult dumpDatabase(const std::string &aName);
   [[nodiscard]] StatusResult useDatabase(const std::string &aName);
   [[nodiscard]] StatusResult showDatabases() const;
+  [[nodiscard]] StatusResult showWorkers() const;
 
   [[nodiscard]] StatusResult showIndexes();
   
@@ -19,7 +19,12 @@
 namespace ECE141 {
 
 Attribute::Attribute(DataTypes aType)
-    : type{aType}, size{0}, autoIncrement{0}, primary{0}, nullable{1} {}
+    : type{aType},
+      size{0},
+      autoIncrement{0},
+      primary{0},
+      nullable{1},
+      unique{0} {}
 
 Attribute::Attribute(std::string aName, DataTypes aType, uint16_t aSize = 0)
     : name{std::move(aName)},
@@ -27,7 +32,8 @@ Attribute::Attribute(std::string aName, DataTypes aType, uint16_t aSize = 0)
       size{aSize},
       autoIncrement{0},
       primary{0},
-      nullable{1} {}
+      nullable{1},
+      unique{0} {}
 
 Attribute& Attribute::setName(const std::string& aName) {
   name = aName;
@@ -59,6 +65,11 @@ Attribute& Attribute::setNullable(bool aNullable) {
   return *this;
 }
 
+Attribute& Attribute::setUnique(bool aUnique) {
+  unique = aUnique;
+  return *this;
+}
+
 Attribute& Attribute::setDefaultVal(Value aValue) {
   defaultVal = std::move(aValue);
   return *this;
@@ -77,6 +88,7 @@ Value Attribute::getValue() const { return defaultVal; }
 std::string Attribute::getValueStr() const { return defaultValStr; }
 bool Attribute::isPrimaryKey() const { return primary; }
 bool Attribute::isNullable() const { return nullable; }
+bool Attribute::isUnique() const { return unique; }
 bool Attribute::isAutoIncrement() const { return autoIncrement; }
 
 bool Attribute::goodAccess(Value& aVal) const {
@@ -116,8 +128,8 @@ auto Attribute::isInsertValid(KeyValues& aRowData) -> StatusResult {
   return {Errors::noError};
 }
 
-auto Attribute::toValue(const std::string& aValue) -> Value {
-  setDefaultValStr(aValue);
+// no side effects: converting an inserted value must not touch the default
+auto Attribute::toValue(const std::string& aValue) const -> Value {
 
   //  the last return can handle this case
   // if (DataTypes::datetime_type == type) {
@@ -141,7 +153,11 @@ auto Attribute::toValue(const std::string& aValue) -> Value {
 }
 
 // Storable interface
+// version 2 appended the unique flag
+static constexpr uint32_t kAttributeVersion{2};
+
 auto Attribute::encode(std::ostream& anOutput) const -> StatusResult {
+  Helpers::encodeVersion(anOutput, kAttributeVersion);
   Helpers::encodeInto(anOutput, name);
   Helpers::encodeInto(anOutput, static_cast<char>(type));
   Helpers::encodeInto(anOutput, size);
@@ -149,6 +165,7 @@ auto Attribute::encode(std::ostream& anOutput) const -> StatusResult {
   Helpers::encodeInto(anOutput, primary);
   Helpers::encodeInto(anOutput, nullable);
   Helpers::encodeInto(anOutput, defaultValStr);
+  Helpers::encodeInto(anOutput, unique);
   return {Errors::noError};
 }
 
@@ -158,6 +175,8 @@ auto Attribute::decode(std::istream& anInput) -> StatusResult {
   bool theAutoIncr;
   bool thePrim;
   bool theNull;
+  bool theUnique{false};  // not in version 1
+  uint32_t theVersion = Helpers::decodeVersion(anInput);
   Helpers::decodeFrom(anInput, name);
   Helpers::decodeFrom(anInput, theCharType);
   Helpers::decodeFrom(anInput, theSize);
@@ -165,12 +184,16 @@ auto Attribute::decode(std::istream& anInput) -> StatusResult {
   Helpers::decodeFrom(anInput, thePrim);
   Helpers::decodeFrom(anInput, theNull);
   Helpers::decodeFrom(anInput, defaultValStr);
+  if (theVersion >= 2) {
+    Helpers::decodeFrom(anInput, theUnique);
+  }
 
   setDataType(static_cast<DataTypes>(theCharType));
   setSize(theSize);
   setAutoIncrement(theAutoIncr);
   setPrimaryKey(thePrim);
   setNullable(theNull);
+  setUnique(theUnique);
   setDefaultVal(toValue(defaultValStr));
   return {Errors::noError};
 }
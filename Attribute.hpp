@@ -41,6 +41,7 @@ Attribute:
   - auto_increment (determines if this (integer) field is auto incremented by DB
   - primary_key  (bool indicates that field represents primary key)
   - nullable (bool indicates the field can be null)
+  - unique (bool indicates values must be distinct; backed by an index)
 **/
 
 class Attribute : Storable {
@@ -55,6 +56,7 @@ class Attribute : Storable {
   Attribute& setAutoIncrement(bool anAuto);
   Attribute& setPrimaryKey(bool anAuto);
   Attribute& setNullable(bool aNullable);
+  Attribute& setUnique(bool aUnique);
 
   Attribute& setDefaultVal(Value aValue);
   Attribute& setDefaultValStr(const std::string& aString);
@@ -73,8 +75,9 @@ class Attribute : Storable {
 
   [[nodiscard]] bool isPrimaryKey() const;
   [[nodiscard]] bool isNullable() const;
+  [[nodiscard]] bool isUnique() const;
   [[nodiscard]] bool isAutoIncrement() const;
-  Value toValue(const std::string& aValue);
+  Value toValue(const std::string& aValue) const;
 
   // Storable interface
   StatusResult encode(std::ostream& anOutput) const override;
@@ -87,6 +90,7 @@ class Attribute : Storable {
   uint16_t autoIncrement : 1;
   uint16_t primary : 1;
   uint16_t nullable : 1;
+  uint16_t unique : 1;
 
   // "NULL" indicates variant is empty/has no value
   Value defaultVal;
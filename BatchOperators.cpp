@@ -0,0 +1,368 @@
+/**
+ * @file BatchOperators.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "BatchOperators.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "Attribute.hpp"
+#include "Compare.hpp"
+#include "Helpers.hpp"
+#include "Timer.hpp"
+
+namespace ECE141 {
+
+// ---------------------------------------------------------------------------
+ColumnVector::ColumnVector(DataTypes aType) {
+  switch (aType) {
+    case DataTypes::int_type:
+      values = std::vector<int>{};
+      break;
+    case DataTypes::float_type:
+      values = std::vector<double>{};
+      break;
+    case DataTypes::varchar_type:
+      values = std::vector<std::string>{};
+      break;
+    default:
+      values = std::vector<Value>{};
+      break;
+  }
+}
+
+void ColumnVector::append(const Value *aValue) {
+  present.push_back(nullptr != aValue);
+  std::visit(
+      [&](auto &aValues) {
+        using T = typename std::decay_t<decltype(aValues)>::value_type;
+        if (nullptr == aValue) {
+          aValues.emplace_back();
+        } else if constexpr (std::is_same_v<T, Value>) {
+          aValues.push_back(*aValue);
+        } else if (const T *theValue = std::get_if<T>(aValue)) {
+          aValues.push_back(*theValue);
+        } else {
+          present.pop_back();
+          toGeneric();
+          append(aValue);
+        }
+      },
+      values);
+}
+
+void ColumnVector::toGeneric() {
+  std::vector<Value> theValues;
+  std::visit(
+      [&](auto &aValues) {
+        theValues.assign(std::make_move_iterator(aValues.begin()),
+                         std::make_move_iterator(aValues.end()));
+      },
+      values);
+  values = std::move(theValues);
+}
+
+void ColumnVector::clear() {
+  std::visit([](auto &aValues) { aValues.clear(); }, values);
+  present.clear();
+}
+
+bool ColumnVector::isPresent(size_t aRow) const { return 0 != present[aRow]; }
+
+Value ColumnVector::valueAt(size_t aRow) const {
+  return std::visit([&](const auto &aValues) { return Value{aValues[aRow]}; },
+                    values);
+}
+
+const ColumnVector::Values &ColumnVector::getValues() const { return values; }
+
+const std::vector<uint8_t> &ColumnVector::getPresent() const {
+  return present;
+}
+
+// ---------------------------------------------------------------------------
+void RowBatch::clear() {
+  for (auto &[theName, theColumn] : columns) {
+    theColumn.clear();
+  }
+  blockNums.clear();
+  selection.clear();
+}
+
+size_t RowBatch::getSize() const { return blockNums.size(); }
+
+// ---------------------------------------------------------------------------
+BatchScanOperator::BatchScanOperator(OperatorPtr aChild,
+                                     const Entity &anEntity,
+                                     size_t aBatchSize)
+    : child{std::move(aChild)}, batchSize{std::max<size_t>(aBatchSize, 1)} {
+  for (const auto &theAttr : anEntity.getAttributes()) {
+    attributes.emplace_back(theAttr.getName(), theAttr.getType());
+  }
+}
+
+StatusResult BatchScanOperator::open() { return child->open(); }
+
+StatusResult BatchScanOperator::nextBatch(RowBatch &aBatch) {
+  aBatch.clear();
+  for (const auto &[theName, theType] : attributes) {
+    aBatch.columns.try_emplace(theName, theType);
+  }
+  StatusResult theResult{Errors::noError};
+  std::unique_ptr<Row> theRow;
+  while (aBatch.getSize() < batchSize &&
+         (theResult = child->next(theRow)) && theRow) {
+    const KeyValues &theData = theRow->getData();
+    for (auto &[theName, theColumn] : aBatch.columns) {
+      auto theIter = theData.find(theName);
+      theColumn.append(theIter != theData.end() ? &theIter->second : nullptr);
+    }
+    aBatch.selection.push_back(static_cast<uint32_t>(aBatch.getSize()));
+    aBatch.blockNums.push_back(theRow->getBlockNum());
+    aBatch.entityId = theRow->getEntityId();
+  }
+  return theResult;
+}
+
+void BatchScanOperator::close() { child->close(); }
+
+// ---------------------------------------------------------------------------
+// the comparisons of the row path (see Filters.cpp), on concrete types
+template <typename L, typename R>
+static bool compare(Operators anOp, const L &aLHS, const R &aRHS) {
+  switch (anOp) {
+    case Operators::equal_op:
+      return isEqual(aLHS, aRHS);
+    case Operators::notequal_op:
+      return !isEqual(aLHS, aRHS);
+    case Operators::lt_op:
+      return isLess(aLHS, aRHS);
+    case Operators::lte_op:
+      return isLess(aLHS, aRHS) || isEqual(aLHS, aRHS);
+    case Operators::gt_op:
+      return !(isLess(aLHS, aRHS) || isEqual(aLHS, aRHS));
+    case Operators::gte_op:
+      return !isLess(aLHS, aRHS);
+    default:
+      return false;
+  }
+}
+
+static bool compareValues(Operators anOp, const Value &aLHS,
+                          const Value &aRHS) {
+  return std::visit(
+      [&](const auto &aLeft) {
+        return std::visit(
+            [&](const auto &aRight) { return compare(anOp, aLeft, aRight); },
+            aRHS);
+      },
+      aLHS);
+}
+
+static bool isComparison(Operators anOp) {
+  switch (anOp) {
+    case Operators::equal_op:
+    case Operators::notequal_op:
+    case Operators::lt_op:
+    case Operators::lte_op:
+    case Operators::gt_op:
+    case Operators::gte_op:
+      return true;
+    default:
+      return false;
+  }
+}
+
+BatchFilterOperator::BatchFilterOperator(BatchPtr aChild,
+                                         const Filters &aFilters,
+                                         FilterOperator::Observer anObserver)
+    : child{std::move(aChild)}, observer{std::move(anObserver)} {
+  for (const auto &theExpr : aFilters.getExpressions()) {
+    const auto &theLogics = theExpr->logics;
+    Operators theOp{theExpr->op};
+    if ((std::count(theLogics.begin(), theLogics.end(), Logical::not_op) %
+         2) != 0) {
+      theOp = Helpers::oppositeOpOf(theOp);
+    }
+    bool isLeft = TokenType::identifier == theExpr->lhs.ttype;
+    const Operand &theField = isLeft ? theExpr->lhs : theExpr->rhs;
+    const Operand &theConstant = isLeft ? theExpr->rhs : theExpr->lhs;
+    // a row without the field compares the operands' own values
+    terms.push_back({theField.name, theOp, theConstant.value, isLeft,
+                     compareValues(theOp, theExpr->lhs.value,
+                                   theExpr->rhs.value)});
+  }
+}
+
+bool BatchFilterOperator::canRun(const Filters &aFilters) {
+  const Expressions &theExprs = aFilters.getExpressions();
+  // every term after the first is ANDed on (what Filters::matches folds)
+  auto theAnds = std::count_if(
+      theExprs.begin(), theExprs.end(), [](const auto &anExpr) {
+        return 1 == std::count(anExpr->logics.begin(), anExpr->logics.end(),
+                               Logical::and_op);
+      });
+  return !theExprs.empty() &&
+         static_cast<size_t>(theAnds) + 1 == theExprs.size() &&
+         std::all_of(theExprs.begin(), theExprs.end(), [](const auto &anExpr) {
+           const auto &theLogics = anExpr->logics;
+           bool isLHSField = TokenType::identifier == anExpr->lhs.ttype;
+           bool isRHSField = TokenType::identifier == anExpr->rhs.ttype;
+           return isComparison(anExpr->op) && isLHSField != isRHSField &&
+                  std::find(theLogics.begin(), theLogics.end(),
+                            Logical::or_op) == theLogics.end();
+         });
+}
+
+// keep the selected rows aTest holds for (NULLs: aNullResult); the write
+// index never passes the read index, so it filters in place
+template <typename Test>
+static void keepIf(std::vector<uint32_t> &aSelection,
+                   const std::vector<uint8_t> &aPresent, bool aNullResult,
+                   Test aTest) {
+  size_t theCount{0};
+  for (uint32_t theRow : aSelection) {
+    bool isHit = aPresent[theRow] ? aTest(theRow) : aNullResult;
+    aSelection[theCount] = theRow;
+    theCount += isHit;
+  }
+  aSelection.resize(theCount);
+}
+
+void BatchFilterOperator::refine(const ColumnVector &aColumn,
+                                 const Term &aTerm,
+                                 std::vector<uint32_t> &aSelection) {
+  const std::vector<uint8_t> &thePresent = aColumn.getPresent();
+  std::visit(
+      [&](const auto &aValues) {
+        using T = typename std::decay_t<decltype(aValues)>::value_type;
+        if constexpr (std::is_same_v<T, Value>) {
+          // mixed column: compare through the variants, row by row
+          keepIf(aSelection, thePresent, aTerm.nullResult, [&](uint32_t aRow) {
+            return aTerm.fieldOnLeft
+                       ? compareValues(aTerm.op, aValues[aRow], aTerm.constant)
+                       : compareValues(aTerm.op, aTerm.constant, aValues[aRow]);
+          });
+        } else {
+          std::visit(
+              [&](const auto &aConstant) {
+                if (aTerm.fieldOnLeft) {
+                  keepIf(aSelection, thePresent, aTerm.nullResult,
+                         [&](uint32_t aRow) {
+                           return compare(aTerm.op, aValues[aRow], aConstant);
+                         });
+                } else {
+                  keepIf(aSelection, thePresent, aTerm.nullResult,
+                         [&](uint32_t aRow) {
+                           return compare(aTerm.op, aConstant, aValues[aRow]);
+                         });
+                }
+              },
+              aTerm.constant);
+        }
+      },
+      aColumn.getValues());
+}
+
+StatusResult BatchFilterOperator::open() {
+  seen = kept = 0;
+  seconds = 0;
+  Timer theTimer;
+  StatusResult theResult = child->open();
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+StatusResult BatchFilterOperator::nextBatch(RowBatch &aBatch) {
+  Timer theTimer;
+  StatusResult theResult{Errors::noError};
+  while ((theResult = child->nextBatch(aBatch)) && aBatch.getSize() > 0) {
+    seen += aBatch.selection.size();
+    for (const auto &theTerm : terms) {
+      auto theColumn = aBatch.columns.find(theTerm.field);
+      if (theColumn != aBatch.columns.end()) {
+        refine(theColumn->second, theTerm, aBatch.selection);
+      } else if (!theTerm.nullResult) {
+        aBatch.selection.clear();
+      }
+    }
+    kept += aBatch.selection.size();
+    if (!aBatch.selection.empty()) {
+      break;
+    }
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void BatchFilterOperator::close() {
+  child->close();
+  if (observer) {
+    observer(seen, kept, seconds);
+  }
+}
+
+// ---------------------------------------------------------------------------
+BatchProjectOperator::BatchProjectOperator(BatchPtr aChild, StringList aFields)
+    : child{std::move(aChild)}, fields{std::move(aFields)} {}
+
+StatusResult BatchProjectOperator::open() { return child->open(); }
+
+StatusResult BatchProjectOperator::nextBatch(RowBatch &aBatch) {
+  StatusResult theResult = child->nextBatch(aBatch);
+  for (auto theIter = aBatch.columns.begin();
+       theIter != aBatch.columns.end();) {
+    bool isSelected = std::find(fields.begin(), fields.end(),
+                                theIter->first) != fields.end();
+    theIter = isSelected ? std::next(theIter) : aBatch.columns.erase(theIter);
+  }
+  return theResult;
+}
+
+void BatchProjectOperator::close() { child->close(); }
+
+// ---------------------------------------------------------------------------
+UnbatchOperator::UnbatchOperator(BatchPtr aChild) : child{std::move(aChild)} {}
+
+StatusResult UnbatchOperator::open() {
+  batch.clear();
+  position = 0;
+  return child->open();
+}
+
+StatusResult UnbatchOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  StatusResult theResult{Errors::noError};
+  if (position >= batch.selection.size()) {
+    position = 0;
+    if (!(theResult = child->nextBatch(batch)) || 0 == batch.getSize()) {
+      batch.clear();
+      return theResult;
+    }
+  }
+  uint32_t theRow = batch.selection[position++];
+  aRow = std::make_unique<Row>(batch.entityId, batch.blockNums[theRow]);
+  for (const auto &[theName, theColumn] : batch.columns) {
+    if (theColumn.isPresent(theRow)) {
+      aRow->insert(theName, theColumn.valueAt(theRow));
+    }
+  }
+  return theResult;
+}
+
+void UnbatchOperator::close() {
+  child->close();
+  batch.clear();
+}
+
+}  // namespace ECE141
@@ -0,0 +1,165 @@
+/**
+ * @file BatchOperators.hpp
+ * @author Yifan Wu
+ * @brief vectorized execution: operators that pass column batches
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BatchOperators_hpp
+#define BatchOperators_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "BasicTypes.hpp"
+#include "Entity.hpp"
+#include "Errors.hpp"
+#include "Filters.hpp"
+#include "QueryOperators.hpp"
+#include "Row.hpp"
+
+namespace ECE141 {
+
+// USE: the values of one column for the rows of a batch, as a typed array
+//      picked from the attribute type. A value of another type turns the
+//      column into plain Values, so every comparison stays exact.
+class ColumnVector {
+ public:
+  using Values = std::variant<std::vector<int>, std::vector<double>,
+                              std::vector<std::string>, std::vector<Value>>;
+
+  explicit ColumnVector(DataTypes aType = DataTypes::no_type);
+
+  // aValue nullptr: the row has no value (NULL)
+  void append(const Value *aValue);
+  void clear();
+
+  [[nodiscard]] bool isPresent(size_t aRow) const;
+  [[nodiscard]] Value valueAt(size_t aRow) const;
+  [[nodiscard]] const Values &getValues() const;
+  [[nodiscard]] const std::vector<uint8_t> &getPresent() const;
+
+ protected:
+  void toGeneric();
+
+  Values values;
+  std::vector<uint8_t> present;
+};
+
+// USE: up to a batch size of rows, stored column by column. selection lists
+//      the rows still in the batch (ascending); filters only shrink it.
+struct RowBatch {
+  void clear();
+  [[nodiscard]] size_t getSize() const;
+
+  std::map<std::string, ColumnVector> columns;
+  std::vector<uint32_t> blockNums;
+  std::vector<uint32_t> selection;
+  uint32_t entityId{0};
+};
+
+// USE: open / nextBatch / close like QueryOperator; a batch without rows
+//      means the input is exhausted (others have at least one selected)
+class BatchOperator {
+ public:
+  virtual ~BatchOperator() = default;
+
+  virtual StatusResult open() = 0;
+  virtual StatusResult nextBatch(RowBatch &aBatch) = 0;
+  virtual void close() = 0;
+};
+
+using BatchPtr = std::unique_ptr<BatchOperator>;
+
+// USE: packs the rows of a row operator into batches of aBatchSize
+class BatchScanOperator : public BatchOperator {
+ public:
+  BatchScanOperator(OperatorPtr aChild, const Entity &anEntity,
+                    size_t aBatchSize);
+
+  StatusResult open() override;
+  StatusResult nextBatch(RowBatch &aBatch) override;
+  void close() override;
+
+ protected:
+  OperatorPtr child;
+  std::vector<std::pair<std::string, DataTypes>> attributes;
+  size_t batchSize;
+};
+
+// USE: where clause as one tight loop per term over the column arrays,
+//      narrowing the selection. Only for canRun() clauses: a conjunction of
+//      `field op constant` comparisons. The observer is as FilterOperator's.
+class BatchFilterOperator : public BatchOperator {
+ public:
+  BatchFilterOperator(BatchPtr aChild, const Filters &aFilters,
+                      FilterOperator::Observer anObserver = nullptr);
+
+  static bool canRun(const Filters &aFilters);
+
+  StatusResult open() override;
+  StatusResult nextBatch(RowBatch &aBatch) override;
+  void close() override;
+
+ protected:
+  // one `field op constant` term, with its outcome for a NULL field
+  struct Term {
+    std::string field;
+    Operators op;
+    Value constant;
+    bool fieldOnLeft;
+    bool nullResult;
+  };
+
+  static void refine(const ColumnVector &aColumn, const Term &aTerm,
+                     std::vector<uint32_t> &aSelection);
+
+  BatchPtr child;
+  std::vector<Term> terms;
+  FilterOperator::Observer observer;
+  size_t seen{0};
+  size_t kept{0};
+  double seconds{0};
+};
+
+// USE: drops the columns not in aFields before rows are built again
+class BatchProjectOperator : public BatchOperator {
+ public:
+  BatchProjectOperator(BatchPtr aChild, StringList aFields);
+
+  StatusResult open() override;
+  StatusResult nextBatch(RowBatch &aBatch) override;
+  void close() override;
+
+ protected:
+  BatchPtr child;
+  StringList fields;
+};
+
+// USE: rows again, one per selected batch entry, for the row operators
+class UnbatchOperator : public QueryOperator {
+ public:
+  explicit UnbatchOperator(BatchPtr aChild);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  BatchPtr child;
+  RowBatch batch;
+  size_t position{0};
+};
+
+}  // namespace ECE141
+
+#endif /* BatchOperators_hpp */
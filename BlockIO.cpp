@@ -64,8 +64,9 @@ void BlockHeader::setToFree() {
   entityHash = 0;
 }
 
+// extra is a fixed-size label; longer names (e.g. Table.index) get truncated
 void BlockHeader::setExtra(const std::string &anExtra) {
-  for (size_t i = 0; i < anExtra.size(); i++) {
+  for (size_t i = 0; i < std::min(anExtra.size(), kExtraSize); i++) {
     extra.at(i) = anExtra.at(i);
   }
 }
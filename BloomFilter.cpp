@@ -0,0 +1,119 @@
+/**
+ * @file BloomFilter.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "BloomFilter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "Errors.hpp"
+#include "Helpers.hpp"
+#include "KeyEncoder.hpp"
+
+namespace ECE141 {
+
+// odd multipliers, one per word: derive 8 independent bit positions from the
+// low 32 bits of the hash (see Putze et al., "Cache-, Hash- and
+// Space-Efficient Bloom Filters")
+static constexpr uint32_t kSalts[BloomFilter::kWordsPerBlock]{
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+// finalizer of MurmurHash3: spreads every input bit over the whole word
+static uint64_t mix(uint64_t aHash) {
+  aHash ^= aHash >> 33;
+  aHash *= 0xff51afd7ed558ccdULL;
+  aHash ^= aHash >> 33;
+  aHash *= 0xc4ceb9fe1a85ec53ULL;
+  aHash ^= aHash >> 33;
+  return aHash;
+}
+
+BloomFilter::BloomFilter(size_t aKeyCount, size_t aBitsPerKey)
+    : bitsPerKey{std::max<size_t>(aBitsPerKey, 1)} {
+  reset(aKeyCount);
+}
+
+BloomFilter &BloomFilter::reset(size_t aKeyCount) {
+  size_t theBlockCount =
+      std::max<size_t>(1, (aKeyCount * bitsPerKey + kBitsPerBlock - 1) /
+                              kBitsPerBlock);
+  blocks.assign(theBlockCount, Block{});
+  capacity = theBlockCount * kBitsPerBlock / bitsPerKey;
+  return *this;
+}
+
+size_t BloomFilter::blockFor(uint64_t aHash) const {
+  // high 32 bits scaled onto [0, blocks.size()) without a modulo
+  return static_cast<size_t>(((aHash >> 32) * blocks.size()) >> 32);
+}
+
+void BloomFilter::insert(uint64_t aHash) {
+  Block &theBlock = blocks[blockFor(aHash)];
+  auto theLow = static_cast<uint32_t>(aHash);
+  for (size_t i = 0; i < kWordsPerBlock; i++) {
+    theBlock.words[i] |= uint64_t{1} << ((theLow * kSalts[i]) >> 26);
+  }
+}
+
+bool BloomFilter::mayContain(uint64_t aHash) const {
+  const Block &theBlock = blocks[blockFor(aHash)];
+  auto theLow = static_cast<uint32_t>(aHash);
+  uint64_t theMissing{0};
+  for (size_t i = 0; i < kWordsPerBlock; i++) {
+    theMissing |=
+        ~theBlock.words[i] & (uint64_t{1} << ((theLow * kSalts[i]) >> 26));
+  }
+  return 0 == theMissing;
+}
+
+size_t BloomFilter::getCapacity() const { return capacity; }
+size_t BloomFilter::getBlockCount() const { return blocks.size(); }
+
+uint64_t BloomFilter::hash(const std::string &aKey) {
+  uint64_t theHash{0xcbf29ce484222325ULL};  // FNV-1a
+  for (unsigned char theChar : aKey) {
+    theHash = (theHash ^ theChar) * 0x100000001b3ULL;
+  }
+  return mix(theHash);
+}
+
+uint64_t BloomFilter::hash(uint32_t aKey) { return mix(aKey); }
+
+// Storable interface --------------------------------
+StatusResult BloomFilter::encode(std::ostream &anOutput) const {
+  std::string theBits(blocks.size() * sizeof(Block), '\0');
+  std::memcpy(theBits.data(), blocks.data(), theBits.size());
+  Helpers::encodeInto(anOutput, bitsPerKey);
+  Helpers::encodeInto(anOutput, blocks.size());
+  Helpers::encodeInto(anOutput, KeyEncoder::toHex(theBits));
+  return {Errors::noError};
+}
+
+StatusResult BloomFilter::decode(std::istream &anInput) {
+  size_t theBlockCount{0};
+  std::string theHex;
+  Helpers::decodeFrom(anInput, bitsPerKey);
+  Helpers::decodeFrom(anInput, theBlockCount);
+  Helpers::decodeFrom(anInput, theHex);
+  std::string theBits = KeyEncoder::fromHex(theHex);
+  if (0 == bitsPerKey || 0 == theBlockCount ||
+      theBits.size() != theBlockCount * sizeof(Block)) {
+    return {Errors::readError};
+  }
+  blocks.resize(theBlockCount);
+  std::memcpy(blocks.data(), theBits.data(), theBits.size());
+  capacity = theBlockCount * kBitsPerBlock / bitsPerKey;
+  return {Errors::noError};
+}
+
+}  // namespace ECE141
@@ -0,0 +1,67 @@
+/**
+ * @file BloomFilter.hpp
+ * @author Yifan Wu
+ * @brief blocked (cache-line) Bloom filter for fast negative key lookups
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BloomFilter_hpp
+#define BloomFilter_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Storage.hpp"
+
+namespace ECE141 {
+
+// USE: every key hashes to ONE 64-byte block (a cache line) and sets one bit
+//      in each of the block's 8 words. A probe therefore reads a single cache
+//      line, and the 8 independent word tests are a fixed-length loop the
+//      compiler can vectorize. No false negatives; keys can't be removed.
+class BloomFilter : public Storable {
+ public:
+  static constexpr size_t kWordsPerBlock{8};
+  static constexpr size_t kBitsPerBlock{kWordsPerBlock * 64};
+
+  explicit BloomFilter(size_t aKeyCount = 0, size_t aBitsPerKey = 10);
+
+  // clear, then size the filter for aKeyCount keys
+  BloomFilter &reset(size_t aKeyCount);
+
+  void insert(uint64_t aHash);
+  [[nodiscard]] bool mayContain(uint64_t aHash) const;
+
+  // number of keys the filter was sized for
+  [[nodiscard]] size_t getCapacity() const;
+  [[nodiscard]] size_t getBlockCount() const;
+
+  static uint64_t hash(const std::string &aKey);
+  static uint64_t hash(uint32_t aKey);
+
+  // Storable interface
+  StatusResult encode(std::ostream &anOutput) const override;
+  StatusResult decode(std::istream &anInput) override;
+
+ protected:
+  struct alignas(64) Block {
+    uint64_t words[kWordsPerBlock];
+  };
+
+  [[nodiscard]] size_t blockFor(uint64_t aHash) const;
+
+  std::vector<Block> blocks;
+  size_t bitsPerKey;
+  size_t capacity{0};
+};
+
+}  // namespace ECE141
+
+#endif /* BloomFilter_hpp */
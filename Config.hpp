@@ -21,11 +21,22 @@
 
 namespace ECE141 {
 
-enum class CacheType : int { block = 0, rows = 1, views = 2 };
+// indexes: max number of table indexes kept in memory (0 = keep all)
+enum class CacheType : int { block = 0, rows = 1, views = 2, indexes = 3 };
 
 struct Config {
 
-  static std::array<size_t,3> cacheSize;
+  static std::array<size_t,4> cacheSize;
+  static size_t bloomBitsPerKey;  // 0 disables index Bloom filters
+  static size_t sortRunLimit;     // entries an external sort keeps in memory
+  static size_t sortChunkRows;    // rows per task of an in-memory sort
+  static size_t sortMemoryBytes;  // rows an order by holds before spilling
+  static size_t zoneBlocks;       // blocks per zone map zone; 0 disables
+  static size_t batchSize;        // rows per vectorized batch; 0 disables
+  static size_t hashJoinLimit;    // rows a hash join builds on; more: merge
+  static size_t workerThreads;    // threads of the TaskScheduler
+  static size_t scanWorkers;      // parallelism of a scan; 1 disables
+  static size_t morselBlocks;     // blocks of a scan task
   
   static const char* getDBExtension() { return ".db"; }
 
@@ -67,12 +78,14 @@ struct Config {
     cacheSize.at(static_cast<int>(aType)) = aSize;
   }
   
-  //cachetype: block, row, view...
+  //cachetype: block, row, view, indexes...
   static bool useCache(CacheType aType) {
     return cacheSize.at(static_cast<int>(aType)) > 0;
   }	
 
   static bool useIndex() { return true; }
+
+  static bool useBloomFilter() { return bloomBitsPerKey > 0; }
 };
 
 }  // namespace ECE141
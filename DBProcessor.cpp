@@ -11,9 +11,11 @@
 
 #include "DBProcessor.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iomanip>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -29,10 +31,16 @@
 #include "Database.hpp"
 #include "Entity.hpp"
 #include "Errors.hpp"
+#include "ExternalSorter.hpp"
+#include "Helpers.hpp"
 #include "Index.hpp"
+#include "IndexAdvisor.hpp"
+#include "Row.hpp"
 #include "Statement.hpp"
+#include "Statistics.hpp"
 #include "Storage.hpp"
 #include "TableFormatter.hpp"
+#include "TaskScheduler.hpp"
 #include "Timer.hpp"
 #include "Tokenizer.hpp"
 #include "keywords.hpp"
@@ -81,6 +89,7 @@ CmdProcessor* DBProcessor::recognizes(Tokenizer& aTokenizer) {
       DropDBStatement::recognize(aTokenizer) ||
       UseDBStatement::recognize(aTokenizer) ||
       ShowDBStatement::recognize(aTokenizer) ||
+      ShowWorkersStatement::recognize(aTokenizer) ||
       DumpDBStatement::recognize(aTokenizer)) {
     return this;  // dbProcessor
   }
@@ -102,6 +111,11 @@ Statement* DBProcessor::makeStatement(Tokenizer& aTokenizer,
       {Keywords::use_kw, useDBsStmtFactory},
   };
 
+  if (ShowWorkersStatement::recognize(aTokenizer)) {
+    auto* theStatement = new ShowWorkersStatement(app);
+    theStatement->parse(aTokenizer);
+    return theStatement;
+  }
   const Keywords& theFirstKW = aTokenizer.current().keyword;
   if (factories.find(theFirstKW) != factories.end()) {
     if (Statement* theStatement = (factories.at(theFirstKW))(app)) {
@@ -142,11 +156,24 @@ auto DBProcessor::createTable(Entity* anEntity) -> StatusResult {
           theIndexBlockNum, BlockType::index_block,
           theTableName + '.' + thePrimaryKey->getName());
 
-      // Add to IndexMap
+      // Add to IndexMap (changed: its block holds no image yet)
       theIndexMap.emplace(
           theTableName,
           std::make_unique<Index>(theStorage, theIndexBlockNum, theIndexKeyType,
                                   thePrimaryKey->getName()));
+      theActiveDB->getIndex(theTableName)->setChanged(true);
+
+      // UNIQUE columns are enforced through a one-column unique index
+      for (const auto& theAttr : anEntity->getAttributes()) {
+        if (theAttr.isUnique() && !theAttr.isPrimaryKey()) {
+          auto theIndex = std::make_unique<Index>(
+              theStorage, 0, IndexType::compositeKey, theAttr.getName());
+          theIndex->setUnique(true);
+          theActiveDB->addSecondaryIndex(theTableName, std::move(theIndex));
+        }
+      }
+
+      theActiveDB->resetZoneMap(theTableName);  // no rows yet
 
       // collect storage info for entity block
       theResult = theStorage.saveEntityBlock(*anEntity);
@@ -218,6 +245,9 @@ auto DBProcessor::describeTable(const std::string& aName) -> StatusResult {
         if (theAttr.isPrimaryKey()) {
           theExtra += "primary key ";
         }
+        if (theAttr.isUnique()) {
+          theExtra += "unique ";
+        }
         output << theExtra << "|\n";
       }
       TableFormatter::printBreak(output, theWidths);
@@ -237,11 +267,15 @@ auto DBProcessor::dropTable(const std::string& aName) -> StatusResult {
     theActiveDB->setDebugInfo("dropTable");
     Storage& theStorage = theActiveDB->getStorage();
     Index& theEntityIndex = theActiveDB->getEntityIndex();
-    IndexMap& theIndexMap = theActiveDB->getIndexMap();
 
     theResult.error = Errors::unknownTable;
     if (theActiveDB->entityExistsInDB(aName)) {
       size_t theDropCount{0};
+      // statistics go first: their block is referenced by the entity
+      theActiveDB->dropStatistics(createEntityFromStream(aName));
+      theActiveDB->dropZoneMap(aName);
+      theActiveDB->getAdvisor().forget(aName);
+
       // remove table from entityIndex and release the entity Block
       uint32_t theEntityBlkNum = theEntityIndex.valueAt(aName).value();
       theEntityIndex.erase(aName);
@@ -252,7 +286,8 @@ auto DBProcessor::dropTable(const std::string& aName) -> StatusResult {
       // drop the data associate with tableName as well
       // do this before erase the map
       if (Config::useIndex()) {
-        if ((theResult = theStorage.dropRowsByIndex(aName, theIndexMap))) {
+        Index* thePrimary = theActiveDB->getIndex(aName);
+        if ((theResult = theStorage.dropRowsByIndex(*thePrimary))) {
           theDropCount += theResult.value;
         }
       } else {
@@ -261,10 +296,14 @@ auto DBProcessor::dropTable(const std::string& aName) -> StatusResult {
         }
       }
 
+      // secondary indexes of the table go with it (not counted as rows)
+      for (auto* theIndex : theActiveDB->getSecondaryIndexes(aName)) {
+        theActiveDB->dropIndex(
+            Database::secondaryIndexKey(aName, theIndex->getName()));
+      }
+
       // remove Index of the Table from Index map
-      uint32_t theIndexBlkNum = theIndexMap.at(aName)->getBlockNum();
-      theIndexMap.erase(aName);
-      if ((theResult = theStorage.releaseBlocks(theIndexBlkNum, true))) {
+      if ((theResult = theActiveDB->dropIndex(aName))) {
         theDropCount++;
       }
       theActiveDB->setChanged(true);
@@ -317,7 +356,6 @@ auto DBProcessor::insertIntoTable(const std::string& aTableName,
   }
   const std::string theDBName{theActiveDB->getName()};
   const Index& theEntityIndex = theActiveDB->getEntityIndex();
-  IndexMap& theIndexMap = theActiveDB->getIndexMap();
   Storage& theStorage = theActiveDB->getStorage();
 
   StatusResult theResult{Errors::unknownTable};
@@ -326,10 +364,7 @@ auto DBProcessor::insertIntoTable(const std::string& aTableName,
     // load Entity object from entity block
     Entity theEntity = createEntityFromStream(aTableName);
 
-    // Get Primary Key for Index latter
-    const Attribute* thePrimaryKey = theEntity.getPrimaryKey();
-    std::string theKeyName = thePrimaryKey->getName();
-    DataTypes theValType = thePrimaryKey->getType();
+    auto theSecondaries = theActiveDB->getSecondaryIndexes(aTableName);
 
     // Use the loaded entity to verify the rows in the row collection
     std::vector<Attribute*> theAttributes;
@@ -378,20 +413,89 @@ auto DBProcessor::insertIntoTable(const std::string& aTableName,
             }
           }
         }
+      }
 
-        // create the data block and write to db-file
-        theResult = theStorage.saveDataBlock(*theRow);
+      // probe primary + unique indexes with the whole batch (sorted) before
+      // any data block is written, so a duplicate leaves nothing behind
+      Index* thePrimary = theActiveDB->getIndex(aTableName);
+      std::vector<Index*> theUniques{thePrimary};
+      for (auto* theIndex : theSecondaries) {
+        if (theIndex->isUnique()) {
+          theUniques.push_back(theIndex);
+        }
+      }
+      for (auto* theIndex : theUniques) {
+        std::vector<IndexKey> theKeys;
+        for (const auto& theRow : aRowCollect) {
+          if (!theIndex->hasNullField(theRow->getData())) {
+            theKeys.push_back(theIndex->makeKey(theRow->getData(), 0));
+          }
+        }
+        if (!theIndex->checkUnique(theKeys)) {
+          return theResult = Errors::uniqueViolation;
+        }
+      }
+
+      // a failure past the first write takes the batch back out of the
+      // first anIndexes indexes and frees its first aRows blocks
+      std::vector<Index*> theIndexes{theSecondaries};
+      theIndexes.push_back(thePrimary);
+      auto rollBack = [&](size_t aRows, size_t anIndexes) {
+        for (size_t i = 0; i < anIndexes; i++) {
+          for (size_t j = 0; j < aRows; j++) {
+            const auto& theRow = aRowCollect[j];
+            IndexKey theKey = theIndexes[i]->makeKey(theRow->getData(),
+                                                     theRow->getBlockNum());
+            if (theIndexes[i]->exists(theKey)) {
+              theIndexes[i]->erase(theKey);
+            }
+          }
+        }
+        for (size_t j = 0; j < aRows; j++) {
+          theStorage.releaseBlocks(aRowCollect[j]->getBlockNum(), true);
+        }
+      };
 
+      for (size_t j = 0; j < aRowCollect.size(); j++) {
+        // create the data block and write to db-file
+        theResult = theStorage.saveDataBlock(*aRowCollect[j]);
+        if (!theResult) {
+          rollBack(j, 0);
+          return theResult;
+        }
         // *this should modify the block num in sqlStatement rowCollect
-        const uint32_t& theDataBlockNum = theResult.value;
-        theRow->setBlockNum(theDataBlockNum);
-
-        // add data BlockNum to IndexMap
-        const KeyValues& theKV = theRow->getData();
-        auto theIndexKey =
-            Index::valueToIndexKey(theKV.at(theKeyName), theValType);
-        theIndexMap[aTableName]->setKeyValue(theIndexKey, theDataBlockNum);
-        // std::cerr << *theRow;
+        aRowCollect[j]->setBlockNum(theResult.value);
+      }
+
+      // add data BlockNums to the indexes: one sorted bulk pass per index
+      for (size_t i = 0; i < theIndexes.size(); i++) {
+        ExternalSorter theSorter(Config::sortRunLimit);
+        for (const auto& theRow : aRowCollect) {
+          theResult = theSorter.add(
+              theIndexes[i]->makeKey(theRow->getData(), theRow->getBlockNum()),
+              theRow->getBlockNum());
+          if (!theResult) {
+            break;
+          }
+        }
+        if (theResult) {
+          theResult = theIndexes[i]->bulkLoad(theSorter);
+        }
+        if (!theResult) {
+          // a failed bulk load may have added some of the keys
+          rollBack(aRowCollect.size(), i + 1);
+          return theResult;
+        }
+      }
+      if (auto* theStats = theActiveDB->getStatistics(theEntity)) {
+        for (const auto& theRow : aRowCollect) {
+          theStats->add(theRow->getData());
+        }
+      }
+      if (auto* theZoneMap = theActiveDB->getZoneMap(aTableName)) {
+        for (const auto& theRow : aRowCollect) {
+          theZoneMap->add(theRow->getData(), theRow->getBlockNum());
+        }
       }
       // Update autoinc to entity Block
       uint32_t theEntityBlockNum = theEntityIndex.valueAt(aTableName).value();
@@ -405,6 +509,225 @@ auto DBProcessor::insertIntoTable(const std::string& aTableName,
   return theResult;
 }
 
+// ANALYZE [TABLE] {table-name}
+// Rebuilds the table statistics from a full scan and stores them in a meta
+// block; inserts, updates and deletes keep them current afterwards.
+StatusResult DBProcessor::analyzeTable(const std::string& aTableName) {
+  auto* theActiveDB = app->getDatabaseInUse();
+  if (nullptr == theActiveDB) {
+    return {Errors::noDatabaseInUse};
+  }
+  theActiveDB->setDebugInfo("analyzeTable");
+  if (!theActiveDB->entityExistsInDB(aTableName)) {
+    return {Errors::unknownTable};
+  }
+  Storage& theStorage = theActiveDB->getStorage();
+  Entity theEntity = createEntityFromStream(aTableName);
+  RowCollection theRows;
+  StatusResult theScan =
+      theStorage.getRowsByIndex(*theActiveDB->getIndex(aTableName), theRows);
+
+  auto theStats = std::make_unique<TableStats>();
+  theStats->analyze(theEntity, theRows);
+  // the scan also gives tight zone bounds again (deletes never shrink them)
+  ZoneMap* theZoneMap = theScan ? theActiveDB->resetZoneMap(aTableName)
+                                : nullptr;
+  if (nullptr != theZoneMap) {
+    for (const auto& theRow : theRows) {
+      theZoneMap->add(theRow->getData(), theRow->getBlockNum());
+    }
+  }
+  const TableStats& theTableStats = *theStats;
+  uint32_t theStatsBlockNum = theEntity.getStatsBlockNum();
+  StatusResult theResult =
+      theActiveDB->setStatistics(theEntity, std::move(theStats));
+  if (theResult && theStatsBlockNum != theEntity.getStatsBlockNum()) {
+    // first ANALYZE: the entity now references its stats block
+    uint32_t theEntityBlockNum =
+        theActiveDB->getEntityIndex().valueAt(aTableName).value();
+    theResult = theStorage.saveEntityBlock(
+        theEntity, static_cast<int32_t>(theEntityBlockNum));
+  }
+  if (!theResult) {
+    return theResult;
+  }
+
+  std::vector<std::streamsize> theWidths{15, 10, 10, 10, 15, 15, 10};
+  output.setf(std::ios::left, std::ios::adjustfield);
+  TableFormatter::printBreak(output, theWidths);
+  StringList theTitles{"Field", "Rows", "Nulls", "Distinct",
+                       "Min",   "Max",  "Buckets"};
+  output << '|';
+  for (size_t i = 0; i < theTitles.size(); i++) {
+    output.width(theWidths[i] - 1);
+    output << theTitles[i] << '|';
+  }
+  output << '\n';
+  TableFormatter::printBreak(output, theWidths);
+  for (const auto& theAttr : theEntity.getAttributes()) {
+    const ColumnStats* theColumn = theTableStats.getColumn(theAttr.getName());
+    if (nullptr == theColumn) {
+      continue;
+    }
+    auto toCell = [](const std::optional<Value>& aValue) {
+      if (!aValue) {
+        return std::string{"NULL"};
+      }
+      std::string theStr = Helpers::valToString(*aValue);
+      theStr.pop_back();  // type tag
+      return theStr;
+    };
+    StringList theCells{theAttr.getName(),
+                        std::to_string(theTableStats.getRowCount()),
+                        std::to_string(theColumn->nullCount),
+                        std::to_string(theColumn->getDistinct()),
+                        toCell(theColumn->min),
+                        toCell(theColumn->max),
+                        std::to_string(theColumn->bounds.size())};
+    output << '|';
+    for (size_t i = 0; i < theCells.size(); i++) {
+      output.width(theWidths[i] - 1);
+      output << theCells[i].substr(0, theWidths[i] - 1) << '|';
+    }
+    output << '\n';
+  }
+  TableFormatter::printBreak(output, theWidths);
+  TableFormatter::printRowsInSet(output, theEntity.getAttributes().size());
+  TableFormatter::printDuration(output, Config::getTimer().elapsed());
+  return theResult;
+}
+
+// CREATE [UNIQUE] INDEX {index-name} ON {table-name} ({attr-name}, ...)
+// Builds a composite (multi-column) secondary index over the existing rows.
+// Keys are KeyEncoder byte strings (+ row blockNum unless the index is unique).
+StatusResult DBProcessor::createIndex(const std::string& aTableName,
+                                      const std::string& anIndexName,
+                                      const StringList& aFieldList,
+                                      bool aUnique, IndexType aType,
+                                      const StringList& anIncludeList,
+                                      size_t aParallel) {
+  auto* theActiveDB = app->getDatabaseInUse();
+  if (nullptr == theActiveDB) {
+    return {Errors::noDatabaseInUse};
+  }
+  theActiveDB->setDebugInfo("createIndex");
+  IndexMap& theIndexMap = theActiveDB->getIndexMap();
+  Storage& theStorage = theActiveDB->getStorage();
+
+  if (!theActiveDB->entityExistsInDB(aTableName)) {
+    return {Errors::unknownTable};
+  }
+  Entity theEntity = createEntityFromStream(aTableName);
+  // a bitmap index keeps one bitmap per value of a single column, a fulltext
+  // index one per word of a single varchar column
+  bool isSingleColumn{IndexType::bitmapKey == aType ||
+                      IndexType::fulltextKey == aType};
+  if (aFieldList.empty() ||
+      (isSingleColumn && (aUnique || aFieldList.size() > 1))) {
+    return {Errors::cantCreateIndex};
+  }
+  // included columns ride along in the keys of a plain (non-unique)
+  // composite index, so they can't take part in a uniqueness check
+  if (!anIncludeList.empty() &&
+      (aUnique || IndexType::compositeKey != aType)) {
+    return {Errors::cantCreateIndex};
+  }
+  for (const auto& theField : anIncludeList) {
+    if (nullptr == theEntity.getAttribute(theField)) {
+      return {Errors::unknownAttribute};
+    }
+  }
+  for (const auto& theField : aFieldList) {
+    const Attribute* theAttr = theEntity.getAttribute(theField);
+    if (nullptr == theAttr) {
+      return {Errors::unknownAttribute};
+    }
+    if (IndexType::fulltextKey == aType &&
+        DataTypes::varchar_type != theAttr->getType()) {
+      return {Errors::cantCreateIndex};
+    }
+  }
+  if (theIndexMap.find(Database::secondaryIndexKey(
+          aTableName, anIndexName)) != theIndexMap.end()) {
+    return {Errors::indexExists};
+  }
+
+  auto theIndex =
+      std::make_unique<Index>(theStorage, 0, aType, anIndexName);
+  theIndex->setFields(aFieldList).setIncluded(anIncludeList).setUnique(aUnique);
+
+  // split the table's data blocks into aParallel ranges; each task streams
+  // its rows (one in memory at a time) into its own external sort of
+  // (key, blockNum). The sorted runs are merged into one bulk load, and the
+  // index block is reserved last, so duplicates leave nothing behind.
+  std::vector<uint32_t> theBlockNums;
+  theActiveDB->getIndex(aTableName)->eachKV(
+      [&]([[maybe_unused]] const IndexKey& aKey, uint32_t aBlockNum) {
+        theBlockNums.push_back(aBlockNum);
+        return true;
+      });
+  std::sort(theBlockNums.begin(), theBlockNums.end());  // sequential reads
+  size_t theWorkers =
+      std::max<size_t>(std::min(aParallel, theBlockNums.size()), 1);
+  std::vector<std::unique_ptr<ExternalSorter>> theSorters;
+  for (size_t i = 0; i < theWorkers; i++) {
+    theSorters.push_back(std::make_unique<ExternalSorter>(
+        std::max<size_t>(Config::sortRunLimit / theWorkers, 1)));
+  }
+  std::vector<StatusResult> theResults(theWorkers);
+  auto extractKeys = [&](size_t aWorker) {
+    ExternalSorter& theWorkerSorter = *theSorters[aWorker];
+    StatusResult& theWorkerResult = theResults[aWorker];
+    size_t theEnd = theBlockNums.size() * (aWorker + 1) / theWorkers;
+    for (size_t i = theBlockNums.size() * aWorker / theWorkers; i < theEnd;
+         i++) {
+      std::stringstream theStream;
+      StorageInfo theInfo;
+      theWorkerResult = theStorage.load(theStream, theInfo, theBlockNums[i]);
+      // a row left out would be missing from every lookup through the index
+      Row theRow(theInfo.refId, theBlockNums[i]);
+      if (!theWorkerResult || !(theWorkerResult = theRow.decode(theStream))) {
+        return;
+      }
+      theWorkerResult = theWorkerSorter.add(
+          theIndex->makeKey(theRow.getData(), theBlockNums[i]),
+          theBlockNums[i]);
+      if (!theWorkerResult) {
+        return;
+      }
+    }
+    if (theWorkers > 1) {
+      // sort on this thread, not in the merge
+      theWorkerResult = theWorkerSorter.flush();
+    }
+  };
+  {
+    TaskGroup theTasks;
+    for (size_t i = 1; i < theWorkers; i++) {
+      theTasks.run([&extractKeys, i] { extractKeys(i); });
+    }
+    extractKeys(0);
+  }  // waits for the other ranges
+  for (const auto& theWorkerResult : theResults) {
+    if (!theWorkerResult) {
+      return theWorkerResult;  // keys are missing: no index
+    }
+  }
+  ExternalSorter& theSorter = *theSorters.front();
+  StatusResult theResult{Errors::noError};
+  for (size_t i = 1; theResult && i < theWorkers; i++) {
+    theResult = theSorter.merge(*theSorters[i]);
+  }
+  if (!theResult || !(theResult = theIndex->bulkLoad(theSorter))) {
+    return theResult;
+  }
+  theActiveDB->addSecondaryIndex(aTableName, std::move(theIndex));
+
+  TableFormatter::printStatusRowDuration(output, theResult, theSorter.getSize(),
+                                         Config::getTimer().elapsed());
+  return theResult;
+}
+
 StatusResult DBProcessor::showIndexes() {
   StatusResult theResult{Errors::noDatabaseInUse};
   if (auto* theActiveDB = app->getDatabaseInUse()) {
@@ -423,13 +746,20 @@ StatusResult DBProcessor::showIndexes() {
     TableFormatter::printBreak(output, theWidths);
 
     IndexMap& theIndexMap = theActiveDB->getIndexMap();
-    for (const auto& [theTableName, theIndex] : theIndexMap) {
+    for (const auto& [theIndexKey, theStub] : theIndexMap) {
+      // secondary indexes are keyed "Table.indexName"
+      std::string theTableName = theIndexKey.substr(0, theIndexKey.find('.'));
+      std::string theFields;
+      for (const auto& theField :
+           theActiveDB->getIndex(theIndexKey)->getFields()) {
+        theFields += (theFields.empty() ? "" : ", ") + theField;
+      }
       output.fill(' ');
       output.width(theWidths[0]);
       output << "| " + theTableName;
       output.fill(' ');
       output.width(theWidths[0]);
-      output << "| " + (theIndex->getName()) << "|\n";
+      output << "| " + theFields << "|\n";
     }
 
     TableFormatter::printBreak(output, theWidths);
@@ -440,6 +770,55 @@ StatusResult DBProcessor::showIndexes() {
   return theResult;
 }
 
+StatusResult DBProcessor::showIndexAdvice() {
+  StatusResult theResult{Errors::noDatabaseInUse};
+  if (auto* theActiveDB = app->getDatabaseInUse()) {
+    theActiveDB->setDebugInfo("showIndexAdvice");
+    IndexAdvisor::AdviceList theAdvice = theActiveDB->getAdvisor().advise(
+        [&](const std::string& aTableName, const StringList& aFields) {
+          return theActiveDB->isIndexed(aTableName, aFields);
+        });
+    std::vector<std::streamsize> theWidths = {14, 24, 10, 16};
+
+    output.setf(std::ios::left, std::ios::adjustfield);
+    TableFormatter::printBreak(output, theWidths);
+    const char* theTitles[] = {"| table", "| field(s)", "| queries",
+                               "| est. savings"};
+    for (size_t i{0}; i < theWidths.size(); i++) {
+      output.fill(' ');
+      output.width(theWidths[i]);
+      output << theTitles[i];
+    }
+    output << "|\n";
+    TableFormatter::printBreak(output, theWidths);
+
+    for (const auto& theEntry : theAdvice) {
+      std::string theFields;
+      for (const auto& theField : theEntry.fields) {
+        theFields += (theFields.empty() ? "" : ", ") + theField;
+      }
+      std::ostringstream theSavings;
+      theSavings << std::fixed << std::setprecision(6) << theEntry.savings
+                 << " s";
+      std::string theCells[] = {theEntry.table, theFields,
+                                std::to_string(theEntry.queries),
+                                theSavings.str()};
+      for (size_t i{0}; i < theWidths.size(); i++) {
+        output.fill(' ');
+        output.width(theWidths[i]);
+        output << "| " + theCells[i];
+      }
+      output << "|\n";
+    }
+
+    TableFormatter::printBreak(output, theWidths);
+    TableFormatter::printRowsInSet(output, theAdvice.size());
+    TableFormatter::printDuration(output, Config::getTimer().elapsed());
+    theResult = Errors::noError;
+  }
+  return theResult;
+}
+
 StatusResult DBProcessor::showIndexFromTable(
     const std::string& aTableName,
     [[maybe_unused]] const StringList& aFieldList) {
@@ -459,17 +838,23 @@ StatusResult DBProcessor::showIndexFromTable(
            << "|\n";
     TableFormatter::printBreak(output, theWidths);
 
-    IndexMap& theIndexMap = theActiveDB->getIndexMap();
-    std::unique_ptr<Index>& theIndex = theIndexMap.at(aTableName);
+    // a secondary index named (or covering exactly) aFieldList, else primary
+    Index* theIndex = theActiveDB->getIndex(aTableName);
+    if (nullptr == theIndex) {
+      return {Errors::unknownTable};
+    }
+    for (auto* theSecondary : theActiveDB->getSecondaryIndexes(aTableName)) {
+      if (aFieldList == theSecondary->getFields() ||
+          (1 == aFieldList.size() &&
+           aFieldList.front() == theSecondary->getName())) {
+        theIndex = theSecondary;
+      }
+    }
     auto indexVisitor = [&](const IndexKey& theIndexKey,
                             uint32_t theBlockNum) -> bool {
       output.fill(' ');
       output.width(theWidths[0]);
-      if (IndexType::intKey == theIndex->getType()) {
-        output << "| " + std::to_string(std::get<uint32_t>(theIndexKey));
-      } else {
-        output << "| " + std::get<std::string>(theIndexKey);
-      }
+      output << "| " + theIndex->keyToString(theIndexKey);
       output.fill(' ');
       output.width(theWidths[0]);
       output << "| " + std::to_string(theBlockNum) << "|\n";
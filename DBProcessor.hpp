@@ -17,6 +17,7 @@
 
 #include "BasicTypes.hpp"
 #include "CmdProcessor.hpp"
+#include "Index.hpp"
 #include "Row.hpp"
 #include "SQLProcessor.hpp"
 
@@ -60,9 +61,20 @@ class DBProcessor : public CmdProcessor {
   StatusResult describeTable(const std::string &aName);
   StatusResult dropTable(const std::string &aName);
   StatusResult showTables();
+  StatusResult createIndex(const std::string &aTableName,
+                           const std::string &anIndexName,
+                           const StringList &aFieldList,
+                           bool aUnique = false,
+                           IndexType aType = IndexType::compositeKey,
+                           const StringList &anIncludeList = {},
+                           size_t aParallel = 1);
   StatusResult showIndexes();
+  // candidate indexes ranked by the scan time they would have saved
+  StatusResult showIndexAdvice();
   StatusResult showIndexFromTable(const std::string &aTableName,
                                   const StringList &aFieldList);
+  // collect row count, distinct values, min/max, nulls and histograms
+  StatusResult analyzeTable(const std::string &aTableName);
   StatusResult insertIntoTable(const std::string &aName,
                                const RowCollection &aRowCollect);
 
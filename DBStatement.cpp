@@ -136,4 +136,24 @@ StatusResult UseDBStatement::run(
   return app->useDatabase(identifierData);
 }
 
+// ---------------------------------------------------------------------------
+// * 6. SHOW WORKERS
+ShowWorkersStatement::ShowWorkersStatement(Application *anApp)
+    : DBStatement{anApp, Keywords::show_kw} {}
+
+StatusResult ShowWorkersStatement::parse(Tokenizer &aTokenizer) {
+  aTokenizer.next(2);
+  return {Errors::noError};
+}
+
+bool ShowWorkersStatement::recognize(Tokenizer &aTokenizer) {
+  TokenSequencer theSeq(aTokenizer);
+  return theSeq.currentIsNoSkip({Keywords::show_kw, Keywords::workers_kw});
+}
+
+StatusResult ShowWorkersStatement::run(
+    [[maybe_unused]] std::ostream &anOutput) const {
+  return app->showWorkers();
+}
+
 }  // namespace ECE141
@@ -82,5 +82,15 @@ class DumpDBStatement : public DBStatement {
   StatusResult run(std::ostream& aStream) const override;
 };
 
+// ------------------------------------------------------------------------------
+// 6. SHOW WORKERS (the task scheduler's threads and utilization)
+class ShowWorkersStatement : public DBStatement {
+ public:
+  explicit ShowWorkersStatement(Application* anApp);
+  static bool recognize(Tokenizer& aTokenizer);
+  StatusResult parse(Tokenizer& aTokenizer) override;
+  StatusResult run(std::ostream& aStream) const override;
+};
+
 }  // namespace ECE141
 #endif /* DBStatement_hpp */
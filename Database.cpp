@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -21,6 +22,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -29,14 +31,20 @@
 
 #include "Attribute.hpp"
 #include "BasicTypes.hpp"
+#include "BatchOperators.hpp"
 #include "BlockIO.hpp"
 #include "Config.hpp"
 #include "Entity.hpp"
 #include "Errors.hpp"
 #include "Filters.hpp"
+#include "Helpers.hpp"
+#include "JoinOperators.hpp"
+#include "KeyEncoder.hpp"
 #include "Query.hpp"
+#include "QueryOperators.hpp"
 #include "Storage.hpp"
 #include "TableFormatter.hpp"
+#include "Timer.hpp"
 #include "keywords.hpp"
 
 namespace ECE141 {
@@ -77,6 +85,11 @@ Database::~Database() {
     storage.saveMetaBlock(entityIndex);
   }
   storage.saveIndexMap(indexMap);  // TODO: when should save?
+  for (const auto &[theTableName, theStats] : statistics) {
+    if (theStats->isChanged()) {
+      storage.saveStats(theTableName, *theStats);
+    }
+  }
   // ~BlockIO() ensure we close the stream after destruction
 }
 
@@ -92,6 +105,170 @@ std::string Database::getName() const { return name; }
 Storage &Database::getStorage() { return storage; }
 Index &Database::getEntityIndex() { return entityIndex; }
 IndexMap &Database::getIndexMap() { return indexMap; }
+
+Index *Database::getIndex(const std::string &anIndexKey) {
+  auto theIter = indexMap.find(anIndexKey);
+  if (theIter == indexMap.end()) {
+    return nullptr;
+  }
+  Index *theIndex = theIter->second.get();
+  auto theUse = std::find(loadedIndexes.begin(), loadedIndexes.end(),
+                          anIndexKey);
+  if (theUse != loadedIndexes.end()) {
+    loadedIndexes.splice(loadedIndexes.begin(), loadedIndexes, theUse);
+  } else {
+    if (!theIndex->isLoaded()) {
+      storage.loadIndex(*theIndex);
+    }
+    loadedIndexes.push_front(anIndexKey);
+    evictColdIndexes(anIndexKey.substr(0, anIndexKey.find('.')));
+  }
+  return theIndex;
+}
+
+StatusResult Database::dropIndex(const std::string &anIndexKey) {
+  auto theIter = indexMap.find(anIndexKey);
+  if (theIter == indexMap.end()) {
+    return {Errors::unknownIndex};
+  }
+  StatusResult theResult =
+      storage.releaseBlocks(theIter->second->getBlockNum(), true);
+  indexMap.erase(theIter);
+  loadedIndexes.remove(anIndexKey);
+  setChanged(true);
+  return theResult;
+}
+
+void Database::evictColdIndexes(const std::string &aTableName) {
+  if (!Config::useCache(CacheType::indexes)) {
+    return;
+  }
+  size_t theLimit = Config::getCacheSize(CacheType::indexes);
+  auto theIter = loadedIndexes.end();
+  while (loadedIndexes.size() > theLimit &&
+         theIter != loadedIndexes.begin()) {
+    --theIter;
+    // indexes of the table in use may be held by the running statement
+    if (theIter->substr(0, theIter->find('.')) == aTableName) {
+      continue;
+    }
+    auto theEntry = indexMap.find(*theIter);
+    if (theEntry != indexMap.end()) {
+      if (theEntry->second->isChanged()) {
+        storage.saveIndex(theEntry->first, *theEntry->second);
+      }
+      theEntry->second->unload();
+    }
+    theIter = loadedIndexes.erase(theIter);
+  }
+}
+
+TableStats *Database::getStatistics(const Entity &anEntity) {
+  if (0 == anEntity.getStatsBlockNum()) {
+    return nullptr;
+  }
+  auto &theStats = statistics[anEntity.getName()];
+  if (!theStats) {
+    theStats = std::make_unique<TableStats>(anEntity.getStatsBlockNum());
+    if (!storage.loadStats(*theStats)) {
+      statistics.erase(anEntity.getName());
+      return nullptr;
+    }
+  }
+  return theStats.get();
+}
+
+StatusResult Database::setStatistics(Entity &anEntity,
+                                     std::unique_ptr<TableStats> aStats) {
+  aStats->setBlockNum(anEntity.getStatsBlockNum());
+  StatusResult theResult = storage.saveStats(anEntity.getName(), *aStats);
+  if (theResult) {
+    anEntity.setStatsBlockNum(aStats->getBlockNum());
+    statistics[anEntity.getName()] = std::move(aStats);
+  }
+  return theResult;
+}
+
+StatusResult Database::dropStatistics(const Entity &anEntity) {
+  statistics.erase(anEntity.getName());
+  if (0 == anEntity.getStatsBlockNum()) {
+    return {Errors::noError};
+  }
+  return storage.releaseBlocks(anEntity.getStatsBlockNum(), true);
+}
+
+ZoneMap *Database::getZoneMap(const std::string &aTableName) {
+  auto theIter = zoneMaps.find(aTableName);
+  return (theIter != zoneMaps.end() && Config::zoneBlocks > 0)
+             ? &theIter->second
+             : nullptr;
+}
+
+ZoneMap *Database::resetZoneMap(const std::string &aTableName) {
+  zoneMaps.erase(aTableName);
+  if (0 == Config::zoneBlocks) {
+    return nullptr;
+  }
+  return &zoneMaps
+              .emplace(aTableName,
+                       ZoneMap{static_cast<uint32_t>(Config::zoneBlocks)})
+              .first->second;
+}
+
+void Database::dropZoneMap(const std::string &aTableName) {
+  zoneMaps.erase(aTableName);
+}
+
+IndexAdvisor &Database::getAdvisor() { return advisor; }
+
+bool Database::isIndexed(const std::string &aTableName,
+                         const StringList &aFields) {
+  std::vector<Index *> theIndexes{getIndex(aTableName)};
+  for (auto *theIndex : getSecondaryIndexes(aTableName)) {
+    theIndexes.push_back(theIndex);
+  }
+  return std::any_of(
+      theIndexes.begin(), theIndexes.end(), [&](const Index *anIndex) {
+        if (nullptr == anIndex ||
+            IndexType::fulltextKey == anIndex->getType()) {
+          return false;
+        }
+        const StringList &theFields = anIndex->getFields();
+        return aFields.size() <= theFields.size() &&
+               std::equal(aFields.begin(), aFields.end(), theFields.begin());
+      });
+}
+
+std::string Database::secondaryIndexKey(const std::string &aTableName,
+                                        const std::string &anIndexName) {
+  return aTableName + '.' + anIndexName;
+}
+
+std::vector<Index *> Database::getSecondaryIndexes(
+    const std::string &aTableName) {
+  std::vector<Index *> theIndexes;
+  // ["Table.", "Table/") brackets every "Table.xxx" key ('/' follows '.')
+  auto theEnd = indexMap.lower_bound(aTableName + '/');
+  for (auto theIter = indexMap.lower_bound(aTableName + '.');
+       theIter != theEnd; ++theIter) {
+    theIndexes.push_back(getIndex(theIter->first));
+  }
+  return theIndexes;
+}
+
+Index *Database::addSecondaryIndex(const std::string &aTableName,
+                                   std::unique_ptr<Index> anIndex) {
+  std::string theIndexKey = secondaryIndexKey(aTableName, anIndex->getName());
+  uint32_t theIndexBlockNum = storage.getFreeBlock();
+  storage.createAndSaveSpecialBlock(theIndexBlockNum, BlockType::index_block,
+                                    theIndexKey);
+  anIndex->setIndexBlockNum(theIndexBlockNum).setChanged(true);
+  Index *theIndex = anIndex.get();
+  indexMap.emplace(theIndexKey, std::move(anIndex));
+  loadedIndexes.push_front(theIndexKey);
+  setChanged(true);
+  return theIndex;
+}
 // ----------------------------------------------
 // TODO: TabularView
 // USE: Call this to dump the db for debug purposes...
@@ -165,128 +342,823 @@ auto Database::entityExistsInDB(const std::string &aName) const -> bool {
   return entityIndex.exists(aName);
 }
 
-// (Order by) if limit N, only sort first N element.
-void sortRows(RowCollection &aCollection, const StringList &anOrderList,
-              size_t aLimit) {
-  if (!anOrderList.empty() && !aCollection.empty()) {
-    auto cmp = [&](const auto &a, const auto &b) {
-      for (const std::string &theOrder : anOrderList) {
-        if (a->getData().at(theOrder) == b->getData().at(theOrder)) {
-          continue;
-        }
-        return a->getData().at(theOrder) < b->getData().at(theOrder);
+// USE: coerce a where-clause constant to its column type so it encodes like
+//      the stored values; false if no exact match is possible
+static bool coerceToType(Value &aValue, DataTypes aType) {
+  switch (aType) {
+    case DataTypes::int_type:
+      return std::holds_alternative<int>(aValue);
+    case DataTypes::float_type:
+      if (const int *theInt = std::get_if<int>(&aValue)) {
+        aValue = static_cast<double>(*theInt);
       }
-      return true;
-    };
-    // if limit N, only sort first N element.
-    if (aLimit > 0) {
-      std::partial_sort(aCollection.begin(),
-                        aCollection.begin() + static_cast<long>(aLimit),
-                        aCollection.end(), cmp);
+      return std::holds_alternative<double>(aValue);
+    case DataTypes::varchar_type:
+      return std::holds_alternative<std::string>(aValue);
+    default:
+      return false;
+  }
+}
+
+// Access path for a pure conjunction of `field op constant` terms:
+//  1. equality on the primary key           -> point lookup
+//  2. equality on a leftmost prefix of a composite index (plus an optional
+//     range on the next column)              -> prefix / range scan
+//  3. range on an integer primary key        -> range scan
+// Terms on bitmap indexes (and LIKE / MATCH on fulltext indexes) are combined
+// with bitwise AND/OR first; that also covers where clauses with OR, which
+// the other paths give up on.
+// The where clause is still applied to every candidate row afterwards, so
+// the scans only need to return a superset of the matches. The filter may
+// keep a row without a value, so rows keyed NULL on a scanned column are
+// always included.
+std::optional<BlockList> Database::getBlocksByAccessPath(
+    const DBQuery &aQuery) {
+  // the where clause only names columns of the from table; inner and left
+  // joins keep them as they are, so they can be narrowed before joining
+  const JoinList &theJoins = aQuery.getJoins();
+  if (std::any_of(theJoins.begin(), theJoins.end(), [](const Join &aJoin) {
+        return Keywords::inner_kw != aJoin.joinType &&
+               Keywords::left_kw != aJoin.joinType;
+      })) {
+    return std::nullopt;
+  }
+  std::optional<BlockList> theBitmapBlocks = getBlocksByBitmaps(aQuery);
+  PredicateList thePredicates;
+  if (!aQuery.getFilter().getConjuncts(thePredicates)) {
+    return theBitmapBlocks;
+  }
+  const std::string theTableName{aQuery.getEntityName()};
+  const Entity &theEntity = aQuery.getEntity();
+  std::map<std::string, Value> theEquals;
+  std::map<std::string, Value> theLows;
+  std::map<std::string, Value> theHighs;
+  for (auto &thePred : thePredicates) {
+    const Attribute *theAttr = theEntity.getAttribute(thePred.field);
+    if (nullptr == theAttr || !coerceToType(thePred.value, theAttr->getType())) {
+      continue;
+    }
+    switch (thePred.op) {
+      case Operators::equal_op:
+        theEquals.emplace(thePred.field, thePred.value);
+        break;
+      case Operators::gt_op:
+      case Operators::gte_op:
+        theLows.emplace(thePred.field, thePred.value);
+        break;
+      case Operators::lt_op:
+      case Operators::lte_op:
+        theHighs.emplace(thePred.field, thePred.value);
+        break;
+      default:
+        break;
+    }
+  }
+
+  BlockList theBlocks;
+  auto collect = [&]([[maybe_unused]] const IndexKey &aKey,
+                     uint32_t aBlockNum) {
+    theBlocks.push_back(aBlockNum);
+    return true;
+  };
+
+  Index *thePrimaryIndex = getIndex(theTableName);
+  if (nullptr == thePrimaryIndex) {
+    return std::nullopt;
+  }
+  Index &thePrimary = *thePrimaryIndex;
+  const std::string &thePrimaryName = thePrimary.getFields().front();
+  if (theEquals.count(thePrimaryName) > 0) {
+    KeyValues theProbe{{thePrimaryName, theEquals.at(thePrimaryName)}};
+    if (auto theBlockNum = thePrimary.valueAt(thePrimary.makeKey(theProbe, 0))) {
+      theBlocks.push_back(*theBlockNum);
+    }
+    return theBlocks;
+  }
+  if (theBitmapBlocks) {
+    return theBitmapBlocks;
+  }
+
+  // rows a scan fetches: equality on aFields[0, aPrefixLen) plus an optional
+  // range on the next field (ANALYZE statistics required)
+  const TableStats *theStats = getStatistics(theEntity);
+  auto estimateRows = [&](const StringList &aFields, size_t aPrefixLen,
+                          bool aRange) {
+    double theRows = static_cast<double>(theStats->getRowCount());
+    for (size_t i = 0; i < aPrefixLen; i++) {
+      theRows *= theStats->selectivity(aFields[i], Operators::equal_op,
+                                       theEquals.at(aFields[i]));
+    }
+    if (aRange) {
+      const std::string &theField = aFields[aPrefixLen];
+      if (theLows.count(theField) > 0) {
+        theRows *= theStats->selectivity(theField, Operators::gte_op,
+                                         theLows.at(theField));
+      }
+      if (theHighs.count(theField) > 0) {
+        theRows *= theStats->selectivity(theField, Operators::lte_op,
+                                         theHighs.at(theField));
+      }
+    }
+    return theRows;
+  };
+
+  // best composite index = fewest estimated rows when the table has been
+  // analyzed, else longest equality prefix (+1 for a trailing range)
+  Index *theBest{nullptr};
+  size_t theBestScore{0};
+  double theBestRows{0};
+  for (auto *theIndex : getSecondaryIndexes(theTableName)) {
+    if (IndexType::fulltextKey == theIndex->getType()) {
+      continue;  // keyed by word, not by value
+    }
+    const StringList &theFields = theIndex->getFields();
+    size_t thePrefixLen{0};
+    while (thePrefixLen < theFields.size() &&
+           theEquals.count(theFields[thePrefixLen]) > 0) {
+      thePrefixLen++;
+    }
+    size_t theScore = 2 * thePrefixLen;
+    if (thePrefixLen < theFields.size() &&
+        (theLows.count(theFields[thePrefixLen]) > 0 ||
+         theHighs.count(theFields[thePrefixLen]) > 0)) {
+      theScore++;
+    }
+    if (0 == theScore) {
+      continue;
+    }
+    double theRows = theStats ? estimateRows(theFields, thePrefixLen,
+                                             1 == theScore % 2)
+                              : 0.0;
+    if (nullptr == theBest ||
+        (theStats ? theRows < theBestRows : theScore > theBestScore)) {
+      theBest = theIndex;
+      theBestScore = theScore;
+      theBestRows = theRows;
+    }
+  }
+
+  bool thePrimaryRange = IndexType::intKey == thePrimary.getType() &&
+                         (theLows.count(thePrimaryName) > 0 ||
+                          theHighs.count(thePrimaryName) > 0);
+  if (nullptr != theBest && nullptr != theStats && thePrimaryRange &&
+      estimateRows({thePrimaryName}, 0, true) < theBestRows) {
+    theBest = nullptr;  // the primary key range is narrower
+  }
+
+  if (nullptr != theBest) {
+    const StringList &theFields = theBest->getFields();
+    std::string thePrefix;
+    size_t thePrefixLen{0};
+    for (; thePrefixLen < theFields.size() &&
+           theEquals.count(theFields[thePrefixLen]) > 0;
+         thePrefixLen++) {
+      KeyEncoder::append(thePrefix, theEquals.at(theFields[thePrefixLen]));
+    }
+    // NULL sorts first, so it is inside a range without a lower bound
+    size_t theNullColumns{thePrefixLen};
+    if (0 == theBestScore % 2) {
+      theBest->eachWithPrefix(thePrefix, collect);
     } else {
-      std::sort(aCollection.begin(), aCollection.end(), cmp);
+      const std::string &theRangeField = theFields[thePrefixLen];
+      std::string theLow{thePrefix};
+      std::string theHigh{thePrefix};
+      if (theLows.count(theRangeField) > 0) {
+        KeyEncoder::append(theLow, theLows.at(theRangeField));
+        theNullColumns++;
+      }
+      if (theHighs.count(theRangeField) > 0) {
+        KeyEncoder::append(theHigh, theHighs.at(theRangeField));
+      }
+      theBest->eachInRange(theLow, KeyEncoder::upperBound(theHigh), collect);
+    }
+    std::string theNullPrefix;
+    for (size_t i = 0; i < theNullColumns; i++) {
+      std::string theNullKey{theNullPrefix};
+      theBest->eachWithPrefix(KeyEncoder::appendNull(theNullKey), collect);
+      if (i < thePrefixLen) {
+        KeyEncoder::append(theNullPrefix, theEquals.at(theFields[i]));
+      }
     }
+    return theBlocks;
   }
+
+  if (thePrimaryRange) {
+    IndexKeyOpt theLow;
+    IndexKeyOpt theHigh;
+    if (theLows.count(thePrimaryName) > 0) {
+      theLow = static_cast<uint32_t>(
+          std::max(0, std::get<int>(theLows.at(thePrimaryName))));
+    }
+    if (theHighs.count(thePrimaryName) > 0) {
+      int theMax = std::get<int>(theHighs.at(thePrimaryName));
+      if (theMax < 0) {
+        return theBlocks;  // ids are never negative
+      }
+      theHigh = static_cast<uint32_t>(theMax);
+    }
+    thePrimary.eachInRange(theLow, theHigh, collect);
+    return theBlocks;
+  }
+  return std::nullopt;
 }
 
-StatusResult Database::getAllRowsFrom(const std::string &aTableName,
-                                      RowCollection &aCollection) {
-  StatusResult theResult{Errors::unknownTable};
-  if (entityExistsInDB(aTableName)) {
-    // get all rows associate with theTableName
-    if (Config::useIndex()) {
-      theResult = storage.getRowsByIndex(aTableName, indexMap, aCollection);
+// USE: key bounds of anIndex from the where-clause terms on its leading
+//      column (inclusive; the where clause is applied to the rows anyway)
+static void boundLeadingColumn(const Index &anIndex, const Attribute &aLead,
+                               PredicateList &aPredicates, IndexKeyOpt &aLow,
+                               IndexKeyOpt &aHigh) {
+  for (auto &thePred : aPredicates) {
+    bool isLow = Operators::gt_op == thePred.op ||
+                 Operators::gte_op == thePred.op;
+    bool isHigh = Operators::lt_op == thePred.op ||
+                  Operators::lte_op == thePred.op;
+    bool isEqual = Operators::equal_op == thePred.op;
+    if (thePred.field != aLead.getName() || !(isLow || isHigh || isEqual) ||
+        !coerceToType(thePred.value, aLead.getType())) {
+      continue;
+    }
+    IndexKey theLowKey;
+    IndexKey theHighKey;
+    if (IndexType::intKey == anIndex.getType()) {
+      int theInt = std::get<int>(thePred.value);
+      if (theInt < 0 && !isLow) {
+        aLow = 1u;  // ids are never negative: an empty range
+        aHigh = 0u;
+        return;
+      }
+      theLowKey = theHighKey = static_cast<uint32_t>(std::max(0, theInt));
+    } else if (IndexType::strKey == anIndex.getType()) {
+      theLowKey = theHighKey = std::get<std::string>(thePred.value);
     } else {
-      theResult = storage.getRowsByBruteForce(aTableName, aCollection);
+      // composite keys go on past the leading column
+      std::string theEncoded;
+      KeyEncoder::append(theEncoded, thePred.value);
+      theHighKey = KeyEncoder::upperBound(theEncoded);
+      // NULL keys sort first: start there, the filter may keep those rows
+      theLowKey = aLead.isNullable() ? std::string{} : std::move(theEncoded);
+    }
+    if ((isLow || isEqual) && !aLow) {
+      aLow = theLowKey;
+    }
+    if ((isHigh || isEqual) && !aHigh) {
+      aHigh = theHighKey;
     }
   }
-  return theResult;
 }
 
-using JoinFactory =
-    std::function<StatusResult(const Join &, const RowCollection &,
-                               const RowCollection &, RowCollection &)>;
+Index *Database::getCoveringIndex(const DBQuery &aQuery, IndexKeyOpt &aLow,
+                                  IndexKeyOpt &aHigh) {
+  if (!aQuery.getJoins().empty()) {
+    return nullptr;
+  }
+  const Entity &theEntity = aQuery.getEntity();
+  std::set<std::string> theColumns;
+  for (const auto &theField : aQuery.getFieldList()) {
+    if ("*" == theField) {
+      for (const auto &theAttr : theEntity.getAttributes()) {
+        theColumns.insert(theAttr.getName());
+      }
+    } else {
+      theColumns.insert(theField);
+    }
+  }
+  for (const auto &theField : aQuery.getOrderBy()) {
+    theColumns.insert(theField);
+  }
+  for (const auto &theExpr : aQuery.getFilter().getExpressions()) {
+    for (const auto *theOperand : {&theExpr->lhs, &theExpr->rhs}) {
+      if (TokenType::identifier == theOperand->ttype) {
+        theColumns.insert(theOperand->name);
+      }
+    }
+  }
+  PredicateList thePredicates;
+  bool isConjunction = aQuery.getFilter().getConjuncts(thePredicates);
 
-StatusResult Database::joinRows(const JoinList &aJoinList,
-                                RowCollection &aCollection) {
-  StatusResult theResult{};
-  RowCollection theJoinResult;
+  std::vector<Index *> theIndexes{getIndex(aQuery.getEntityName())};
+  for (auto *theIndex : getSecondaryIndexes(aQuery.getEntityName())) {
+    theIndexes.push_back(theIndex);
+  }
+  Index *theFirst{nullptr};
+  for (auto *theIndex : theIndexes) {
+    if (nullptr == theIndex || IndexType::bitmapKey == theIndex->getType() ||
+        IndexType::fulltextKey == theIndex->getType() ||
+        !std::all_of(theColumns.begin(), theColumns.end(),
+                     [&](const std::string &aColumn) {
+                       return theIndex->hasField(aColumn);
+                     })) {
+      continue;
+    }
+    const Attribute *theLead =
+        theEntity.getAttribute(theIndex->getFields().front());
+    // a non-string single column key is kept as text (see Index::makeKey)
+    if (nullptr == theLead || (IndexType::strKey == theIndex->getType() &&
+                               DataTypes::varchar_type != theLead->getType())) {
+      continue;
+    }
+    IndexKeyOpt theLow;
+    IndexKeyOpt theHigh;
+    if (isConjunction) {
+      boundLeadingColumn(*theIndex, *theLead, thePredicates, theLow, theHigh);
+    }
+    if (theLow || theHigh) {
+      aLow = theLow;
+      aHigh = theHigh;
+      return theIndex;
+    }
+    theFirst = (nullptr == theFirst) ? theIndex : theFirst;
+  }
+  return theFirst;
+}
 
-  if (!aJoinList.empty()) {
-    for (const auto &theJoin : aJoinList) {
-      RowCollection theJoinRows;
-      theResult = getAllRowsFrom(theJoin.table, theJoinRows);
-      if (!theResult) {
-        return theResult;
-      }
-      static std::map<Keywords, JoinFactory> factories{
-          {Keywords::left_kw, leftJoinRows},
-          {Keywords::right_kw, rightJoinRows},
-          {Keywords::inner_kw, innerJoinRows},
-          {Keywords::cross_kw, crossJoinRows},
-          {Keywords::full_kw, fullJoinRows},
-      };
-      if (factories.find(theJoin.joinType) != factories.end()) {
-        theResult = factories[theJoin.joinType](theJoin, aCollection,
-                                                theJoinRows, theJoinResult);
-        if (!theResult) {
-          return theResult;
+std::optional<BlockList> Database::getBlocksByBitmaps(const DBQuery &aQuery) {
+  std::map<std::string, Index *> theBitmapIndexes;  // field : index
+  std::map<std::string, Index *> theTextIndexes;
+  for (auto *theIndex : getSecondaryIndexes(aQuery.getEntityName())) {
+    if (IndexType::bitmapKey == theIndex->getType()) {
+      theBitmapIndexes.emplace(theIndex->getFields().front(), theIndex);
+    } else if (IndexType::fulltextKey == theIndex->getType()) {
+      theTextIndexes.emplace(theIndex->getFields().front(), theIndex);
+    }
+  }
+  if (theBitmapIndexes.empty() && theTextIndexes.empty()) {
+    return std::nullopt;
+  }
+  const Entity &theEntity = aQuery.getEntity();
+  auto theRows = aQuery.getFilter().evaluate(
+      [&](const Predicate &aPredicate) -> std::optional<RoaringBitmap> {
+        if (Operators::like_op == aPredicate.op ||
+            Operators::match_op == aPredicate.op) {
+          auto theText = theTextIndexes.find(aPredicate.field);
+          const auto *thePattern = std::get_if<std::string>(&aPredicate.value);
+          if (theText == theTextIndexes.end() || nullptr == thePattern) {
+            return std::nullopt;
+          }
+          return theText->second->postingsOf(aPredicate.op, *thePattern);
         }
-      } else {
-        return {Errors::unexpectedKeyword};
-      }
+        auto theIter = theBitmapIndexes.find(aPredicate.field);
+        const Attribute *theAttr = theEntity.getAttribute(aPredicate.field);
+        Value theValue{aPredicate.value};
+        if (theIter == theBitmapIndexes.end() || nullptr == theAttr ||
+            !coerceToType(theValue, theAttr->getType())) {
+          return std::nullopt;
+        }
+        return theIter->second->bitmapOf(aPredicate.op, theValue);
+      });
+  if (!theRows) {
+    return std::nullopt;
+  }
+  BlockList theBlocks;
+  theRows->each([&](uint32_t aBlockNum) {
+    theBlocks.push_back(aBlockNum);
+    return true;
+  });
+  return theBlocks;
+}
+
+// the joined table was read in full to match its side of each `=` term
+void Database::recordJoinKeys(const Join &aJoin, double aSeconds) {
+  size_t theEntityId = Helpers::hashString(aJoin.table);
+  for (const auto &theExpr : aJoin.exprs) {
+    if (Operators::equal_op == theExpr->op) {
+      const Operand &theKey =
+          (theEntityId == theExpr->lhs.entityId) ? theExpr->lhs : theExpr->rhs;
+      advisor.recordJoin(aJoin.table, theKey.name,
+                         aSeconds / aJoin.exprs.size());
     }
-    std::swap(aCollection, theJoinResult);
   }
-  return theResult;
 }
 
-StatusResult Database::selectRow(const DBQuery &aQuery,
-                                 RowCollection &aCollection) {
-  auto theResult = getAllRowsFrom(aQuery.getEntityName(), aCollection);
-  if (!theResult) {
-    return theResult;
+size_t Database::estimateRows(const std::string &aTableName) {
+  Index *theIndex = Config::useIndex() ? getIndex(aTableName) : nullptr;
+  return (nullptr != theIndex) ? theIndex->getSize() : storage.getBlockCount();
+}
+
+std::optional<std::string> Database::getOrderedIndex(
+    const std::string &aTableName, const std::string &aField) {
+  if (!Config::useIndex()) {
+    return std::nullopt;
+  }
+  auto isOrdered = [&](const Index *anIndex) {
+    return nullptr != anIndex && !anIndex->getFields().empty() &&
+           aField == anIndex->getFields().front() &&
+           (IndexType::intKey == anIndex->getType() ||
+            IndexType::strKey == anIndex->getType() ||
+            IndexType::compositeKey == anIndex->getType());
+  };
+  if (isOrdered(getIndex(aTableName))) {
+    return aTableName;
   }
+  for (auto *theIndex : getSecondaryIndexes(aTableName)) {
+    if (isOrdered(theIndex)) {
+      return secondaryIndexKey(aTableName, theIndex->getName());
+    }
+  }
+  return std::nullopt;
+}
 
+// A merge join streams both sides, so it takes over when both can be read
+// in key order, or when even the smaller side is too big to hash. Index
+// order is only used for a one-column int or varchar key of the same type
+// on both sides: then it is the order of the merge keys.
+OperatorPtr Database::makeMergeJoin(const DBQuery &aQuery, const Join &aJoin,
+                                    OperatorPtr &aLeft, bool isLeftScan,
+                                    const JoinOperator::Observer &anObserver) {
+  JoinColumns theColumns{aJoin};
+  const Expression &theTerm = *aJoin.exprs.front();
+  bool isOrderable = 1 == aJoin.exprs.size() &&
+                     theTerm.lhs.dtype == theTerm.rhs.dtype &&
+                     (DataTypes::int_type == theTerm.lhs.dtype ||
+                      DataTypes::varchar_type == theTerm.lhs.dtype);
+  const std::string theTable{aQuery.getEntityName()};
+  std::optional<std::string> theLeftIndex;
+  std::optional<std::string> theRightIndex;
+  if (isOrderable) {
+    theLeftIndex = isLeftScan
+                       ? getOrderedIndex(theTable, theColumns.left.front())
+                       : std::nullopt;
+    theRightIndex = getOrderedIndex(aJoin.table, theColumns.right.front());
+  }
+  bool isTooBig = std::min(estimateRows(theTable),
+                           estimateRows(aJoin.table)) > Config::hashJoinLimit;
+  if (!(theLeftIndex && theRightIndex) && !isTooBig) {
+    return nullptr;
+  }
+  // a side in index order, or sorted by its merge keys
+  auto ordered = [&](const std::optional<std::string> &anIndexKey,
+                     OperatorPtr aSide, bool isLeft) -> OperatorPtr {
+    if (anIndexKey) {
+      return std::make_unique<OrderedScanOperator>(*this, *anIndexKey);
+    }
+    return std::make_unique<ExternalSortOperator>(
+        *this, std::move(aSide), [theColumns, isLeft](const Row &aRow) {
+          std::string theKey;
+          theColumns.sortKeyOf(aRow, isLeft, theKey);
+          return theKey;
+        });
+  };
+  OperatorPtr theLeft = ordered(theLeftIndex, std::move(aLeft), true);
+  OperatorPtr theRight = ordered(
+      theRightIndex, std::make_unique<ScanOperator>(*this, aJoin.table), false);
+  return std::make_unique<MergeJoinOperator>(std::move(theLeft),
+                                             std::move(theRight), aJoin,
+                                             anObserver);
+}
+
+// An index lookup per left row beats reading the whole join table when the
+// left side has fewer rows than log2 of the table's size divides into it.
+// Only terms comparing columns of one type probe, so the left value needs
+// no conversion beyond coerceToType.
+OperatorPtr Database::makeIndexJoin(const Join &aJoin, OperatorPtr &aLeft,
+                                    std::optional<size_t> aLeftRows,
+                                    const JoinOperator::Observer &anObserver) {
+  if (!Config::useIndex() || !aLeftRows ||
+      !(Keywords::inner_kw == aJoin.joinType ||
+        Keywords::left_kw == aJoin.joinType)) {
+    return nullptr;
+  }
+  double theRows = static_cast<double>(estimateRows(aJoin.table));
+  if (static_cast<double>(*aLeftRows) * std::log2(theRows + 1) >= theRows) {
+    return nullptr;
+  }
+  JoinColumns theColumns{aJoin};
+  Index *thePrimary = getIndex(aJoin.table);
+  std::vector<Index *> theSecondaries = getSecondaryIndexes(aJoin.table);
+  for (size_t i{0}; i < aJoin.exprs.size(); i++) {
+    const Expression &theTerm = *aJoin.exprs[i];
+    const std::string &theField = theColumns.right[i];
+    if (theTerm.lhs.dtype != theTerm.rhs.dtype) {
+      continue;
+    }
+    std::string theIndexKey;
+    if (nullptr != thePrimary && theField == thePrimary->getFields().front()) {
+      theIndexKey = aJoin.table;
+    }
+    for (auto *theIndex : theSecondaries) {
+      if (theIndexKey.empty() && theField == theIndex->getFields().front() &&
+          (IndexType::compositeKey == theIndex->getType() ||
+           IndexType::bitmapKey == theIndex->getType())) {
+        theIndexKey = secondaryIndexKey(aJoin.table, theIndex->getName());
+      }
+    }
+    if (theIndexKey.empty()) {
+      continue;
+    }
+    DataTypes theType{theTerm.lhs.dtype};
+    auto theProbe = [this, theIndexKey, theField, theType](
+                        const Value &aValue, BlockList &aBlocks) {
+      Index *theIndex = getIndex(theIndexKey);
+      Value theValue{aValue};
+      if (nullptr == theIndex || !coerceToType(theValue, theType)) {
+        return;
+      }
+      auto collect = [&]([[maybe_unused]] const IndexKey &aKey,
+                         uint32_t aBlockNum) {
+        aBlocks.push_back(aBlockNum);
+        return true;
+      };
+      if (IndexType::compositeKey == theIndex->getType()) {
+        std::string thePrefix;
+        KeyEncoder::append(thePrefix, theValue);
+        theIndex->eachWithPrefix(thePrefix, collect);
+      } else if (IndexType::bitmapKey == theIndex->getType()) {
+        theIndex->bitmapOf(Operators::equal_op, theValue)
+            .each([&](uint32_t aBlockNum) {
+              aBlocks.push_back(aBlockNum);
+              return true;
+            });
+      } else if (auto theBlockNum = theIndex->valueAt(
+                     theIndex->makeKey({{theField, theValue}}, 0))) {
+        aBlocks.push_back(*theBlockNum);
+      }
+    };
+    return std::make_unique<IndexJoinOperator>(
+        *this, std::move(aLeft), aJoin, theColumns.left[i],
+        std::move(theProbe), anObserver);
+  }
+  return nullptr;
+}
+
+// source (index-only scan, access path or zone-filtered scan), joins, where,
+// order by, limit, then the select list
+StatusResult Database::makePlan(const DBQuery &aQuery, OperatorPtr &aPlan,
+                                bool anIndexOnly) {
+  const std::string theTableName{aQuery.getEntityName()};
+  if (!entityExistsInDB(theTableName)) {
+    return {Errors::unknownTable};
+  }
+  IndexKeyOpt theLow;
+  IndexKeyOpt theHigh;
+  Index *theCovering = (anIndexOnly && Config::useIndex())
+                           ? getCoveringIndex(aQuery, theLow, theHigh)
+                           : nullptr;
+  // a bounded index-only scan beats any block list; an unbounded one beats
+  // reading every block of the table
+  std::optional<BlockList> theBlocks;
+  if (Config::useIndex() && (nullptr == theCovering || (!theLow && !theHigh))) {
+    theBlocks = getBlocksByAccessPath(aQuery);
+  }
   const JoinList &theJoinList = aQuery.getJoins();
-  if (!theJoinList.empty()) {
-    theResult = joinRows(theJoinList, aCollection);
-    if (!theResult) {
-      return theResult;
+  bool isScan{false};
+  if (nullptr != theCovering && !theBlocks) {
+    std::string theIndexKey{theTableName};
+    for (const auto &[theKey, theIndex] : indexMap) {
+      theIndexKey = (theIndex.get() == theCovering) ? theKey : theIndexKey;
+    }
+    aPlan = std::make_unique<IndexOnlyScanOperator>(
+        *this, theIndexKey, aQuery.getEntity(), theLow, theHigh);
+  } else if (theBlocks) {
+    aPlan = std::make_unique<IndexScanOperator>(*this, std::move(*theBlocks));
+  } else {
+    aPlan = makeZoneScan(aQuery);
+    isScan = true;
+  }
+
+  for (const auto &theJoin : theJoinList) {
+    OperatorPtr theJoinScan =
+        std::make_unique<ScanOperator>(*this, theJoin.table);
+    auto theObserver = [this, &theJoin](double aSeconds) {
+      recordJoinKeys(theJoin, aSeconds);
+    };
+    bool isOuterOrInner = Keywords::left_kw == theJoin.joinType ||
+                          Keywords::right_kw == theJoin.joinType ||
+                          Keywords::inner_kw == theJoin.joinType ||
+                          Keywords::full_kw == theJoin.joinType;
+    // only the first join's left rows are still rows of a stored table
+    bool isFirst = &theJoin == &theJoinList.front();
+    OperatorPtr theJoinOp;
+    if (isOuterOrInner && JoinColumns::canHash(theJoin)) {
+      std::optional<size_t> theLeftRows;
+      if (isFirst && theBlocks) {
+        theLeftRows = theBlocks->size();
+      } else if (isFirst && isScan) {
+        theLeftRows = estimateRows(theTableName);
+      }
+      theJoinOp = makeIndexJoin(theJoin, aPlan, theLeftRows, theObserver);
+      if (!theJoinOp && isFirst) {
+        theJoinOp = makeMergeJoin(aQuery, theJoin, aPlan, isScan, theObserver);
+      }
+    }
+    if (theJoinOp) {
+      aPlan = std::move(theJoinOp);
+    } else if (isOuterOrInner && JoinColumns::canHash(theJoin)) {
+      aPlan = std::make_unique<HashJoinOperator>(
+          std::move(aPlan), std::move(theJoinScan), theJoin, theObserver);
+    } else if (Keywords::left_kw == theJoin.joinType) {
+      aPlan = std::make_unique<JoinOperator>(
+          std::move(aPlan), std::move(theJoinScan), theJoin, theObserver);
+    } else if (Keywords::right_kw == theJoin.joinType) {
+      aPlan = std::make_unique<JoinOperator>(
+          std::move(theJoinScan), std::move(aPlan), theJoin, theObserver);
+    } else if (Keywords::inner_kw == theJoin.joinType ||
+               Keywords::cross_kw == theJoin.joinType ||
+               Keywords::full_kw == theJoin.joinType) {
+      return {Errors::notImplemented};
+    } else {
+      return {Errors::unexpectedKeyword};
     }
   }
 
-  StringList theOrderList{aQuery.getOrderBy()};
-  size_t theLimit = aQuery.getLimit();
   // where
   if (aQuery.getExpressionNum() > 0) {
-    aCollection.erase(
-        std::remove_if(
-            aCollection.begin(), aCollection.end(),
-            [&](auto &x) { return !aQuery.getFilter().matches(x->getData()); }),
-        aCollection.end());
+    // rows no index narrowed down: the advisor learns what the filter kept
+    FilterOperator::Observer theObserver;
+    PredicateList thePredicates;
+    if (isScan && theJoinList.empty() &&
+        aQuery.getFilter().getConjuncts(thePredicates)) {
+      theObserver = [this, theTableName, thePredicates](
+                        size_t aSeen, size_t aKept, double aSeconds) {
+        advisor.recordScan(theTableName, thePredicates, aSeen, aKept,
+                           aSeconds);
+      };
+    }
+    OperatorPtr theParallel;
+    if (isScan) {
+      theParallel = makeParallelScan(aQuery, theObserver);
+    }
+    if (theParallel) {
+      aPlan = std::move(theParallel);
+    } else if (theJoinList.empty() && Config::batchSize > 0 &&
+               BatchFilterOperator::canRun(aQuery.getFilter())) {
+      aPlan = makeBatchFilter(aQuery, std::move(aPlan), anIndexOnly,
+                              std::move(theObserver));
+    } else {
+      aPlan = std::make_unique<FilterOperator>(
+          std::move(aPlan), aQuery.getFilter(), std::move(theObserver));
+    }
   }
-  // Order by
+  // order by, limit
+  StringList theOrderList{aQuery.getOrderBy()};
+  size_t theLimit = aQuery.getLimit();
   if (!theOrderList.empty()) {
-    sortRows(aCollection, theOrderList, theLimit);
+    aPlan = std::make_unique<SortOperator>(std::move(aPlan), theOrderList,
+                                           theLimit);
   }
-  // Limit
-  if (theLimit > 0 && aCollection.size() > theLimit) {
-    aCollection.erase(aCollection.begin() + static_cast<long>(theLimit),
-                      aCollection.end());
+  if (theLimit > 0) {
+    aPlan = std::make_unique<LimitOperator>(std::move(aPlan), theLimit);
+  }
+  // select list
+  StringList theFields{aQuery.getFieldList()};
+  if (anIndexOnly &&
+      std::find(theFields.begin(), theFields.end(), "*") == theFields.end()) {
+    aPlan = std::make_unique<ProjectOperator>(std::move(aPlan), theFields);
   }
   return {Errors::noError};
 }
 
+// Rows go through the where clause a batch of columns at a time, and
+// columns the select list and order by don't use are dropped before rows
+// are built again.
+OperatorPtr Database::makeBatchFilter(const DBQuery &aQuery,
+                                      OperatorPtr aSource, bool anIndexOnly,
+                                      FilterOperator::Observer anObserver) {
+  BatchPtr theBatches = std::make_unique<BatchScanOperator>(
+      std::move(aSource), aQuery.getEntity(), Config::batchSize);
+  theBatches = std::make_unique<BatchFilterOperator>(
+      std::move(theBatches), aQuery.getFilter(), std::move(anObserver));
+  StringList theFields{aQuery.getFieldList()};
+  if (anIndexOnly &&
+      std::find(theFields.begin(), theFields.end(), "*") == theFields.end()) {
+    for (const auto &theField : aQuery.getOrderBy()) {
+      theFields.push_back(theField);
+    }
+    theBatches = std::make_unique<BatchProjectOperator>(std::move(theBatches),
+                                                        theFields);
+  }
+  return std::make_unique<UnbatchOperator>(std::move(theBatches));
+}
+
+// A scan without a zone map reads every row anyway, so it builds one.
+OperatorPtr Database::makeZoneScan(const DBQuery &aQuery) {
+  const std::string theTableName{aQuery.getEntityName()};
+  ZoneMap *theZoneMap = getZoneMap(theTableName);
+  if (nullptr == theZoneMap) {
+    return std::make_unique<ScanOperator>(*this, theTableName, nullptr,
+                                          Config::zoneBlocks > 0);
+  }
+  return std::make_unique<ScanOperator>(*this, theTableName,
+                                        makeZoneFilter(aQuery, *theZoneMap));
+}
+
+BlockFilter Database::makeZoneFilter(const DBQuery &aQuery,
+                                     ZoneMap &aZoneMap) {
+  const Entity &theEntity = aQuery.getEntity();
+  std::optional<RoaringBitmap> theZones;
+  if (aQuery.getJoins().empty()) {
+    theZones = aQuery.getFilter().evaluate(
+        [&](const Predicate &aPredicate) -> std::optional<RoaringBitmap> {
+          const Attribute *theAttr = theEntity.getAttribute(aPredicate.field);
+          Predicate theTerm{aPredicate};
+          if (nullptr == theAttr ||
+              !coerceToType(theTerm.value, theAttr->getType())) {
+            return std::nullopt;
+          }
+          return aZoneMap.candidates(theTerm);
+        });
+  }
+  if (!theZones) {
+    return nullptr;
+  }
+  return [theZones = std::move(*theZones), theZoneMap = &aZoneMap](
+             uint32_t aBlockNum) {
+    return theZones.contains(theZoneMap->zoneOf(aBlockNum));
+  };
+}
+
+// Worth it once the table fills a morsel per worker or two. A table without
+// a zone map yet gets the serial scan, which builds one.
+OperatorPtr Database::makeParallelScan(const DBQuery &aQuery,
+                                       FilterOperator::Observer anObserver) {
+  const std::string theTableName{aQuery.getEntityName()};
+  ZoneMap *theZoneMap = getZoneMap(theTableName);
+  if (Config::scanWorkers < 2 || !aQuery.getJoins().empty() ||
+      !Config::useIndex() || nullptr == getIndex(theTableName) ||
+      (nullptr == theZoneMap && Config::zoneBlocks > 0) ||
+      estimateRows(theTableName) < 2 * Config::morselBlocks) {
+    return nullptr;
+  }
+  return std::make_unique<ParallelScanOperator>(
+      *this, theTableName, aQuery.getFilter(),
+      theZoneMap ? makeZoneFilter(aQuery, *theZoneMap) : nullptr,
+      std::move(anObserver));
+}
+
+StatusResult Database::selectRow(const DBQuery &aQuery,
+                                 RowCollection &aCollection, bool anIndexOnly) {
+  OperatorPtr thePlan;
+  StatusResult theResult = makePlan(aQuery, thePlan, anIndexOnly);
+  if (theResult && (theResult = thePlan->open())) {
+    std::unique_ptr<Row> theRow;
+    while ((theResult = thePlan->next(theRow)) && theRow) {
+      aCollection.push_back(std::move(theRow));
+    }
+    thePlan->close();
+  }
+  return theResult;
+}
+
 auto Database::updateRow(const DBQuery &aQuery, RowCollection &aCollection)
     -> StatusResult {
   auto theResult = selectRow(aQuery, aCollection);
-  // std::string theEntityName{aQuery.getEntityName()};
+  if (!theResult) {
+    return theResult;
+  }
+  const auto &[theKey, theVal] = aQuery.getUpdateKV();
+  // only indexes covering the updated field need new keys
+  std::vector<Index *> theIndexes;
+  auto theCandidates = getSecondaryIndexes(aQuery.getEntityName());
+  theCandidates.push_back(getIndex(aQuery.getEntityName()));
+  for (auto *theIndex : theCandidates) {
+    if (theIndex->hasField(theKey)) {
+      theIndexes.push_back(theIndex);
+    }
+  }
+
+  // probe unique indexes before any block is rewritten
+  for (auto *theIndex : theIndexes) {
+    if (theIndex->isUnique()) {
+      std::vector<IndexKey> theOldKeys;
+      std::vector<IndexKey> theNewKeys;
+      for (const auto &theRow : aCollection) {
+        KeyValues theNewData{theRow->getData()};
+        theNewData[theKey] = theVal;
+        if (!theIndex->hasNullField(theNewData)) {
+          theOldKeys.push_back(
+              theIndex->makeKey(theRow->getData(), theRow->getBlockNum()));
+          theNewKeys.push_back(
+              theIndex->makeKey(theNewData, theRow->getBlockNum()));
+        }
+      }
+      if (!theIndex->checkUnique(theNewKeys, theOldKeys)) {
+        return {Errors::uniqueViolation};
+      }
+    }
+  }
+
+  TableStats *theStats = getStatistics(aQuery.getEntity());
+  ZoneMap *theZoneMap = getZoneMap(aQuery.getEntityName());
   for (auto &theRow : aCollection) {
-    const auto &[theKey, theVal] = aQuery.getUpdateKV();
+    uint32_t theBlockNum = theRow->getBlockNum();
+    for (auto *theIndex : theIndexes) {
+      theIndex->erase(theIndex->makeKey(theRow->getData(), theBlockNum));
+    }
+    if (theStats) {
+      theStats->remove(theRow->getData());
+    }
     theRow->getData()[theKey] = theVal;
+    if (theStats) {
+      theStats->add(theRow->getData());
+    }
+    if (theZoneMap) {
+      theZoneMap->add(theRow->getData(), theBlockNum);
+    }
+    for (auto *theIndex : theIndexes) {
+      theIndex->setKeyValue(theIndex->makeKey(theRow->getData(), theBlockNum),
+                            theBlockNum);
+    }
     theResult = storage.saveDataBlock(
-        *theRow, static_cast<int32_t>(theRow->getBlockNum()));
+        *theRow, static_cast<int32_t>(theBlockNum));
   }
   return theResult;
 }
@@ -297,7 +1169,9 @@ auto Database::deleteRow(const DBQuery &aQuery, RowCollection &aCollection)
   auto theResult = selectRow(aQuery, aCollection);
   const Entity &theEntity = aQuery.getEntity();
   const Attribute *thePrimaryKey = theEntity.getPrimaryKey();
-  auto &theIndex = indexMap[aQuery.getEntityName()];
+  Index *theIndex = getIndex(aQuery.getEntityName());
+  auto theSecondaries = getSecondaryIndexes(aQuery.getEntityName());
+  TableStats *theStats = getStatistics(theEntity);
 
   std::for_each(
       aCollection.begin(), aCollection.end(), [&](const auto &theRow) {
@@ -312,57 +1186,16 @@ auto Database::deleteRow(const DBQuery &aQuery, RowCollection &aCollection)
           theIndex->erase(std::get<std::string>(theIdxKey));
         }
         theIndex->setChanged(true);
+        for (auto *theSecondary : theSecondaries) {
+          theSecondary->erase(std::get<std::string>(
+              theSecondary->makeKey(theRow->getData(), theRow->getBlockNum())));
+        }
+        if (theStats) {
+          theStats->remove(theRow->getData());
+        }
         theResult = storage.releaseBlocks(theRow->getBlockNum(), true);
       });
   return theResult;
 }
 
-auto leftJoinRows(const Join &aJoin, const RowCollection &aLHSCollection,
-                  const RowCollection &aRHSCollection,
-                  RowCollection &aJoinedCollection) -> StatusResult {
-  if (!aJoin.exprs.empty() && !aRHSCollection.empty()) {
-    Row theNullRow{*(aRHSCollection[0])};
-    theNullRow.setAllNull();
-    for (const auto &RowLHS : aLHSCollection) {
-      bool matchAny = false;
-      auto collect = [&](const auto &RowRHS) {
-        if (Filters::matches(aJoin.exprs, RowLHS->getData(),
-                             RowRHS->getData())) {
-          aJoinedCollection.push_back(std::make_unique<Row>(*RowLHS + *RowRHS));
-          matchAny = true;
-        }
-      };
-      std::for_each(aRHSCollection.begin(), aRHSCollection.end(), collect);
-      if (!matchAny) {
-        aJoinedCollection.push_back(
-            std::make_unique<Row>(*RowLHS + theNullRow));
-      }
-    }
-  }
-  return {Errors::noError};
-}
-
-auto rightJoinRows(const Join &aJoin, const RowCollection &aLHSCollection,
-                   const RowCollection &aRHSCollection,
-                   RowCollection &aJoinedCollection) -> StatusResult {
-  return leftJoinRows(aJoin, aRHSCollection, aLHSCollection, aJoinedCollection);
-}
-
-auto innerJoinRows(const Join &aJoin, const RowCollection &aLHSCollection,
-                   const RowCollection &aRHSCollection,
-                   RowCollection &aJoinedCollection) -> StatusResult {
-  return {Errors::notImplemented};
-}
-
-auto crossJoinRows(const Join &aJoin, const RowCollection &aLHSCollection,
-                   const RowCollection &aRHSCollection,
-                   RowCollection &aJoinedCollection) -> StatusResult {
-  return {Errors::notImplemented};
-}
-
-auto fullJoinRows(const Join &aJoin, const RowCollection &aLHSCollection,
-                  const RowCollection &aRHSCollection,
-                  RowCollection &aJoinedCollection) -> StatusResult {
-  return {Errors::notImplemented};
-}
 }  // namespace ECE141
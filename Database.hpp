@@ -13,15 +13,23 @@
 #define Database_hpp
 
 #include <iosfwd>
+#include <list>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "Index.hpp"
+#include "IndexAdvisor.hpp"
 #include "Storage.hpp"
 #include "Joins.hpp"    // for Join
+#include "QueryOperators.hpp"
 #include "Row.hpp"      // for Row
+#include "Statistics.hpp"
+#include "ZoneMap.hpp"
 
 namespace ECE141 {
 class DBQuery;
+class Entity;
 class StatusResult;
 
 struct CreateDB {};  // tags for db-open modes...
@@ -48,10 +56,54 @@ class Database {
   Storage &getStorage();
   Index &getEntityIndex();
   IndexMap &getIndexMap();
+  // index by map key ("Table" or "Table.indexName"), read from disk on first
+  // use; nullptr if there is no such index
+  Index *getIndex(const std::string &anIndexKey);
+  // release the index blocks and forget the index
+  StatusResult dropIndex(const std::string &anIndexKey);
+
+  // secondary indexes share indexMap with the primary ones, keyed by
+  // "Table.indexName" (primary indexes are keyed by "Table")
+  static std::string secondaryIndexKey(const std::string &aTableName,
+                                       const std::string &anIndexName);
+  std::vector<Index *> getSecondaryIndexes(const std::string &aTableName);
+  // reserve an index block for anIndex and register it under aTableName
+  Index *addSecondaryIndex(const std::string &aTableName,
+                           std::unique_ptr<Index> anIndex);
+
+  // ANALYZE statistics of anEntity, read from its meta block on first use;
+  // nullptr if the table was never analyzed
+  TableStats *getStatistics(const Entity &anEntity);
+  // save aStats as the statistics of anEntity (the caller re-saves anEntity
+  // when its stats block changes)
+  StatusResult setStatistics(Entity &anEntity,
+                             std::unique_ptr<TableStats> aStats);
+  StatusResult dropStatistics(const Entity &anEntity);
+
+  // zone map of a table, kept in memory: started empty by CREATE TABLE or
+  // filled by the first full scan, then widened by inserts and updates;
+  // nullptr while unknown (or when Config::zoneBlocks is 0)
+  ZoneMap *getZoneMap(const std::string &aTableName);
+  // a new, empty zone map for aTableName (the caller adds every row)
+  ZoneMap *resetZoneMap(const std::string &aTableName);
+  void dropZoneMap(const std::string &aTableName);
+
+  // workload seen by selects and joins, for SHOW INDEX ADVICE
+  IndexAdvisor &getAdvisor();
+  // true if an index of aTableName has aFields as its leading columns
+  bool isIndexed(const std::string &aTableName, const StringList &aFields);
 
   // DB level dump info for debug
   StatusResult dump(std::ostream &anOutput);
-  StatusResult selectRow(const DBQuery &aQuery, RowCollection &aCollection);
+  // the operator tree answering aQuery (see QueryOperators.hpp); with
+  // anIndexOnly the rows only need the columns aQuery reads, so a covering
+  // index can answer without reading data blocks and rows are trimmed to
+  // the select list (select, not update/delete)
+  StatusResult makePlan(const DBQuery &aQuery, OperatorPtr &aPlan,
+                        bool anIndexOnly = false);
+  // the rows of makePlan, collected
+  StatusResult selectRow(const DBQuery &aQuery, RowCollection &aCollection,
+                         bool anIndexOnly = false);
   StatusResult updateRow(const DBQuery &aQuery, RowCollection &aCollection);
   StatusResult deleteRow(const DBQuery &aQuery, RowCollection &aCollection);
 
@@ -61,38 +113,57 @@ class Database {
   Storage storage;   // storage interface to save and load block
   Index entityIndex;
   IndexMap indexMap;
+  std::list<std::string> loadedIndexes;  // most recently used first
+  std::map<std::string, std::unique_ptr<TableStats>> statistics;
+  std::map<std::string, ZoneMap> zoneMaps;
+  IndexAdvisor advisor;
   std::string debugInfo;  // debug message
 
-  StatusResult getAllRowsFrom(const std::string &aTableName,
-                              RowCollection &aCollection);
-  StatusResult joinRows(const JoinList &aJoinList, RowCollection &aCollection);
+  // unload least recently used indexes (not of aTableName) over the limit
+  void evictColdIndexes(const std::string &aTableName);
+  // scan of aQuery's table that skips the zones the where clause rules out
+  OperatorPtr makeZoneScan(const DBQuery &aQuery);
+  // keeps the blocks of the zones the where clause may match; nullptr if
+  // the zones can't narrow it
+  BlockFilter makeZoneFilter(const DBQuery &aQuery, ZoneMap &aZoneMap);
+  // scan and where clause of aQuery on worker threads (see
+  // ParallelScanOperator); nullptr if the table is too small for it
+  OperatorPtr makeParallelScan(const DBQuery &aQuery,
+                               FilterOperator::Observer anObserver);
+  // vectorized where clause over the rows of aSource (see BatchOperators)
+  OperatorPtr makeBatchFilter(const DBQuery &aQuery, OperatorPtr aSource,
+                              bool anIndexOnly,
+                              FilterOperator::Observer anObserver);
+  // blocks of candidate rows if an index can answer the where clause
+  std::optional<BlockList> getBlocksByAccessPath(const DBQuery &aQuery);
+  // an index whose entries hold every column aQuery reads (select list,
+  // where clause, order by); aLow / aHigh bound its keys by the where clause
+  // on its leading column. nullptr if none covers the query
+  Index *getCoveringIndex(const DBQuery &aQuery, IndexKeyOpt &aLow,
+                          IndexKeyOpt &aHigh);
+  // the where clause over the table's bitmap and fulltext indexes (any
+  // AND/OR/NOT mix); nullopt if they can't narrow it
+  std::optional<BlockList> getBlocksByBitmaps(const DBQuery &aQuery);
+  void recordJoinKeys(const Join &aJoin, double aSeconds);
+  // rows of aTableName, as far as its primary index knows
+  size_t estimateRows(const std::string &aTableName);
+  // map key of an index of aTableName whose entries run in aField order
+  // (aField is its leading column); nullopt if none
+  std::optional<std::string> getOrderedIndex(const std::string &aTableName,
+                                             const std::string &aField);
+  // merge join of aLeft (the rows of aQuery's table) with aJoin's table,
+  // reading a side in index order if it can, sorting it otherwise; nullptr
+  // if a hash join should do it instead
+  OperatorPtr makeMergeJoin(const DBQuery &aQuery, const Join &aJoin,
+                            OperatorPtr &aLeft, bool isLeftScan,
+                            const JoinOperator::Observer &anObserver);
+  // index nested loop join of aLeft with aJoin's table when aLeftRows (the
+  // left side's size, if known) is small next to that table and an index
+  // leads with one of its join columns; nullptr otherwise
+  OperatorPtr makeIndexJoin(const Join &aJoin, OperatorPtr &aLeft,
+                            std::optional<size_t> aLeftRows,
+                            const JoinOperator::Observer &anObserver);
 };
 
-// Free Functions
-StatusResult leftJoinRows(const Join &aJoin,
-                          const RowCollection &aLHSCollection,
-                          const RowCollection &aRHSCollection,
-                          RowCollection &aJoinedCollection);
-
-StatusResult rightJoinRows(const Join &aJoin,
-                           const RowCollection &aLHSCollection,
-                           const RowCollection &aRHSCollection,
-                           RowCollection &aJoinedCollection);
-
-StatusResult innerJoinRows(const Join &aJoin,
-                           const RowCollection &aLHSCollection,
-                           const RowCollection &aRHSCollection,
-                           RowCollection &aJoinedCollection);
-
-StatusResult crossJoinRows(const Join &aJoin,
-                           const RowCollection &aLHSCollection,
-                           const RowCollection &aRHSCollection,
-                           RowCollection &aJoinedCollection);
-
-StatusResult fullJoinRows(const Join &aJoin,
-                          const RowCollection &aLHSCollection,
-                          const RowCollection &aRHSCollection,
-                          RowCollection &aJoinedCollection);
-
 }  // namespace ECE141
 #endif /* Database_hpp */
@@ -29,11 +29,21 @@ Entity &Entity::setName(std::string &aName) {
   return *this;
 }
 
+Entity &Entity::setStatsBlockNum(uint32_t aBlockNum) {
+  statsBlockNum = aBlockNum;
+  return *this;
+}
+
 // ---------------------------------------------
 // Storable interface
+// version 2 added statsBlockNum
+static constexpr uint32_t kEntityVersion{2};
+
 StatusResult Entity::encode(std::ostream &anOutput) const {
+  Helpers::encodeVersion(anOutput, kEntityVersion);
   Helpers::encodeInto(anOutput, name);
   Helpers::encodeInto(anOutput, autoincr);
+  Helpers::encodeInto(anOutput, statsBlockNum);
   for (const auto &attr : attributes) {
     attr.encode(anOutput);
   }
@@ -42,8 +52,13 @@ StatusResult Entity::encode(std::ostream &anOutput) const {
 
 StatusResult Entity::decode(std::istream &anInput) {
   if (!(anInput >> std::ws).eof()) {
+    uint32_t theVersion = Helpers::decodeVersion(anInput);
     Helpers::decodeFrom(anInput, name);
     Helpers::decodeFrom(anInput, autoincr);
+    statsBlockNum = 0;  // no stats before version 2
+    if (theVersion >= 2) {
+      Helpers::decodeFrom(anInput, statsBlockNum);
+    }
     while (!(anInput >> std::ws).eof() && '\0' != anInput.peek()) {
       Attribute theAttr;
       theAttr.decode(anInput);
@@ -12,6 +12,7 @@
 #ifndef Entity_hpp
 #define Entity_hpp
 
+#include <cstdint>
 #include <iosfwd>
 #include <optional>
 #include <string>
@@ -42,6 +43,9 @@ class Entity : Storable {
   [[nodiscard]] const Attribute* getPrimaryKey() const;
   Entity& addAttribute(const Attribute& anAttribute);
   [[nodiscard]] int getAutoIncrID() { return autoincr++; }
+  // meta block holding the table's ANALYZE statistics (0 = not analyzed)
+  [[nodiscard]] uint32_t getStatsBlockNum() const { return statsBlockNum; }
+  Entity& setStatsBlockNum(uint32_t aBlockNum);
 
   // ---------------------------------------------
   // Storable interface
@@ -52,6 +56,7 @@ class Entity : Storable {
  protected:
   std::string name;
   int autoincr{1};  // start from 1
+  uint32_t statsBlockNum{0};
   AttributeList attributes;
 };
 
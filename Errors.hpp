@@ -78,6 +78,7 @@ enum class Errors {
   indexExists = 600,
   cantCreateIndex = 605,
   unknownIndex = 610,
+  uniqueViolation = 615,  // duplicate key for a primary/unique index
 
   // command related...
   unknownCommand = 3000,
@@ -0,0 +1,198 @@
+/**
+ * @file ExternalSorter.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "ExternalSorter.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace ECE141 {
+
+ExternalSorter::ExternalSorter(size_t aRunLimit)
+    : runLimit{std::max<size_t>(aRunLimit, 1)} {}
+
+ExternalSorter::~ExternalSorter() {
+  spilling.wait();
+  for (auto *theRun : runs) {
+    std::fclose(theRun);  // tmpfile() runs are removed on close
+  }
+}
+
+StatusResult ExternalSorter::add(IndexKey aKey, uint32_t aValue) {
+  buffer.emplace_back(std::move(aKey), aValue);
+  size++;
+  if (buffer.size() >= runLimit) {
+    return spill();
+  }
+  return {Errors::noError};
+}
+
+StatusResult ExternalSorter::flush() {
+  if (!buffer.empty()) {
+    spill();
+  }
+  spilling.wait();
+  return failed ? Errors::writeError : Errors::noError;
+}
+
+StatusResult ExternalSorter::merge(ExternalSorter &aSorter) {
+  spilling.wait();
+  aSorter.spilling.wait();
+  if (aSorter.failed) {
+    failed = true;
+  }
+  runs.insert(runs.end(), aSorter.runs.begin(), aSorter.runs.end());
+  size += aSorter.size - aSorter.buffer.size();
+  StatusResult theResult{failed ? Errors::writeError : Errors::noError};
+  for (auto &theEntry : aSorter.buffer) {
+    if (theResult) {
+      theResult = add(std::move(theEntry.first), theEntry.second);
+    }
+  }
+  aSorter.runs.clear();
+  aSorter.buffer.clear();
+  aSorter.size = 0;
+  return theResult;
+}
+
+size_t ExternalSorter::getSize() const { return size; }
+size_t ExternalSorter::getRunCount() const { return runs.size(); }
+
+StatusResult ExternalSorter::spill() {
+  spilling.wait();  // the previous run's buffer is free again
+  if (failed) {
+    return {Errors::writeError};
+  }
+  std::FILE *theRun = std::tmpfile();
+  if (nullptr == theRun) {
+    failed = true;
+    return {Errors::writeError};
+  }
+  runs.push_back(theRun);
+  spillBuffer.swap(buffer);
+  spilling.run([this, theRun] {
+    std::sort(spillBuffer.begin(), spillBuffer.end());
+    for (const auto &theEntry : spillBuffer) {
+      writeEntry(theRun, theEntry);
+    }
+    if (0 != std::fflush(theRun) || 0 != std::ferror(theRun)) {
+      failed = true;
+    }
+    spillBuffer.clear();
+  });
+  return {Errors::noError};
+}
+
+// run record: tag ('I' | 'S'), key (uint32 | length + bytes), value
+void ExternalSorter::writeEntry(std::FILE *aFile, const IndexEntry &anEntry) {
+  if (const auto *theInt = std::get_if<uint32_t>(&anEntry.first)) {
+    std::fputc('I', aFile);
+    std::fwrite(theInt, sizeof(*theInt), 1, aFile);
+  } else {
+    const auto &theStr = std::get<std::string>(anEntry.first);
+    auto theLength = static_cast<uint32_t>(theStr.size());
+    std::fputc('S', aFile);
+    std::fwrite(&theLength, sizeof(theLength), 1, aFile);
+    std::fwrite(theStr.data(), 1, theLength, aFile);
+  }
+  std::fwrite(&anEntry.second, sizeof(anEntry.second), 1, aFile);
+}
+
+bool ExternalSorter::readEntry(std::FILE *aFile, IndexEntry &anEntry) {
+  int theTag = std::fgetc(aFile);
+  if ('I' == theTag) {
+    uint32_t theInt{0};
+    if (1 != std::fread(&theInt, sizeof(theInt), 1, aFile)) {
+      return false;
+    }
+    anEntry.first = theInt;
+  } else if ('S' == theTag) {
+    uint32_t theLength{0};
+    if (1 != std::fread(&theLength, sizeof(theLength), 1, aFile)) {
+      return false;
+    }
+    std::string theStr(theLength, '\0');
+    if (theLength != std::fread(theStr.data(), 1, theLength, aFile)) {
+      return false;
+    }
+    anEntry.first = std::move(theStr);
+  } else {
+    return false;
+  }
+  return 1 == std::fread(&anEntry.second, sizeof(anEntry.second), 1, aFile);
+}
+
+bool ExternalSorter::each(const IndexEntryVisitor &aVisitor) {
+  if (!rewind()) {
+    return false;
+  }
+  IndexEntry theEntry;
+  while (next(theEntry)) {
+    if (!aVisitor(theEntry)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+StatusResult ExternalSorter::rewind() {
+  spilling.wait();
+  heads = {};
+  position = 0;
+  if (failed) {
+    return {Errors::writeError};
+  }
+  if (runs.empty()) {
+    std::sort(buffer.begin(), buffer.end());
+    return {Errors::noError};
+  }
+  if (!buffer.empty()) {
+    spill();
+    spilling.wait();
+    if (failed) {
+      return {Errors::writeError};
+    }
+  }
+  for (size_t i = 0; i < runs.size(); i++) {
+    std::rewind(runs[i]);
+    IndexEntry theEntry;
+    if (readEntry(runs[i], theEntry)) {
+      heads.emplace(std::move(theEntry), i);
+    }
+  }
+  return {Errors::noError};
+}
+
+bool ExternalSorter::next(IndexEntry &anEntry) {
+  if (failed) {
+    return false;
+  }
+  if (runs.empty()) {
+    if (position >= buffer.size()) {
+      return false;
+    }
+    anEntry = buffer[position++];
+    return true;
+  }
+  if (heads.empty()) {
+    return false;
+  }
+  RunHead theHead = heads.top();
+  heads.pop();
+  anEntry = std::move(theHead.first);
+  IndexEntry theNext;
+  if (readEntry(runs[theHead.second], theNext)) {
+    heads.emplace(std::move(theNext), theHead.second);
+  }
+  return true;
+}
+
+}  // namespace ECE141
@@ -0,0 +1,93 @@
+/**
+ * @file ExternalSorter.hpp
+ * @author Yifan Wu
+ * @brief sort (index key, row blockNum) pairs that may not fit in memory
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef ExternalSorter_hpp
+#define ExternalSorter_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "Errors.hpp"
+#include "Index.hpp"
+#include "TaskScheduler.hpp"
+
+namespace ECE141 {
+
+using IndexEntry = std::pair<IndexKey, uint32_t>;
+using IndexEntryVisitor = std::function<bool(const IndexEntry &)>;
+
+// USE: add() entries in any order, then each() visits them sorted by key.
+//      At most aRunLimit entries are held in memory: a full buffer is sorted
+//      and spilled as a run to a temp file, and each() k-way merges the runs,
+//      so both passes over the data are sequential I/O. A spill runs as a
+//      TaskScheduler task while add() fills the next buffer. If a run cannot
+//      be written (no temp file, disk full) the sorter fails: add(), flush(),
+//      merge() and rewind() return writeError from then on, and next() has
+//      nothing, rather than a pass that silently skips entries.
+class ExternalSorter {
+ public:
+  explicit ExternalSorter(size_t aRunLimit);
+  ~ExternalSorter();
+
+  ExternalSorter(const ExternalSorter &) = delete;
+  ExternalSorter &operator=(const ExternalSorter &) = delete;
+
+  StatusResult add(IndexKey aKey, uint32_t aValue);
+  // sort the buffered entries into a run now, and wait for it
+  StatusResult flush();
+  // take over the entries of aSorter (its runs are merged by each())
+  StatusResult merge(ExternalSorter &aSorter);
+  // visit every entry in (key, value) order; false if aVisitor stopped it
+  // or the sorter failed
+  bool each(const IndexEntryVisitor &aVisitor);
+  // the same pass a pull at a time: rewind(), then next() until false
+  StatusResult rewind();
+  bool next(IndexEntry &anEntry);
+
+  [[nodiscard]] size_t getSize() const;
+  [[nodiscard]] size_t getRunCount() const;
+
+ protected:
+  // hand the buffer to a task that sorts it and writes it out as one run
+  StatusResult spill();
+
+  static void writeEntry(std::FILE *aFile, const IndexEntry &anEntry);
+  static bool readEntry(std::FILE *aFile, IndexEntry &anEntry);
+
+  // head entry of a run and the run it came from
+  using RunHead = std::pair<IndexEntry, size_t>;
+  struct RunHeadGreater {
+    bool operator()(const RunHead &aLHS, const RunHead &aRHS) const {
+      return aRHS < aLHS;
+    }
+  };
+
+  std::vector<IndexEntry> buffer;
+  std::vector<IndexEntry> spillBuffer;  // the run being written
+  TaskGroup spilling;                   // at most one spill at a time
+  std::vector<std::FILE *> runs;
+  size_t runLimit;
+  size_t size{0};
+  std::atomic<bool> failed{false};  // a run was not written
+  // pass state: min-heap of run heads, or the position in the sorted buffer
+  std::priority_queue<RunHead, std::vector<RunHead>, RunHeadGreater> heads;
+  size_t position{0};
+};
+
+}  // namespace ECE141
+
+#endif /* ExternalSorter_hpp */
@@ -15,7 +15,9 @@
 #include <deque>
 #include <iostream>
 #include <map>
+#include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -24,11 +26,10 @@
 #include "Errors.hpp"
 #include "Helpers.hpp"
 #include "ParseHelper.hpp"
+#include "TextSearch.hpp"
 
 namespace ECE141 {
 
-using Comparator = bool (*)(Value &aLHS, Value &aRHS);
-
 bool equals(Value &aLHS, Value &aRHS) {
   bool theResult = false;
 
@@ -65,11 +66,103 @@ bool greaterThan(Value &aLHS, Value &aRHS) { return !lessEquals(aLHS, aRHS); }
 
 bool greaterEquals(Value &aLHS, Value &aRHS) { return !lessThan(aLHS, aRHS); }
 
-static std::map<Operators, Comparator> comparators{
-    {Operators::equal_op, equals},   {Operators::notequal_op, notEquals},
-    {Operators::lt_op, lessThan},    {Operators::lte_op, lessEquals},
-    {Operators::gt_op, greaterThan}, {Operators::gte_op, greaterEquals},
-};
+// text operators only apply to strings; anything else never matches
+static bool isLike(const Value &aLHS, const Value &aRHS) {
+  auto *theText = std::get_if<std::string>(&aLHS);
+  auto *thePattern = std::get_if<std::string>(&aRHS);
+  return theText && thePattern && TextSearch::like(*theText, *thePattern);
+}
+
+static bool isNotLike(const Value &aLHS, const Value &aRHS) {
+  return std::holds_alternative<std::string>(aLHS) &&
+         std::holds_alternative<std::string>(aRHS) && !isLike(aLHS, aRHS);
+}
+
+static bool isMatch(const Value &aLHS, const Value &aRHS) {
+  auto *theText = std::get_if<std::string>(&aLHS);
+  auto *theQuery = std::get_if<std::string>(&aRHS);
+  return theText && theQuery && TextSearch::matchesAll(*theText, *theQuery);
+}
+
+static bool isNotMatch(const Value &aLHS, const Value &aRHS) {
+  return std::holds_alternative<std::string>(aLHS) &&
+         std::holds_alternative<std::string>(aRHS) && !isMatch(aLHS, aRHS);
+}
+
+static bool isNever(const Value &, const Value &) { return false; }
+
+// the comparisons above with the operator fixed at compile time
+template <Operators Op, typename L, typename R>
+static bool compareAs(const L &aLHS, const R &aRHS) {
+  if constexpr (Operators::equal_op == Op) {
+    return isEqual(aLHS, aRHS);
+  } else if constexpr (Operators::notequal_op == Op) {
+    return !isEqual(aLHS, aRHS);
+  } else if constexpr (Operators::lt_op == Op) {
+    return isLess(aLHS, aRHS);
+  } else if constexpr (Operators::lte_op == Op) {
+    return isLess(aLHS, aRHS) || isEqual(aLHS, aRHS);
+  } else if constexpr (Operators::gt_op == Op) {
+    return !(isLess(aLHS, aRHS) || isEqual(aLHS, aRHS));
+  } else {
+    return !isLess(aLHS, aRHS);
+  }
+}
+
+template <Operators Op>
+static bool compareValues(const Value &aLHS, const Value &aRHS) {
+  return std::visit(
+      [](const auto &aLeft, const auto &aRight) {
+        return compareAs<Op>(aLeft, aRight);
+      },
+      aLHS, aRHS);
+}
+
+// operands of the types expected (L, R) skip the variant dispatch
+template <Operators Op, typename L, typename R>
+static bool compareTyped(const Value &aLHS, const Value &aRHS) {
+  const L *theLHS = std::get_if<L>(&aLHS);
+  const R *theRHS = std::get_if<R>(&aRHS);
+  return (theLHS && theRHS) ? compareAs<Op>(*theLHS, *theRHS)
+                            : compareValues<Op>(aLHS, aRHS);
+}
+
+// a value of the type an operand holds: a field's attribute type, or the
+// constant itself; nullopt if a field's type is not one Value holds
+static std::optional<Value> typeOf(const Operand &anOperand) {
+  if (TokenType::identifier != anOperand.ttype) {
+    return anOperand.value;
+  }
+  switch (anOperand.dtype) {
+    case DataTypes::bool_type:
+      return Value{false};
+    case DataTypes::int_type:
+      return Value{0};
+    case DataTypes::float_type:
+      return Value{0.0};
+    case DataTypes::varchar_type:
+      return Value{std::string{}};
+    default:
+      return std::nullopt;
+  }
+}
+
+template <Operators Op>
+static auto pickTest(const Operand &aLHS, const Operand &aRHS)
+    -> bool (*)(const Value &, const Value &) {
+  std::optional<Value> theLHSType = typeOf(aLHS);
+  std::optional<Value> theRHSType = typeOf(aRHS);
+  if (!theLHSType || !theRHSType) {
+    return compareValues<Op>;
+  }
+  return std::visit(
+      [](const auto &aLeft, const auto &aRight) {
+        using L = std::decay_t<decltype(aLeft)>;
+        using R = std::decay_t<decltype(aRight)>;
+        return &compareTyped<Op, L, R>;
+      },
+      *theLHSType, *theRHSType);
+}
 
 // -----------------------------------------------------------------
 Operand::Operand(std::string aName, TokenType aType, Value &aValue, size_t anId)
@@ -85,70 +178,19 @@ Expression::Expression(Operand &aLHSOperand, Operators &anOp,
                        Operand &aRHSOperand, std::vector<Logical> &aLogOps)
     : lhs{aLHSOperand}, rhs{aRHSOperand}, op{anOp}, logics{aLogOps} {}
 bool Expression::operator()(const KeyValues &aMap) const {
-  Value theLHS{lhs.value};
-  Value theRHS{rhs.value};
-  Operators theOp{op};
-
-  if (TokenType::identifier == lhs.ttype) {
-    if (aMap.find(lhs.name) != aMap.end()) {
-      // std::cout << "lhs.name found: " << lhs.name << "\n";
-      theLHS = aMap.at(lhs.name);  // get row value
-    } else {
-      std::cerr << "lhs.name NOT FOUND:" << lhs.name << "\n";
-    }
-  }
-
-  if (TokenType::identifier == rhs.ttype) {
-    if (aMap.find(rhs.name) != aMap.end()) {
-      // std::cerr << "rhs.name found: " << rhs.name << "\n";
-      theRHS = aMap.at(rhs.name);  // get row value
-    } else {
-      std::cerr << "rhs.name NOT FOUND:" << rhs.name << "\n";
-    }
-  }
-
-  // If there are an odd number of NOTS, switch the operator to its inverse
-  if ((std::count(logics.begin(), logics.end(), Logical::not_op) % 2) != 0) {
-    theOp = Helpers::oppositeOpOf(theOp);
-  }
-
-  return (comparators.find(theOp) != comparators.end())
-             ? comparators[theOp](theLHS, theRHS)
-             : false;
+  return (*this)(aMap, aMap);
 }
 
 bool Expression::operator()(const KeyValues &aLHSMap,
                             const KeyValues &aRHSMap) const {
-  Value theLHS{lhs.value};
-  Value theRHS{rhs.value};
-  Operators theOp{op};
-
-  if (TokenType::identifier == lhs.ttype) {
-    if (aLHSMap.find(lhs.name) != aLHSMap.end()) {
-      // std::cout << "lhs.name found: " << lhs.name << "\n";
-      theLHS = aLHSMap.at(lhs.name);  // get row value
-    } else {
-      std::cerr << "lhs.name NOT FOUND:" << lhs.name << "\n";
-    }
-  }
-
-  if (TokenType::identifier == rhs.ttype) {
-    if (aRHSMap.find(rhs.name) != aRHSMap.end()) {
-      // std::cout << "rhs.name found: " << rhs.name << "\n";
-      theRHS = aRHSMap.at(rhs.name);  // get row value
-    } else {
-      std::cerr << "rhs.name NOT FOUND:" << rhs.name << "\n";
-    }
-  }
-
-  // If there are an odd number of NOTS, switch the operator to its inverse
-  if ((std::count(logics.begin(), logics.end(), Logical::not_op) % 2) != 0) {
-    theOp = Helpers::oppositeOpOf(theOp);
-  }
-
-  return (comparators.find(theOp) != comparators.end())
-             ? comparators[theOp](theLHS, theRHS)
-             : false;
+  CompiledFilter::Term theTerm{CompiledFilter::compile(*this)};
+  auto theValue = [](const KeyValues &aMap, const std::string &aField,
+                     const Value &aDefault) -> const Value & {
+    auto theIter = aField.empty() ? aMap.end() : aMap.find(aField);
+    return theIter != aMap.end() ? theIter->second : aDefault;
+  };
+  return theTerm.test(theValue(aLHSMap, theTerm.lhsField, theTerm.lhsValue),
+                      theValue(aRHSMap, theTerm.rhsField, theTerm.rhsValue));
 }
 
 std::ostream &operator<<(std::ostream &aStream,
@@ -181,116 +223,244 @@ std::ostream &operator<<(std::ostream &aStream,
 // Filters
 size_t Filters::getCount() const { return expressions.size(); }
 size_t Filters::getExpressionsNum() const { return expressions.size(); }
-const Expressions &Filters::getExpressions() { return expressions; }
+const Expressions &Filters::getExpressions() const { return expressions; }
 
 Filters &Filters::add(Expression *anExpression) {
   // std::cout << *anExpression;  // *uncomment for debug
   expressions.push_back(std::unique_ptr<Expression>(anExpression));
+  compiled = CompiledFilter{expressions};
   return *this;
 }
 
-bool Filters::matches(const KeyValues &aMap) const {
-  return matches(expressions, aMap);
+// a < b  <=>  b > a
+static Operators mirrorOpOf(Operators anOp) {
+  static std::map<Operators, Operators> theMirrors{
+      {Operators::lt_op, Operators::gt_op},
+      {Operators::lte_op, Operators::gte_op},
+      {Operators::gt_op, Operators::lt_op},
+      {Operators::gte_op, Operators::lte_op},
+  };
+  auto theIter = theMirrors.find(anOp);
+  return (theIter != theMirrors.end()) ? theIter->second : anOp;
 }
 
-// compare expressions to row; return true if matches
-bool Filters::matches(const Expressions &anExpressions, const KeyValues &aMap) {
-  std::deque<bool> theEvalResults;
-  std::deque<Logical> theAndOrOps;
+// the pattern or query is always on the right
+static bool isTextOp(Operators anOp) {
+  return Operators::like_op == anOp || Operators::notlike_op == anOp ||
+         Operators::match_op == anOp || Operators::notmatch_op == anOp;
+}
 
-  for (const auto &theExpr : anExpressions) {
-    if (1 == std::count(theExpr->logics.begin(), theExpr->logics.end(),
-                        Logical::and_op)) {
+// `field op constant` (or `constant op field`) with the NOTs folded into op;
+// false for any other shape
+static bool toPredicate(const Expression &anExpr, Predicate &aPredicate) {
+  const auto &theLogics = anExpr.logics;
+  Operators theOp{anExpr.op};
+  if ((std::count(theLogics.begin(), theLogics.end(), Logical::not_op) % 2) !=
+      0) {
+    theOp = Helpers::oppositeOpOf(theOp);
+  }
+  bool isLHSField = TokenType::identifier == anExpr.lhs.ttype;
+  bool isRHSField = TokenType::identifier == anExpr.rhs.ttype;
+  if (isLHSField && !isRHSField) {
+    aPredicate = {anExpr.lhs.name, theOp, anExpr.rhs.value};
+  } else if (isRHSField && !isLHSField && !isTextOp(theOp)) {
+    aPredicate = {anExpr.rhs.name, mirrorOpOf(theOp), anExpr.lhs.value};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool Filters::getConjuncts(PredicateList &aList) const {
+  for (const auto &theExpr : expressions) {
+    const auto &theLogics = theExpr->logics;
+    if (std::find(theLogics.begin(), theLogics.end(), Logical::or_op) !=
+        theLogics.end()) {
+      return false;
+    }
+    Predicate thePredicate;
+    if (toPredicate(*theExpr, thePredicate)) {
+      aList.push_back(std::move(thePredicate));
+    }
+  }
+  return true;
+}
+
+// same precedence as matches(): fold the ANDs, then the ORs
+std::optional<RoaringBitmap> Filters::evaluate(
+    const PredicateLookup &aLookup) const {
+  using RowSet = std::optional<RoaringBitmap>;
+  std::deque<RowSet> theSets;
+  std::deque<Logical> theAndOrOps;
+  for (const auto &theExpr : expressions) {
+    const auto &theLogics = theExpr->logics;
+    if (1 == std::count(theLogics.begin(), theLogics.end(), Logical::and_op)) {
       theAndOrOps.emplace_back(Logical::and_op);
-    } else if (1 == std::count(theExpr->logics.begin(), theExpr->logics.end(),
+    } else if (1 == std::count(theLogics.begin(), theLogics.end(),
                                Logical::or_op)) {
       theAndOrOps.emplace_back(Logical::or_op);
     }
-    theEvalResults.push_back((*theExpr)(aMap));
-
-    //    if(Logical::and_op == theExpr->logic) {
-    //        theRowResult = theRowResult && theAttrResult;
-    //    }
-    //    else if (Logical::or_op == theExpr->logic) {
-    //        theRowResult = theRowResult || theAttrResult;
-    //    }
-    //    else {
-    //        theRowResult = theAttrResult;
-    //    }
+    Predicate thePredicate;
+    theSets.push_back(toPredicate(*theExpr, thePredicate)
+                          ? aLookup(thePredicate)
+                          : std::nullopt);
+  }
+  if (theSets.size() != theAndOrOps.size() + 1) {
+    return std::nullopt;
   }
   for (size_t i{0}; i < theAndOrOps.size(); i++) {
     if (Logical::and_op == theAndOrOps[i]) {
-      bool theResult = theEvalResults[i] && theEvalResults[i + 1];
-      theEvalResults[i + 1] = theResult;
-      theEvalResults.erase(theEvalResults.begin() + i);
-      theAndOrOps.erase(theAndOrOps.begin() + i);
-      i--;  // so for loop doesn't iterate out of range
+      RowSet &theNext = theSets[i + 1];
+      if (!theNext) {
+        theNext = std::move(theSets[i]);  // all rows AND x = x
+      } else if (theSets[i]) {
+        *theNext &= *theSets[i];
+      }
+      theSets.erase(theSets.begin() + static_cast<long>(i));
+      theAndOrOps.erase(theAndOrOps.begin() + static_cast<long>(i));
+      i--;
     }
   }
   for (size_t i{0}; i < theAndOrOps.size(); i++) {
-    if (Logical::or_op == theAndOrOps[i]) {
-      bool theResult = theEvalResults[i] || theEvalResults[i + 1];
-      theEvalResults[i + 1] = theResult;
-      theEvalResults.erase(theEvalResults.begin() + i);
-      theAndOrOps.erase(theAndOrOps.begin() + i);
-      i--;  // so for loop doesn't iterate out of range
+    RowSet &theNext = theSets[i + 1];
+    if (!theSets[i]) {
+      theNext.reset();  // all rows OR x = all rows
+    } else if (theNext) {
+      *theNext |= *theSets[i];
     }
   }
-  if (theAndOrOps.empty() && 1 == theEvalResults.size()) {
-    return theEvalResults.front();
-  }
-  std::cerr << "Error with sizes" << '\n';
-  return false;
+  return theSets.back();
+}
+
+bool Filters::matches(const KeyValues &aMap) const { return compiled(aMap); }
+
+bool Filters::matches(const Expressions &anExpressions, const KeyValues &aMap) {
+  return CompiledFilter{anExpressions}(aMap);
 }
 
 bool Filters::matches(const Expressions &anExpressions,
                       const KeyValues &aLHSMap, const KeyValues &aRHSMap) {
-  std::deque<bool> theEvalResults;
-  std::deque<Logical> theAndOrOps;
+  return CompiledFilter{anExpressions}(aLHSMap, aRHSMap);
+}
 
+//--------------------------------------------------------------
+// CompiledFilter
+// the i-th AND/OR joins terms i and i+1, wherever it was written
+CompiledFilter::CompiledFilter(const Expressions &anExpressions) {
+  std::vector<Logical> theAndOrOps;
   for (const auto &theExpr : anExpressions) {
-    if (1 == std::count(theExpr->logics.begin(), theExpr->logics.end(),
-                        Logical::and_op)) {
-      theAndOrOps.emplace_back(Logical::and_op);
-    } else if (1 == std::count(theExpr->logics.begin(), theExpr->logics.end(),
+    const auto &theLogics = theExpr->logics;
+    if (1 == std::count(theLogics.begin(), theLogics.end(), Logical::and_op)) {
+      theAndOrOps.push_back(Logical::and_op);
+    } else if (1 == std::count(theLogics.begin(), theLogics.end(),
                                Logical::or_op)) {
-      theAndOrOps.emplace_back(Logical::or_op);
+      theAndOrOps.push_back(Logical::or_op);
     }
-    theEvalResults.push_back((*theExpr)(aLHSMap, aRHSMap));
-
-    //    if(Logical::and_op == theExpr->logic) {
-    //        theRowResult = theRowResult && theAttrResult;
-    //    }
-    //    else if (Logical::or_op == theExpr->logic) {
-    //        theRowResult = theRowResult || theAttrResult;
-    //    }
-    //    else {
-    //        theRowResult = theAttrResult;
-    //    }
+    terms.push_back(compile(*theExpr));
   }
-  for (size_t i{0}; i < theAndOrOps.size(); i++) {
-    if (Logical::and_op == theAndOrOps[i]) {
-      bool theResult = theEvalResults[i] && theEvalResults[i + 1];
-      theEvalResults[i + 1] = theResult;
-      theEvalResults.erase(theEvalResults.begin() + i);
-      theAndOrOps.erase(theAndOrOps.begin() + i);
-      i--;  // so for loop doesn't iterate out of range
-    }
+  valid = !terms.empty() && theAndOrOps.size() + 1 == terms.size();
+  for (size_t i{0}; valid && i < terms.size(); i++) {
+    terms[i].startsGroup = 0 == i || Logical::or_op == theAndOrOps[i - 1];
   }
-  for (size_t i{0}; i < theAndOrOps.size(); i++) {
-    if (Logical::or_op == theAndOrOps[i]) {
-      bool theResult = theEvalResults[i] || theEvalResults[i + 1];
-      theEvalResults[i + 1] = theResult;
-      theEvalResults.erase(theEvalResults.begin() + i);
-      theAndOrOps.erase(theAndOrOps.begin() + i);
-      i--;  // so for loop doesn't iterate out of range
-    }
+}
+
+CompiledFilter::Term CompiledFilter::compile(const Expression &anExpression) {
+  const Operand &theLHS = anExpression.lhs;
+  const Operand &theRHS = anExpression.rhs;
+  Term theTerm{
+      TokenType::identifier == theLHS.ttype ? theLHS.name : std::string{},
+      TokenType::identifier == theRHS.ttype ? theRHS.name : std::string{},
+      theLHS.value,
+      theRHS.value,
+      isNever,
+      false};
+  const auto &theLogics = anExpression.logics;
+  Operators theOp{anExpression.op};
+  // If there are an odd number of NOTS, switch the operator to its inverse
+  if ((std::count(theLogics.begin(), theLogics.end(), Logical::not_op) % 2) !=
+      0) {
+    theOp = Helpers::oppositeOpOf(theOp);
   }
-  if (theAndOrOps.empty() && 1 == theEvalResults.size()) {
-    return theEvalResults.front();
+  switch (theOp) {
+    case Operators::equal_op:
+      theTerm.test = pickTest<Operators::equal_op>(theLHS, theRHS);
+      break;
+    case Operators::notequal_op:
+      theTerm.test = pickTest<Operators::notequal_op>(theLHS, theRHS);
+      break;
+    case Operators::lt_op:
+      theTerm.test = pickTest<Operators::lt_op>(theLHS, theRHS);
+      break;
+    case Operators::lte_op:
+      theTerm.test = pickTest<Operators::lte_op>(theLHS, theRHS);
+      break;
+    case Operators::gt_op:
+      theTerm.test = pickTest<Operators::gt_op>(theLHS, theRHS);
+      break;
+    case Operators::gte_op:
+      theTerm.test = pickTest<Operators::gte_op>(theLHS, theRHS);
+      break;
+    case Operators::like_op:
+      theTerm.test = isLike;
+      break;
+    case Operators::notlike_op:
+      theTerm.test = isNotLike;
+      break;
+    case Operators::match_op:
+      theTerm.test = isMatch;
+      break;
+    case Operators::notmatch_op:
+      theTerm.test = isNotMatch;
+      break;
+    default:
+      break;
   }
-  std::cerr << "Error with sizes" << '\n';
-  return false;
+  return theTerm;
+}
+
+bool CompiledFilter::operator()(const KeyValues &aMap) const {
+  return run(aMap, aMap);
+}
+
+bool CompiledFilter::operator()(const KeyValues &aLHSMap,
+                                const KeyValues &aRHSMap) const {
+  return run(aLHSMap, aRHSMap);
+}
+
+// a field the row lacks compares the operand's own value, as before
+static const Value &fieldOf(const KeyValues &aMap, const std::string &aField,
+                            const Value &aDefault, const char *aSide) {
+  if (aField.empty()) {
+    return aDefault;
+  }
+  auto theIter = aMap.find(aField);
+  if (theIter == aMap.end()) {
+    std::cerr << aSide << ".name NOT FOUND:" << aField << "\n";
+    return aDefault;
+  }
+  return theIter->second;
+}
+
+bool CompiledFilter::run(const KeyValues &aLHSMap,
+                         const KeyValues &aRHSMap) const {
+  if (!valid) {
+    std::cerr << "Error with sizes" << '\n';
+    return false;
+  }
+  bool theGroup{true};
+  for (const auto &theTerm : terms) {
+    if (theTerm.startsGroup && &theTerm != &terms.front()) {
+      if (theGroup) {
+        return true;
+      }
+      theGroup = true;
+    }
+    theGroup = theGroup &&
+               theTerm.test(
+                   fieldOf(aLHSMap, theTerm.lhsField, theTerm.lhsValue, "lhs"),
+                   fieldOf(aRHSMap, theTerm.rhsField, theTerm.rhsValue, "rhs"));
+  }
+  return theGroup;
 }
 
 // TODO: Add validation here...
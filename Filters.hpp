@@ -13,12 +13,15 @@
 #define Filters_h
 
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <iosfwd>
 
 #include "BasicTypes.hpp"
+#include "RoaringBitmap.hpp"
 #include "Tokenizer.hpp"
 #include "keywords.hpp"
 
@@ -39,8 +42,9 @@ class Operand {
   Operand() = default;
   Operand(std::string aName, TokenType aType, Value &aValue, size_t anId = 0);
 
-  TokenType ttype;  // is it a field, or const (#, string)...
-  DataTypes dtype;
+  // is it a field, or const (#, string)...
+  TokenType ttype{TokenType::unknown};
+  DataTypes dtype{DataTypes::no_type};
   std::string name;  // attr name
   Value value;
   size_t entityId{0};
@@ -66,6 +70,54 @@ struct Expression {
 
 using Expressions = std::vector<std::unique_ptr<Expression> >;
 
+// USE: a where clause (or join terms) compiled once: each term keeps its
+//      field names, its operator with the NOTs folded in and a comparison
+//      picked for the operand types, so testing a row only looks fields up
+//      and compares. Terms run as an OR of AND groups (AND binds tighter)
+//      and a group stops at its first false term, the clause at its first
+//      true group.
+class CompiledFilter {
+ public:
+  CompiledFilter() = default;
+  explicit CompiledFilter(const Expressions &anExpressions);
+
+  [[nodiscard]] bool operator()(const KeyValues &aMap) const;
+  [[nodiscard]] bool operator()(const KeyValues &aLHSMap,
+                                const KeyValues &aRHSMap) const;
+
+ protected:
+  using Test = bool (*)(const Value &aLHS, const Value &aRHS);
+
+  struct Term {
+    std::string lhsField;  // empty: lhsValue is a constant
+    std::string rhsField;
+    Value lhsValue;  // also the value of a field the row doesn't have
+    Value rhsValue;
+    Test test;
+    bool startsGroup;  // an OR before it (or the first term)
+  };
+
+  friend struct Expression;
+  static Term compile(const Expression &anExpression);
+  [[nodiscard]] bool run(const KeyValues &aLHSMap,
+                         const KeyValues &aRHSMap) const;
+
+  std::vector<Term> terms;
+  bool valid{false};  // one AND/OR between every two terms
+};
+
+// USE: a `field op constant` term of a where clause (NOTs folded into op);
+//      lets the database pick an index access path
+struct Predicate {
+  std::string field;
+  Operators op;
+  Value value;
+};
+using PredicateList = std::vector<Predicate>;
+// rows that may satisfy a term, or nullopt if unknown (all rows)
+using PredicateLookup =
+    std::function<std::optional<RoaringBitmap>(const Predicate &)>;
+
 //---------------------------------------------------
 
 class Filters {
@@ -76,7 +128,14 @@ class Filters {
 
   [[nodiscard]] size_t getCount() const;
   [[nodiscard]] size_t getExpressionsNum() const;
-  const Expressions &getExpressions();
+  [[nodiscard]] const Expressions &getExpressions() const;
+
+  // false if the where clause is not a plain conjunction (has OR)
+  bool getConjuncts(PredicateList &aList) const;
+  // the where clause over row sets: terms become aLookup's sets and AND/OR
+  // become intersection/union; nullopt if no narrower than all rows
+  [[nodiscard]] std::optional<RoaringBitmap> evaluate(
+      const PredicateLookup &aLookup) const;
 
   [[nodiscard]] bool matches(const KeyValues &aMap) const;
   static bool matches(const Expressions &anExpressions, const KeyValues &aMap);
@@ -88,6 +147,7 @@ class Filters {
 
  protected:
   Expressions expressions;
+  CompiledFilter compiled;  // of expressions, redone by add()
 };
 
 }  // namespace ECE141
@@ -0,0 +1,180 @@
+/**
+ * @file FrontCodedKeys.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "FrontCodedKeys.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Errors.hpp"
+#include "Helpers.hpp"
+
+namespace ECE141 {
+
+// 7 bits per byte, high bit set on all but the last byte
+static void appendVarint(std::string &aBytes, size_t aValue) {
+  while (aValue >= 0x80) {
+    aBytes += static_cast<char>((aValue & 0x7F) | 0x80);
+    aValue >>= 7;
+  }
+  aBytes += static_cast<char>(aValue);
+}
+
+static size_t readVarint(const std::string &aBytes, size_t &aPos) {
+  size_t theValue{0};
+  for (int theShift{0}; aPos < aBytes.size(); theShift += 7) {
+    auto theByte = static_cast<uint8_t>(aBytes[aPos++]);
+    theValue |= static_cast<size_t>(theByte & 0x7F) << theShift;
+    if (0 == (theByte & 0x80)) {
+      break;
+    }
+  }
+  return theValue;
+}
+
+static void appendFixed32(std::string &aBytes, uint32_t aValue) {
+  for (int i = 0; i < 4; i++) {
+    aBytes += static_cast<char>((aValue >> (8 * i)) & 0xFF);
+  }
+}
+
+static uint32_t readFixed32(const std::string &aBytes, size_t aPos) {
+  uint32_t theValue{0};
+  for (int i = 0; i < 4; i++) {
+    theValue |= static_cast<uint32_t>(static_cast<uint8_t>(aBytes[aPos + i]))
+                << (8 * i);
+  }
+  return theValue;
+}
+
+FrontCodedKeys &FrontCodedKeys::add(const std::string &aKey) {
+  size_t theShared{0};
+  if (0 == count % kRestartInterval) {
+    restarts.push_back(static_cast<uint32_t>(entries.size()));
+  } else {
+    size_t theMax = std::min(last.size(), aKey.size());
+    while (theShared < theMax && last[theShared] == aKey[theShared]) {
+      theShared++;
+    }
+  }
+  appendVarint(entries, theShared);
+  appendVarint(entries, aKey.size() - theShared);
+  entries.append(aKey, theShared, std::string::npos);
+  last = aKey;
+  count++;
+  return *this;
+}
+
+size_t FrontCodedKeys::size() const { return count; }
+
+size_t FrontCodedKeys::getByteSize() const {
+  return entries.size() + 4 * (restarts.size() + 1);
+}
+
+size_t FrontCodedKeys::next(size_t aPos, std::string &aKey) const {
+  size_t theShared = readVarint(entries, aPos);
+  size_t theLength = readVarint(entries, aPos);
+  aKey.resize(std::min(theShared, aKey.size()));
+  aKey.append(entries, aPos, theLength);
+  return aPos + theLength;
+}
+
+std::optional<size_t> FrontCodedKeys::find(const std::string &aKey) const {
+  // last restart whose (whole) key is <= aKey
+  size_t theLow{0};
+  size_t theHigh{restarts.size()};
+  while (theLow < theHigh) {
+    size_t theMid = theLow + (theHigh - theLow) / 2;
+    std::string theKey;
+    next(restarts[theMid], theKey);
+    if (theKey <= aKey) {
+      theLow = theMid + 1;
+    } else {
+      theHigh = theMid;
+    }
+  }
+  if (0 == theLow) {
+    return std::nullopt;
+  }
+  size_t theIndex = (theLow - 1) * kRestartInterval;
+  size_t thePos = restarts[theLow - 1];
+  std::string theKey;
+  for (size_t i = 0; i < kRestartInterval && theIndex < count;
+       i++, theIndex++) {
+    thePos = next(thePos, theKey);
+    if (theKey == aKey) {
+      return theIndex;
+    }
+    if (aKey < theKey) {
+      break;
+    }
+  }
+  return std::nullopt;
+}
+
+bool FrontCodedKeys::each(
+    const std::function<bool(const std::string &, size_t)> &aVisitor) const {
+  std::string theKey;
+  size_t thePos{0};
+  for (size_t i = 0; i < count; i++) {
+    thePos = next(thePos, theKey);
+    if (!aVisitor(theKey, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// count, page size, then the page: entries + restart offsets + restart count
+StatusResult FrontCodedKeys::encode(std::ostream &anOutput) const {
+  std::string thePage{entries};
+  for (uint32_t theRestart : restarts) {
+    appendFixed32(thePage, theRestart);
+  }
+  appendFixed32(thePage, static_cast<uint32_t>(restarts.size()));
+  Helpers::encodeInto(anOutput, count);
+  Helpers::encodeInto(anOutput, thePage.size());
+  anOutput.write(thePage.data(), static_cast<std::streamsize>(thePage.size()));
+  return {Errors::noError};
+}
+
+StatusResult FrontCodedKeys::decode(std::istream &anInput) {
+  size_t thePageSize{0};
+  Helpers::decodeFrom(anInput, count);
+  if (!Helpers::decodeFrom(anInput, thePageSize) || thePageSize < 4) {
+    return {Errors::readError};
+  }
+  anInput.get();  // separator after the size
+  std::string thePage(thePageSize, '\0');
+  if (!anInput.read(thePage.data(), static_cast<std::streamsize>(thePageSize))) {
+    return {Errors::readError};
+  }
+  uint32_t theRestarts = readFixed32(thePage, thePageSize - 4);
+  if (4 * (static_cast<size_t>(theRestarts) + 1) > thePageSize) {
+    return {Errors::readError};
+  }
+  size_t theTrailer = thePageSize - 4 * (static_cast<size_t>(theRestarts) + 1);
+  restarts.resize(theRestarts);
+  for (uint32_t i = 0; i < theRestarts; i++) {
+    restarts[i] = readFixed32(thePage, theTrailer + 4 * i);
+  }
+  entries = thePage.substr(0, theTrailer);
+  last.clear();
+  if (count > 0) {
+    each([&](const std::string &aKey, size_t) {
+      last = aKey;
+      return true;
+    });
+  }
+  return {Errors::noError};
+}
+
+}  // namespace ECE141
@@ -0,0 +1,65 @@
+/**
+ * @file FrontCodedKeys.hpp
+ * @author Yifan Wu
+ * @brief sorted string keys stored as shared prefix + suffix (front coding)
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef FrontCodedKeys_hpp
+#define FrontCodedKeys_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ECE141 {
+
+class StatusResult;
+
+// USE: each key is stored as (length shared with the previous key, suffix
+//      length, suffix bytes), so keys with long common prefixes (emails,
+//      URLs, composite keys) shrink to their tails. Every kRestartInterval-th
+//      key is stored whole; the offsets of these restart points trail the
+//      page, so a lookup binary searches them and decodes one short run.
+//      Lengths are explicit, so keys may hold any bytes (spaces, '\0').
+class FrontCodedKeys {
+ public:
+  static constexpr size_t kRestartInterval{16};
+
+  // keys must be added in ascending order
+  FrontCodedKeys &add(const std::string &aKey);
+
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] size_t getByteSize() const;  // page image incl. restarts
+
+  // position of aKey in the page, if present
+  [[nodiscard]] std::optional<size_t> find(const std::string &aKey) const;
+  // visit (key, position) in order; stops when aVisitor returns false
+  bool each(
+      const std::function<bool(const std::string &, size_t)> &aVisitor) const;
+
+  StatusResult encode(std::ostream &anOutput) const;
+  StatusResult decode(std::istream &anInput);
+
+ protected:
+  // decode the entry at aPos on top of aKey (the previous key); returns the
+  // position of the next entry
+  size_t next(size_t aPos, std::string &aKey) const;
+
+  std::string entries;
+  std::vector<uint32_t> restarts;  // offsets into entries of whole keys
+  std::string last;
+  size_t count{0};
+};
+
+}  // namespace ECE141
+
+#endif /* FrontCodedKeys_hpp */
@@ -0,0 +1,110 @@
+/**
+ * @file GroupVarint.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "GroupVarint.hpp"
+
+#include <algorithm>
+
+namespace ECE141 {
+
+static size_t byteLength(uint32_t aValue) {
+  return aValue < (1u << 8)    ? 1
+         : aValue < (1u << 16) ? 2
+         : aValue < (1u << 24) ? 3
+                               : 4;
+}
+
+void GroupVarint::append(std::string &aBytes,
+                         const std::vector<uint32_t> &aValues) {
+  for (size_t theStart = 0; theStart < aValues.size(); theStart += 4) {
+    size_t theTagPos = aBytes.size();
+    aBytes += '\0';
+    uint8_t theTag{0};
+    size_t theEnd = std::min(theStart + 4, aValues.size());
+    for (size_t i = theStart; i < theEnd; i++) {
+      size_t theLength = byteLength(aValues[i]);
+      theTag |= static_cast<uint8_t>((theLength - 1) << (2 * (i - theStart)));
+      for (size_t b = 0; b < theLength; b++) {
+        aBytes += static_cast<char>((aValues[i] >> (8 * b)) & 0xFF);
+      }
+    }
+    aBytes[theTagPos] = static_cast<char>(theTag);
+  }
+}
+
+bool GroupVarint::read(const std::string &aBytes, size_t &aPos, size_t aCount,
+                       std::vector<uint32_t> &aValues) {
+  aValues.resize(aCount);
+  const auto *theBytes = reinterpret_cast<const uint8_t *>(aBytes.data());
+  for (size_t theStart = 0; theStart < aCount; theStart += 4) {
+    if (aPos >= aBytes.size()) {
+      return false;
+    }
+    uint8_t theTag = theBytes[aPos++];
+    size_t theEnd = std::min(theStart + 4, aCount);
+    for (size_t i = theStart; i < theEnd; i++) {
+      size_t theLength = ((theTag >> (2 * (i - theStart))) & 0x3) + 1;
+      if (aPos + theLength > aBytes.size()) {
+        return false;
+      }
+      uint32_t theValue{0};
+      for (size_t b = 0; b < theLength; b++) {
+        theValue |= static_cast<uint32_t>(theBytes[aPos + b]) << (8 * b);
+      }
+      aValues[i] = theValue;
+      aPos += theLength;
+    }
+  }
+  return true;
+}
+
+std::vector<uint32_t> GroupVarint::toDeltas(
+    const std::vector<uint32_t> &aValues) {
+  std::vector<uint32_t> theDeltas(aValues.size());
+  uint32_t thePrev{0};
+  for (size_t i = 0; i < aValues.size(); i++) {
+    theDeltas[i] = aValues[i] - thePrev;
+    thePrev = aValues[i];
+  }
+  return theDeltas;
+}
+
+void GroupVarint::fromDeltas(std::vector<uint32_t> &aValues) {
+  uint32_t thePrev{0};
+  for (auto &theValue : aValues) {
+    theValue += thePrev;
+    thePrev = theValue;
+  }
+}
+
+std::vector<uint32_t> GroupVarint::toZigzagDeltas(
+    const std::vector<uint32_t> &aValues) {
+  std::vector<uint32_t> theDeltas(aValues.size());
+  uint32_t thePrev{0};
+  for (size_t i = 0; i < aValues.size(); i++) {
+    auto theDelta = static_cast<int32_t>(aValues[i] - thePrev);
+    theDeltas[i] = (static_cast<uint32_t>(theDelta) << 1) ^
+                   static_cast<uint32_t>(theDelta >> 31);
+    thePrev = aValues[i];
+  }
+  return theDeltas;
+}
+
+void GroupVarint::fromZigzagDeltas(std::vector<uint32_t> &aValues) {
+  uint32_t thePrev{0};
+  for (auto &theValue : aValues) {
+    uint32_t theDelta = (theValue >> 1) ^ (0u - (theValue & 1));
+    theValue = thePrev + theDelta;
+    thePrev = theValue;
+  }
+}
+
+}  // namespace ECE141
@@ -0,0 +1,46 @@
+/**
+ * @file GroupVarint.hpp
+ * @author Yifan Wu
+ * @brief packs uint32_t runs four at a time behind one length byte
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef GroupVarint_hpp
+#define GroupVarint_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ECE141 {
+
+// USE: each group of four values starts with a tag byte holding their byte
+//      lengths (2 bits each, 1-4 bytes), followed by the values little
+//      endian. Decoding reads one tag and copies four values without a branch
+//      per byte. Sorted data is stored as deltas (small values, 1 byte each);
+//      unsorted data as zigzag deltas.
+class GroupVarint {
+ public:
+  static void append(std::string &aBytes, const std::vector<uint32_t> &aValues);
+  // read aCount values starting at aPos (moved past them); false if the
+  // bytes run out
+  static bool read(const std::string &aBytes, size_t &aPos, size_t aCount,
+                   std::vector<uint32_t> &aValues);
+
+  // ascending values <-> gaps from the previous one
+  static std::vector<uint32_t> toDeltas(const std::vector<uint32_t> &aValues);
+  static void fromDeltas(std::vector<uint32_t> &aValues);
+  // any order: zigzag encoded signed gaps, so a small step back stays small
+  static std::vector<uint32_t> toZigzagDeltas(
+      const std::vector<uint32_t> &aValues);
+  static void fromZigzagDeltas(std::vector<uint32_t> &aValues);
+};
+
+}  // namespace ECE141
+
+#endif /* GroupVarint_hpp */
@@ -75,6 +75,22 @@ static const std::map<Operators, std::string> ExpressionOpsToStr{
         Operators::notequal_op,
         "!=",
     },
+    {
+        Operators::like_op,
+        "like",
+    },
+    {
+        Operators::notlike_op,
+        "not like",
+    },
+    {
+        Operators::match_op,
+        "match",
+    },
+    {
+        Operators::notmatch_op,
+        "not match",
+    },
 };
 
 static const std::map<std::string, Operators> gExpressionOps{
@@ -103,6 +119,8 @@ static std::map<std::string, Operators> gOperators{
     std::make_pair("or", Operators::or_op),
     std::make_pair("nor", Operators::nor_op),
     std::make_pair("between", Operators::between_op),
+    std::make_pair("like", Operators::like_op),
+    std::make_pair("match", Operators::match_op),
 
     // custom ---------------------------------------------------------
     std::make_pair("!", Operators::not_op)};
@@ -121,14 +139,17 @@ static const std::map<std::string, int> gFunctions{
 // This map binds a keyword string with a Keyword (token)...
 static const std::map<std::string, Keywords> gDictionary{
     std::make_pair("add", Keywords::add_kw),
+    std::make_pair("advice", Keywords::advice_kw),
     std::make_pair("all", Keywords::all_kw),
     std::make_pair("alter", Keywords::alter_kw),
+    std::make_pair("analyze", Keywords::analyze_kw),
     std::make_pair("and", Keywords::and_kw),
     std::make_pair("as", Keywords::as_kw),
     std::make_pair("asc", Keywords::asc_kw),
     std::make_pair("avg", ECE141::Keywords::avg_kw),
     std::make_pair("auto_increment", Keywords::auto_increment_kw),
     std::make_pair("between", ECE141::Keywords::between_kw),
+    std::make_pair("bitmap", ECE141::Keywords::bitmap_kw),
     std::make_pair("boolean", ECE141::Keywords::boolean_kw),
     std::make_pair("by", ECE141::Keywords::by_kw),
     std::make_pair("change", ECE141::Keywords::change_kw),
@@ -159,9 +180,11 @@ static const std::map<std::string, Keywords> gDictionary{
     std::make_pair("foreign", ECE141::Keywords::foreign_kw),
     std::make_pair("from", ECE141::Keywords::from_kw),
     std::make_pair("full", ECE141::Keywords::full_kw),
+    std::make_pair("fulltext", ECE141::Keywords::fulltext_kw),
     std::make_pair("group", ECE141::Keywords::group_kw),
     std::make_pair("help", ECE141::Keywords::help_kw),
     std::make_pair("in", ECE141::Keywords::in_kw),
+    std::make_pair("include", ECE141::Keywords::include_kw),
     std::make_pair("index", ECE141::Keywords::index_kw),
     std::make_pair("indexes", ECE141::Keywords::indexes_kw),
     std::make_pair("inner", ECE141::Keywords::inner_kw),
@@ -175,6 +198,7 @@ static const std::map<std::string, Keywords> gDictionary{
     std::make_pair("left", ECE141::Keywords::left_kw),
     std::make_pair("like", ECE141::Keywords::like_kw),
     std::make_pair("limit", ECE141::Keywords::limit_kw),
+    std::make_pair("match", ECE141::Keywords::match_kw),
     std::make_pair("max", ECE141::Keywords::max_kw),
     std::make_pair("min", ECE141::Keywords::min_kw),
     std::make_pair("modify", ECE141::Keywords::modify_kw),
@@ -184,6 +208,7 @@ static const std::map<std::string, Keywords> gDictionary{
     std::make_pair("or", ECE141::Keywords::or_kw),
     std::make_pair("order", ECE141::Keywords::order_kw),
     std::make_pair("outer", ECE141::Keywords::outer_kw),
+    std::make_pair("parallel", ECE141::Keywords::parallel_kw),
     std::make_pair("primary", ECE141::Keywords::primary_kw),
     std::make_pair("query", ECE141::Keywords::query_kw),
     std::make_pair("quit", ECE141::Keywords::quit_kw),
@@ -205,10 +230,12 @@ static const std::map<std::string, Keywords> gDictionary{
     std::make_pair("varchar", ECE141::Keywords::varchar_kw),
     std::make_pair("version", ECE141::Keywords::version_kw),
     std::make_pair("where", ECE141::Keywords::where_kw),
+    std::make_pair("with", ECE141::Keywords::with_kw),
 
     // custom ---------------------------------------------------------
     std::make_pair("default", ECE141::Keywords::default_kw),
     std::make_pair("run", ECE141::Keywords::run_kw),
+    std::make_pair("workers", ECE141::Keywords::workers_kw),
 };
 
 static const std::map<Keywords, DataTypes> gKeywordTypes{
@@ -442,7 +469,11 @@ class Helpers {
         {Operators::lte_op, Operators::gt_op},
         {Operators::gte_op, Operators::lt_op},
         {Operators::equal_op, Operators::notequal_op},
-        {Operators::notequal_op, Operators::equal_op}};
+        {Operators::notequal_op, Operators::equal_op},
+        {Operators::like_op, Operators::notlike_op},
+        {Operators::notlike_op, Operators::like_op},
+        {Operators::match_op, Operators::notmatch_op},
+        {Operators::notmatch_op, Operators::match_op}};
 
     if (operatorInverses.find(anOp) != operatorInverses.end()) {
       return operatorInverses[anOp];
@@ -520,6 +551,24 @@ class Helpers {
     anInput >> anObj;
     return checkStreamNotFail(anInput);
   }
+
+  // on-disk layout version of a record: a leading "#<n>" token (names never
+  // start with '#'). Records written before versioning have none and are
+  // version 1; nothing is consumed then.
+  static StatusResult encodeVersion(std::ostream &anOutput,
+                                    uint32_t aVersion) {
+    anOutput << '#' << aVersion << ' ';
+    return {Errors::noError};
+  }
+
+  static uint32_t decodeVersion(std::istream &anInput) {
+    uint32_t theVersion{1};
+    if ('#' == (anInput >> std::ws).peek()) {
+      anInput.get();
+      anInput >> theVersion;
+    }
+    return theVersion;
+  }
 };
 }  // namespace ECE141
 
@@ -10,6 +10,7 @@
  */
 #include "Index.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include <optional>
@@ -17,6 +18,12 @@
 #include "Errors.hpp"
 #include "Helpers.hpp"
 #include "BlockIO.hpp"
+#include "Config.hpp"
+#include "ExternalSorter.hpp"
+#include "FrontCodedKeys.hpp"
+#include "GroupVarint.hpp"
+#include "KeyEncoder.hpp"
+#include "TextSearch.hpp"
 
 namespace ECE141 {
 
@@ -40,8 +47,17 @@ ValueProxy::operator IntOpt() const { return index.valueAt(key); }
 // Index interface
 Index::Index(Storage &aStorage, uint32_t aBlockNum, IndexType aType,
              const std::string &aName)
-    : storage{aStorage}, name{aName}, blockNum{aBlockNum}, type{aType} {
+    : storage{aStorage},
+      name{aName},
+      blockNum{aBlockNum},
+      type{aType},
+      unique{IndexType::compositeKey != aType &&
+             IndexType::bitmapKey != aType &&
+             IndexType::fulltextKey != aType} {
   entityId = ("Null" != name) ? Helpers::hashString(aName) : 0;
+  if ("Null" != name) {
+    fields.push_back(name);
+  }
 }
 
 ValueProxy Index::operator[](const std::string &aKey) {
@@ -66,42 +82,213 @@ Index &Index::setIndexBlockNum(uint32_t aBlockNum) {
 
 // add key / value
 bool Index::setKeyValue(const IndexKey &aKey, uint32_t aValue) {
-  data.emplace(aKey, aValue);
-  // data[aKey]=aValue;
-  return changed = true;  // side-effect intended!
+  if (IndexType::bitmapKey == type) {
+    const auto &theKey = std::get<std::string>(aKey);
+    RoaringBitmap &theBitmap =
+        bitmaps[theKey.substr(0, theKey.size() - sizeof(uint32_t))];
+    bool theAdded = !theBitmap.contains(aValue);
+    theBitmap.add(aValue);
+    changed |= theAdded;
+    return theAdded;
+  }
+  if (IndexType::fulltextKey == type) {
+    for (const auto &theWord : wordsOf(std::get<std::string>(aKey))) {
+      bitmaps[theWord].add(aValue);
+    }
+    changed = true;
+    return true;  // every row has its own key (block number suffix)
+  }
+  std::string theBytes;
+  bool theInserted = data.insert(bytesOf(aKey, theBytes), aValue);
+  if (theInserted) {
+    addToBloomFilter(aKey);
+  }
+  changed |= theInserted;
+  return theInserted;
+}
+
+StatusResult Index::bulkLoad(ExternalSorter &aSorter) {
+  bool theDuplicate{false};
+  bool theResult{true};
+  if (IndexType::bitmapKey == type || IndexType::fulltextKey == type) {
+    theResult = aSorter.each([&](const IndexEntry &anEntry) {
+      theDuplicate = !setKeyValue(anEntry.first, anEntry.second);
+      return !theDuplicate;
+    });
+  } else {
+    std::string theBytes;
+    theResult = aSorter.each([&](const IndexEntry &anEntry) {
+      if (!data.insert(bytesOf(anEntry.first, theBytes), anEntry.second)) {
+        theDuplicate = true;
+        return false;
+      }
+      addToBloomFilter(anEntry.first);
+      return true;
+    });
+  }
+  changed = true;
+  if (theResult) {
+    return {Errors::noError};
+  }
+  return {theDuplicate ? Errors::uniqueViolation : Errors::writeError};
+}
+
+void Index::addToBloomFilter(const IndexKey &aKey) {
+  if (!unique || !Config::useBloomFilter()) {
+    return;
+  }
+  if (!bloom || data.size() > bloom->getCapacity()) {
+    rebuildBloomFilter();  // grow (2x) so the false positive rate holds
+  } else {
+    bloom->insert(hashKey(aKey));
+  }
+}
+
+void Index::rebuildBloomFilter() {
+  bloom.emplace(2 * data.size(), Config::bloomBitsPerKey);
+  data.each([&](const std::string &aBytes, uint32_t) {
+    bloom->insert(hashKey(keyOf(aBytes)));
+    return true;
+  });
 }
 
 bool Index::isChanged() const { return changed; }
+bool Index::isLoaded() const { return loaded; }
+
+Index &Index::setLoaded(bool aLoaded) {
+  loaded = aLoaded;
+  return *this;
+}
+
+Index &Index::unload() {
+  data.clear();
+  bitmaps.clear();
+  bloom.reset();
+  loaded = false;
+  return *this;
+}
 
 uint32_t Index::getBlockNum() const { return blockNum; }
 std::string Index::getName() const { return name; }
 uint32_t Index::getEntityId() const { return entityId; }
-size_t Index::getSize() const { return data.size(); }
+size_t Index::getSize() const {
+  size_t theSize{data.size()};
+  for (const auto &[theValue, theBitmap] : bitmaps) {
+    theSize += theBitmap.cardinality();
+  }
+  return theSize;
+}
 IndexType Index::getType() const {return type;}
+const StringList &Index::getFields() const { return fields; }
+const StringList &Index::getIncluded() const { return included; }
+
+bool Index::hasField(const std::string &aField) const {
+  return std::find(fields.begin(), fields.end(), aField) != fields.end() ||
+         std::find(included.begin(), included.end(), aField) != included.end();
+}
 
 StorageInfo Index::getStorageInfo(size_t aSize,
                                   const std::string &aTableName) const {
+  // secondary indexes are already passed their "Table.indexName" map key
+  std::string theExtra = (std::string::npos == aTableName.find('.'))
+                             ? aTableName + '.' + name
+                             : aTableName;
   return {entityId, aSize, static_cast<int32_t>(blockNum),
-          BlockType::index_block, aTableName + '.' + name};
+          BlockType::index_block, theExtra};
 }
 
-bool Index::isEmpty() const { return data.empty(); }
+bool Index::isEmpty() const { return data.isEmpty() && bitmaps.empty(); }
+bool Index::isUnique() const { return unique; }
+bool Index::hasBloomFilter() const { return bloom.has_value(); }
+
+bool Index::hasNullField(const KeyValues &aRow) const {
+  return std::any_of(fields.begin(), fields.end(), [&](const auto &aField) {
+    return aRow.find(aField) == aRow.end();
+  });
+}
 
 // find value
 bool Index::exists(const IndexKey &aKey) const {
-  return data.find(aKey) != data.end();
+  if (bloom && !bloom->mayContain(hashKey(aKey))) {
+    return false;
+  }
+  if (IndexType::bitmapKey == type) {
+    const auto &theKey = std::get<std::string>(aKey);
+    auto theIter =
+        bitmaps.find(theKey.substr(0, theKey.size() - sizeof(uint32_t)));
+    return theIter != bitmaps.end() &&
+           theIter->second.contains(KeyEncoder::blockNumSuffix(theKey));
+  }
+  if (IndexType::fulltextKey == type) {
+    const auto &theKey = std::get<std::string>(aKey);
+    uint32_t theBlockNum = KeyEncoder::blockNumSuffix(theKey);
+    StringList theWords{wordsOf(theKey)};
+    return std::all_of(theWords.begin(), theWords.end(), [&](const auto &aWord) {
+      auto theIter = bitmaps.find(aWord);
+      return theIter != bitmaps.end() && theIter->second.contains(theBlockNum);
+    });
+  }
+  std::string theBytes;
+  return data.find(bytesOf(aKey, theBytes)).has_value();
+}
+
+bool Index::checkUnique(std::vector<IndexKey> &aKeys,
+                        const std::vector<IndexKey> &aReplaced) const {
+  if (!unique) {
+    return true;
+  }
+  // sorted: in-batch duplicates are adjacent, map probes walk forward
+  std::sort(aKeys.begin(), aKeys.end());
+  if (std::adjacent_find(aKeys.begin(), aKeys.end()) != aKeys.end()) {
+    return false;
+  }
+  return std::none_of(aKeys.begin(), aKeys.end(), [&](const IndexKey &aKey) {
+    return exists(aKey) && std::find(aReplaced.begin(), aReplaced.end(),
+                                     aKey) == aReplaced.end();
+  });
 }
 
 // get value
 IntOpt Index::valueAt(const IndexKey &aKey) const {
-  return exists(aKey) ? data.at(aKey) : (IntOpt)(std::nullopt);
+  if ((IndexType::bitmapKey == type || IndexType::fulltextKey == type) &&
+      exists(aKey)) {
+    return KeyEncoder::blockNumSuffix(std::get<std::string>(aKey));
+  }
+  if (bloom && !bloom->mayContain(hashKey(aKey))) {
+    return std::nullopt;
+  }
+  std::string theBytes;
+  return data.find(bytesOf(aKey, theBytes));
 }
 
 // remove key / value
 StatusResult Index::erase(const std::string &aKey) {
-  auto it = data.find(aKey);
-  if (it != data.end()) {
-    data.erase(it);
+  if (IndexType::bitmapKey == type) {
+    auto theIter = bitmaps.find(aKey.substr(0, aKey.size() - sizeof(uint32_t)));
+    if (theIter != bitmaps.end()) {
+      theIter->second.remove(KeyEncoder::blockNumSuffix(aKey));
+      if (theIter->second.isEmpty()) {
+        bitmaps.erase(theIter);
+      }
+      setChanged(true);
+    }
+    return {Errors::noError};
+  }
+  if (IndexType::fulltextKey == type) {
+    uint32_t theBlockNum = KeyEncoder::blockNumSuffix(aKey);
+    for (const auto &theWord : wordsOf(aKey)) {
+      auto theIter = bitmaps.find(theWord);
+      if (theIter != bitmaps.end()) {
+        theIter->second.remove(theBlockNum);
+        if (theIter->second.isEmpty()) {
+          bitmaps.erase(theIter);
+        }
+      }
+    }
+    setChanged(true);
+    return {Errors::noError};
+  }
+  if (data.erase(aKey)) {
     setChanged(true);
   } else {
     std::cerr << "Key: '" << aKey << "' NOT FOUND!\n";
@@ -110,9 +297,8 @@ StatusResult Index::erase(const std::string &aKey) {
 }
 
 StatusResult Index::erase(uint32_t aKey) {
-  auto it = data.find(aKey);
-  if (it != data.end()) {
-    data.erase(it);
+  std::string theBytes;
+  if (data.erase(bytesOf(aKey, theBytes))) {
     setChanged(true);
   } else {
     std::cerr << "Key: " << aKey << " NOT FOUND!\n";
@@ -120,16 +306,68 @@ StatusResult Index::erase(uint32_t aKey) {
   return {Errors::noError};
 }
 
+StatusResult Index::erase(const IndexKey &aKey) {
+  if (const auto *theInt = std::get_if<uint32_t>(&aKey)) {
+    return erase(*theInt);
+  }
+  return erase(std::get<std::string>(aKey));
+}
+
 // Storable interface --------------------------------
+// version 1 images have no version tag (see decodeVersion1)
+static constexpr uint32_t kIndexVersion{2};
+
 StatusResult Index::encode(std::ostream &anOutput) const {
+  Helpers::encodeVersion(anOutput, kIndexVersion);
   Helpers::encodeInto(anOutput, name);
   Helpers::encodeInto(anOutput, static_cast<char>(type));
   Helpers::encodeInto(anOutput, blockNum);
-  if (!data.empty()) {
-    for (const auto &[theIndexKey, theBlockNum] : data) {
-      encodeIndexKey(anOutput, theIndexKey, type);
-      Helpers::encodeInto(anOutput, static_cast<uint32_t>(theBlockNum));
-    }
+  Helpers::encodeInto(anOutput, unique);
+  Helpers::encodeInto(anOutput, fields.size());
+  for (const auto &theField : fields) {
+    Helpers::encodeInto(anOutput, theField);
+  }
+  Helpers::encodeInto(anOutput, included.size());
+  for (const auto &theField : included) {
+    Helpers::encodeInto(anOutput, theField);
+  }
+  Helpers::encodeInto(anOutput, bloom.has_value());
+  if (bloom) {
+    bloom->encode(anOutput);
+  }
+  if (IndexType::intKey == type) {
+    // count, page size, then the page: key gaps + block number zigzag gaps
+    std::vector<uint32_t> theKeys;
+    std::vector<uint32_t> theBlockNums;
+    data.each([&](const std::string &aBytes, uint32_t aBlockNum) {
+      theKeys.push_back(KeyEncoder::blockNumSuffix(aBytes));
+      theBlockNums.push_back(aBlockNum);
+      return true;
+    });
+    std::string thePage;
+    GroupVarint::append(thePage, GroupVarint::toDeltas(theKeys));
+    GroupVarint::append(thePage, GroupVarint::toZigzagDeltas(theBlockNums));
+    Helpers::encodeInto(anOutput, data.size());
+    Helpers::encodeInto(anOutput, thePage.size());
+    anOutput.write(thePage.data(), static_cast<std::streamsize>(thePage.size()));
+    return {Errors::noError};
+  }
+  // string keys: one front coded page, then each key's block / bitmap
+  FrontCodedKeys theKeys;
+  data.each([&](const std::string &aBytes, uint32_t) {
+    theKeys.add(aBytes);
+    return true;
+  });
+  for (const auto &[theValue, theBitmap] : bitmaps) {
+    theKeys.add(theValue);
+  }
+  theKeys.encode(anOutput);
+  data.each([&](const std::string &, uint32_t aBlockNum) {
+    Helpers::encodeInto(anOutput, aBlockNum);
+    return true;
+  });
+  for (const auto &[theValue, theBitmap] : bitmaps) {
+    theBitmap.encode(anOutput);
   }
   return {Errors::noError};
 }
@@ -137,7 +375,18 @@ StatusResult Index::encode(std::ostream &anOutput) const {
 StatusResult Index::decode(std::istream &anInput) {
   // Erases all elements from the map
   data.clear();
+  bitmaps.clear();
   if (!(anInput >> std::ws).eof()) {
+    uint32_t theVersion = Helpers::decodeVersion(anInput);
+    if (theVersion > kIndexVersion) {
+      return {Errors::readError};  // written by a newer build
+    }
+    if (theVersion < kIndexVersion) {
+      StatusResult theResult = decodeVersion1(anInput);
+      changed = false;
+      loaded = true;
+      return theResult;
+    }
     Helpers::decodeFrom(anInput, name);
     entityId = Helpers::hashString(name);
 
@@ -145,68 +394,472 @@ StatusResult Index::decode(std::istream &anInput) {
     Helpers::decodeFrom(anInput, theTypeIdx);
     type = static_cast<IndexType>(theTypeIdx);
     Helpers::decodeFrom(anInput, blockNum);
+    Helpers::decodeFrom(anInput, unique);
+    size_t theFieldCount{0};
+    Helpers::decodeFrom(anInput, theFieldCount);
+    fields.resize(theFieldCount);
+    for (auto &theField : fields) {
+      Helpers::decodeFrom(anInput, theField);
+    }
+    Helpers::decodeFrom(anInput, theFieldCount);
+    included.resize(theFieldCount);
+    for (auto &theField : included) {
+      Helpers::decodeFrom(anInput, theField);
+    }
+    bool theHasBloom{false};
+    Helpers::decodeFrom(anInput, theHasBloom);
+    bloom.reset();
+    if (theHasBloom && !bloom.emplace().decode(anInput)) {
+      bloom.reset();
+    }
 
-    while (!(anInput >> std::ws).eof() && '\0' != anInput.peek()) {
-      std::string theIndexKeyStr;
-      Helpers::decodeFrom(anInput, theIndexKeyStr);
-      uint32_t theBlockNum{0};
-      Helpers::decodeFrom(anInput, theBlockNum);
-      if (0 != theBlockNum) {
-        setKeyValue(toIndexKey(theIndexKeyStr, type), theBlockNum);
-      }
+    StatusResult theResult = (IndexType::intKey == type)
+                                 ? decodeIntKeys(anInput)
+                                 : decodeStringKeys(anInput);
+    if (!theResult) {
+      return theResult;
+    }
+    if (unique && Config::useBloomFilter() &&
+        (!bloom || data.size() > bloom->getCapacity())) {
+      rebuildBloomFilter();
+    }
+  }
+  changed = false;  // image on disk matches memory
+  loaded = true;
+  return {Errors::noError};
+}
+
+StatusResult Index::decodeVersion1(std::istream &anInput) {
+  Helpers::decodeFrom(anInput, name);
+  entityId = Helpers::hashString(name);
+  char theTypeIdx{0};
+  Helpers::decodeFrom(anInput, theTypeIdx);
+  type = static_cast<IndexType>(theTypeIdx);
+  if (!Helpers::decodeFrom(anInput, blockNum) ||
+      (IndexType::intKey != type && IndexType::strKey != type)) {
+    return {Errors::readError};
+  }
+  // named after the primary key; the meta index is "Null"
+  fields.clear();
+  if ("Null" != name) {
+    fields.push_back(name);
+  }
+  included.clear();
+  unique = true;
+  bloom.reset();
+  while (!(anInput >> std::ws).eof() && '\0' != anInput.peek()) {
+    std::string theKey;
+    uint32_t theBlockNum{0};
+    Helpers::decodeFrom(anInput, theKey);
+    if (!Helpers::decodeFrom(anInput, theBlockNum)) {
+      return {Errors::readError};
+    }
+    if (0 == theBlockNum) {
+      continue;
+    }
+    if (IndexType::strKey == type) {
+      setKeyValue(theKey, theBlockNum);
+    } else if (Helpers::isNumber<uint32_t>(theKey)) {
+      setKeyValue(static_cast<uint32_t>(std::stoul(theKey)), theBlockNum);
+    } else {
+      return {Errors::readError};
+    }
+  }
+  return {Errors::noError};
+}
+
+StatusResult Index::decodeIntKeys(std::istream &anInput) {
+  size_t theCount{0};
+  size_t thePageSize{0};
+  Helpers::decodeFrom(anInput, theCount);
+  if (!Helpers::decodeFrom(anInput, thePageSize)) {
+    return {Errors::readError};
+  }
+  anInput.get();  // separator after the size
+  std::string thePage(thePageSize, '\0');
+  std::vector<uint32_t> theKeys;
+  std::vector<uint32_t> theBlockNums;
+  size_t thePos{0};
+  if (!anInput.read(thePage.data(),
+                    static_cast<std::streamsize>(thePageSize)) ||
+      !GroupVarint::read(thePage, thePos, theCount, theKeys) ||
+      !GroupVarint::read(thePage, thePos, theCount, theBlockNums)) {
+    return {Errors::readError};
+  }
+  GroupVarint::fromDeltas(theKeys);
+  GroupVarint::fromZigzagDeltas(theBlockNums);
+  // the stored filter already covers these keys
+  for (size_t i = 0; i < theCount; i++) {
+    if (0 != theBlockNums[i]) {
+      std::string theBytes;
+      data.insert(KeyEncoder::appendBlockNum(theBytes, theKeys[i]),
+                  theBlockNums[i]);
     }
   }
   return {Errors::noError};
 }
+
+StatusResult Index::decodeStringKeys(std::istream &anInput) {
+  FrontCodedKeys theKeys;
+  StatusResult theResult = theKeys.decode(anInput);
+  if (!theResult) {
+    return theResult;
+  }
+  bool isBitmap{IndexType::bitmapKey == type ||
+                IndexType::fulltextKey == type};
+  theKeys.each([&](const std::string &aKey, size_t) {
+    if (isBitmap) {
+      theResult = bitmaps[aKey].decode(anInput);
+      return static_cast<bool>(theResult);
+    }
+    uint32_t theBlockNum{0};
+    if (!(theResult = Helpers::decodeFrom(anInput, theBlockNum))) {
+      return false;
+    }
+    if (0 != theBlockNum) {
+      data.insert(aKey, theBlockNum);
+    }
+    return true;
+  });
+  return theResult;
+}
 // --------------------------------------------------
 
 // visit blocks associated with index
 bool Index::each(BlockVisitor aVisitor) {
   Block theBlock;
-  for (const auto &[theIndexKey, theBlockNum] : data) {
-    //if (storage.readBlock(theBlockNum, theBlock)) {
-      if (!aVisitor(theBlock, theBlockNum)) {
-        return false;
-      }
-    //}
+  if (IndexType::bitmapKey == type) {
+    return eachBitmapKey("", std::nullopt,
+                         [&](const IndexKey &, uint32_t aBlockNum) {
+                           return aVisitor(theBlock, aBlockNum);
+                         });
   }
-  return true;
+  if (IndexType::fulltextKey == type) {
+    RoaringBitmap theBlocks;
+    for (const auto &[theWord, theBitmap] : bitmaps) {
+      theBlocks |= theBitmap;
+    }
+    return theBlocks.each([&](uint32_t aBlockNum) {
+      return aVisitor(theBlock, aBlockNum);
+    });
+  }
+  return data.each([&](const std::string &, uint32_t aBlockNum) {
+    return aVisitor(theBlock, aBlockNum);
+  });
 }
 
 // for show
 // visit index values (key, value)...
 bool Index::eachKV(const IndexVisitor &aCall) {
-  for (const auto &[theIndexKey, theBlockNum] : data) {
-    if (!aCall(theIndexKey, theBlockNum)) {
+  if (IndexType::bitmapKey == type) {
+    return eachBitmapKey("", std::nullopt, aCall);
+  }
+  if (IndexType::fulltextKey == type) {
+    for (const auto &[theWord, theBitmap] : bitmaps) {
+      if (!theBitmap.each([&](uint32_t aBlockNum) {
+            return aCall(theWord, aBlockNum);
+          })) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return data.each([&](const std::string &aBytes, uint32_t aBlockNum) {
+    return aCall(keyOf(aBytes), aBlockNum);
+  });
+}
+
+bool Index::eachInRange(const IndexKeyOpt &aLow, const IndexKeyOpt &aHigh,
+                        const IndexVisitor &aCall) const {
+  if (IndexType::bitmapKey == type) {
+    return eachBitmapKey(
+        aLow ? std::get<std::string>(*aLow) : "",
+        aHigh ? std::optional<std::string>{std::get<std::string>(*aHigh)}
+              : std::nullopt,
+        aCall);
+  }
+  std::string theLowBytes;
+  std::string theHighBytes;
+  const std::string &theLow = aLow ? bytesOf(*aLow, theLowBytes) : theLowBytes;
+  const std::string &theHigh =
+      aHigh ? bytesOf(*aHigh, theHighBytes) : theHighBytes;
+  bool thePastHigh{false};
+  return data.eachFrom(theLow, [&](const std::string &aBytes,
+                                   uint32_t aBlockNum) {
+           thePastHigh = aHigh && theHigh < aBytes;
+           return !thePastHigh && aCall(keyOf(aBytes), aBlockNum);
+         }) ||
+         thePastHigh;
+}
+
+bool Index::eachWithPrefix(const std::string &aPrefix,
+                           const IndexVisitor &aCall) const {
+  if (IndexType::bitmapKey == type) {
+    return eachBitmapKey(aPrefix, KeyEncoder::upperBound(aPrefix), aCall);
+  }
+  bool thePastPrefix{false};
+  return data.eachFrom(aPrefix, [&](const std::string &aBytes,
+                                    uint32_t aBlockNum) {
+           thePastPrefix = 0 != aBytes.compare(0, aPrefix.size(), aPrefix);
+           return !thePastPrefix && aCall(keyOf(aBytes), aBlockNum);
+         }) ||
+         thePastPrefix;
+}
+
+// a bitmap holds every block of one value: synthesize the value + block
+// number keys a compositeKey index would store (a handful of values, so a
+// linear walk over them is cheap)
+bool Index::eachBitmapKey(const std::string &aLow,
+                          const std::optional<std::string> &aHigh,
+                          const IndexVisitor &aCall) const {
+  bool theDone{false};
+  for (const auto &[theValue, theBitmap] : bitmaps) {
+    if (aHigh && *aHigh < theValue) {
+      break;
+    }
+    bool theResult = theBitmap.each([&](uint32_t aBlockNum) {
+      std::string theKey{theValue};
+      KeyEncoder::appendBlockNum(theKey, aBlockNum);
+      if (theKey < aLow) {
+        return true;
+      }
+      theDone = aHigh && *aHigh < theKey;
+      return !theDone && aCall(theKey, aBlockNum);
+    });
+    if (theDone) {
+      break;
+    }
+    if (!theResult) {
       return false;
     }
   }
   return true;
 }
 
+RoaringBitmap Index::bitmapOf(Operators anOp, const Value &aValue) const {
+  std::string theKey;
+  KeyEncoder::append(theKey, aValue);
+  std::string theNull;
+  KeyEncoder::appendNull(theNull);  // see makeKey
+  RoaringBitmap theResult;
+  for (const auto &[theValue, theBitmap] : bitmaps) {
+    // rows without a value, or a value of another type: left to the filter
+    bool theMatch{true};
+    if (theValue != theNull && theValue.front() == theKey.front()) {
+      switch (anOp) {
+        case Operators::equal_op:
+          theMatch = theValue == theKey;
+          break;
+        case Operators::notequal_op:
+          theMatch = theValue != theKey;
+          break;
+        case Operators::lt_op:
+          theMatch = theValue < theKey;
+          break;
+        case Operators::lte_op:
+          theMatch = theValue <= theKey;
+          break;
+        case Operators::gt_op:
+          theMatch = theValue > theKey;
+          break;
+        case Operators::gte_op:
+          theMatch = theValue >= theKey;
+          break;
+        default:
+          break;
+      }
+    }
+    if (theMatch) {
+      theResult |= theBitmap;
+    }
+  }
+  return theResult;
+}
+
+// a word of the text lies inside one word of the row, so each piece of the
+// pattern picks the union of the words it fits; the pieces are ANDed
+std::optional<RoaringBitmap> Index::postingsOf(Operators anOp,
+                                               const std::string &aText) const {
+  std::vector<TextSearch::Piece> thePieces;
+  if (Operators::match_op == anOp) {
+    for (auto &theWord : TextSearch::terms(aText)) {
+      thePieces.push_back({theWord, TextSearch::Anchor::exact});
+    }
+  } else if (Operators::like_op == anOp) {
+    thePieces = TextSearch::likePieces(aText);
+  }
+  std::optional<RoaringBitmap> theResult;
+  for (const auto &thePiece : thePieces) {
+    // words starting with the piece are adjacent in the dictionary
+    bool isAnchored{TextSearch::Anchor::exact == thePiece.anchor ||
+                    TextSearch::Anchor::prefix == thePiece.anchor};
+    RoaringBitmap theBlocks;
+    for (auto theIter = isAnchored ? bitmaps.lower_bound(thePiece.text)
+                                   : bitmaps.begin();
+         theIter != bitmaps.end(); ++theIter) {
+      if (isAnchored &&
+          0 != theIter->first.compare(0, thePiece.text.size(), thePiece.text)) {
+        break;
+      }
+      if (TextSearch::fits(theIter->first, thePiece)) {
+        theBlocks |= theIter->second;
+      }
+    }
+    if (!theResult) {
+      theResult = std::move(theBlocks);
+    } else {
+      *theResult &= theBlocks;
+    }
+  }
+  return theResult;
+}
+
+StringList Index::wordsOf(const std::string &aKey) const {
+  StringList theWords;
+  if (aKey.size() > sizeof(uint32_t)) {
+    ValuesList theValues{
+        KeyEncoder::decode(aKey.substr(0, aKey.size() - sizeof(uint32_t)), 1)};
+    if (!theValues.empty()) {
+      if (const auto *theText = std::get_if<std::string>(&theValues.front())) {
+        theWords = TextSearch::terms(*theText);
+      }
+    }
+  }
+  std::sort(theWords.begin(), theWords.end());
+  theWords.erase(std::unique(theWords.begin(), theWords.end()), theWords.end());
+  return theWords;
+}
+
 Index &Index::setName(std::string aName) {
   entityId = Helpers::hashString(aName);
   name = std::move(aName);
   return *this;
 }
 
-void Index::encodeIndexKey(std::ostream &anOutput, const IndexKey &anIndexKey,
-                           const IndexType &anIdxType) {
-  if (IndexType::intKey == anIdxType) {
-    Helpers::encodeInto(anOutput, std::get<uint32_t>(anIndexKey));
+Index &Index::setFields(const StringList &aFields) {
+  fields = aFields;
+  return *this;
+}
+
+Index &Index::setIncluded(const StringList &aFields) {
+  included = aFields;
+  return *this;
+}
+
+Index &Index::setUnique(bool aUnique) {
+  unique = aUnique;
+  if (!unique) {
+    bloom.reset();
+  }
+  return *this;
+}
+
+IndexKey Index::makeKey(const KeyValues &aRow, uint32_t aBlockNum) const {
+  if (IndexType::compositeKey != type && IndexType::bitmapKey != type &&
+      IndexType::fulltextKey != type) {
+    const Value &theVal = aRow.at(fields.front());
+    if (const int *theInt = std::get_if<int>(&theVal)) {
+      return static_cast<uint32_t>(*theInt);
+    }
+    if (const auto *theStr = std::get_if<std::string>(&theVal)) {
+      return *theStr;
+    }
+    std::string theValStr = Helpers::valToString(theVal);
+    theValStr.pop_back();  // drop type char
+    return theValStr;
+  }
+  std::string theKey;
+  if (IndexType::fulltextKey == type && hasNullField(aRow)) {
+    return KeyEncoder::appendBlockNum(theKey, aBlockNum);  // no words
+  }
+  for (const auto *theList : {&fields, &included}) {
+    for (const auto &theField : *theList) {
+      auto theIter = aRow.find(theField);
+      if (theIter != aRow.end()) {
+        KeyEncoder::append(theKey, theIter->second);
+      } else {
+        KeyEncoder::appendNull(theKey);
+      }
+    }
+  }
+  // NULL never equals NULL, so such keys stay distinct even when unique
+  return (unique && !hasNullField(aRow)) ? theKey
+                                 : KeyEncoder::appendBlockNum(theKey, aBlockNum);
+}
+
+std::string Index::keyToString(const IndexKey &aKey) const {
+  if (IndexType::intKey == type) {
+    return std::to_string(std::get<uint32_t>(aKey));
+  }
+  if (IndexType::strKey == type || IndexType::fulltextKey == type) {
+    return std::get<std::string>(aKey);  // fulltext: eachKV visits words
+  }
+  const auto &theKey = std::get<std::string>(aKey);
+  std::string theStr;
+  size_t thePos{0};
+  for (size_t i = 0; i < fields.size() + included.size() &&
+                     thePos < theKey.size();
+       i++) {
+    std::string theValStr{"NULL"};
+    bool isNull = KeyEncoder::isNull(theKey, thePos);
+    Value theVal;
+    thePos = KeyEncoder::decode(theKey, thePos, theVal);
+    if (!isNull) {
+      theValStr = Helpers::valToString(theVal);
+      theValStr.pop_back();  // drop type char
+    }
+    theStr += (theStr.empty() ? "" : ", ") + theValStr;
+  }
+  return theStr;
+}
+
+KeyValues Index::valuesOf(const IndexKey &aKey) const {
+  KeyValues theValues;
+  if (const auto *theInt = std::get_if<uint32_t>(&aKey)) {
+    theValues[fields.front()] = static_cast<int>(*theInt);
+  } else if (IndexType::strKey == type) {
+    theValues[fields.front()] = std::get<std::string>(aKey);
   } else {
-    Helpers::encodeInto(anOutput, std::get<std::string>(anIndexKey));
+    const auto &theKey = std::get<std::string>(aKey);
+    size_t thePos{0};
+    for (const auto *theList : {&fields, &included}) {
+      for (const auto &theField : *theList) {
+        if (thePos >= theKey.size()) {
+          return theValues;
+        }
+        bool isNull = KeyEncoder::isNull(theKey, thePos);
+        Value theVal;
+        thePos = KeyEncoder::decode(theKey, thePos, theVal);
+        if (!isNull) {
+          theValues[theField] = std::move(theVal);
+        }
+      }
+    }
+  }
+  return theValues;
+}
+
+uint64_t Index::hashKey(const IndexKey &aKey) {
+  if (const auto *theInt = std::get_if<uint32_t>(&aKey)) {
+    return BloomFilter::hash(*theInt);
+  }
+  return BloomFilter::hash(std::get<std::string>(aKey));
+}
+
+const std::string &Index::bytesOf(const IndexKey &aKey,
+                                  std::string &aScratch) {
+  if (const auto *theInt = std::get_if<uint32_t>(&aKey)) {
+    aScratch.clear();
+    return KeyEncoder::appendBlockNum(aScratch, *theInt);  // big-endian
   }
+  return std::get<std::string>(aKey);
 }
 
-IndexKey Index::toIndexKey(const std::string &aStr, IndexType anIdxType) {
-  IndexKey theKey;
-  if (IndexType::intKey == anIdxType) {
-    theKey = static_cast<uint32_t>(std::stoul(aStr));
-  } else if (IndexType::strKey == anIdxType) {
-    theKey = aStr;
+IndexKey Index::keyOf(const std::string &aBytes) const {
+  if (IndexType::intKey == type) {
+    return KeyEncoder::blockNumSuffix(aBytes);
   }
-  return theKey;
+  return aBytes;
 }
 
 }  // namespace ECE141
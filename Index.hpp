@@ -20,18 +20,37 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <optional>
 #include <variant>
-// #include <vector>
+#include <vector>
 
+#include "AdaptiveRadixTree.hpp"
 #include "BasicTypes.hpp"
+#include "BloomFilter.hpp"
+#include "RoaringBitmap.hpp"
 #include "Storage.hpp"
+#include "keywords.hpp"
 
 namespace ECE141 {
+class ExternalSorter;
 class StatusResult;
 
-enum class IndexType { intKey = 'I', strKey = 'S' };
+// compositeKey: memcmp ordered byte string built by KeyEncoder
+// bitmapKey: keys like a non-unique compositeKey, stored as one bitmap of
+//            block numbers per distinct value (for low-cardinality columns)
+// fulltextKey: same keys, stored as one bitmap (posting list) per word of
+//              the text (see TextSearch)
+enum class IndexType {
+  intKey = 'I',
+  strKey = 'S',
+  compositeKey = 'C',
+  bitmapKey = 'B',
+  fulltextKey = 'F'
+};
 using IndexKey = std::variant<uint32_t, std::string>;
 
+using IndexKeyOpt = std::optional<IndexKey>;
+
 using IndexVisitor = std::function<bool(const IndexKey &, uint32_t)>;
 
 class Index : public Storable, BlockIterator {
@@ -60,7 +79,18 @@ class Index : public Storable, BlockIterator {
   Index &setChanged(bool aChanged);
   Index &setIndexBlockNum(uint32_t aBlockNum);
   Index &setName(std::string aName);
+  Index &setFields(const StringList &aFields);
+  Index &setIncluded(const StringList &aFields);
+  Index &setUnique(bool aUnique);
+  Index &setLoaded(bool aLoaded);
+  // drop the in-memory keys; caller saves first if the index changed
+  Index &unload();
+  // false if aKey was already present (existing value is kept)
   bool setKeyValue(const IndexKey &aKey, uint32_t aValue);
+  // add sorted entries in one pass (each goes right after the previous one);
+  // uniqueViolation on a duplicate key, writeError if aSorter failed;
+  // entries added before either are kept
+  StatusResult bulkLoad(ExternalSorter &aSorter);
 
   // getter
   [[nodiscard]] uint32_t getBlockNum() const;
@@ -68,17 +98,34 @@ class Index : public Storable, BlockIterator {
   [[nodiscard]] uint32_t getEntityId() const;
   [[nodiscard]] size_t getSize() const;
   [[nodiscard]] IndexType getType() const;
+  [[nodiscard]] const StringList &getFields() const;
+  [[nodiscard]] const StringList &getIncluded() const;
+  // aField is a key or an included column (its entries carry the value)
+  [[nodiscard]] bool hasField(const std::string &aField) const;
 
   [[nodiscard]] StorageInfo getStorageInfo(
       size_t aSize, const std::string &aTableName = "") const;
 
   [[nodiscard]] bool isChanged() const;
+  // false for a catalog stub whose keys are still on disk (see Database)
+  [[nodiscard]] bool isLoaded() const;
   [[nodiscard]] bool isEmpty() const;
+  [[nodiscard]] bool isUnique() const;
+  [[nodiscard]] bool hasBloomFilter() const;
+  // true if aRow has no value for one of the indexed fields
+  [[nodiscard]] bool hasNullField(const KeyValues &aRow) const;
+  // a Bloom filter miss answers without descending the tree
   [[nodiscard]] bool exists(const IndexKey &aKey) const;
 
+  // probe a batch of new keys (sorted in place) before anything is written;
+  // keys in aReplaced are about to be removed, so they don't collide
+  [[nodiscard]] bool checkUnique(std::vector<IndexKey> &aKeys,
+                                 const std::vector<IndexKey> &aReplaced = {}) const;
+
   [[nodiscard]] IntOpt valueAt(const IndexKey &aKey) const;
   StatusResult erase(uint32_t aKey);
   StatusResult erase(const std::string &aKey);
+  StatusResult erase(const IndexKey &aKey);
 
   // Storable interface
   StatusResult encode(std::ostream &anOutput) const override;
@@ -88,14 +135,34 @@ class Index : public Storable, BlockIterator {
   bool each(BlockVisitor aVisitor) override;
   // visit index values (key, value)...
   bool eachKV(const IndexVisitor &aCall);
+  // visit keys in [aLow, aHigh] (missing bound = open end)
+  bool eachInRange(const IndexKeyOpt &aLow, const IndexKeyOpt &aHigh,
+                   const IndexVisitor &aCall) const;
+  // visit composite keys that start with aPrefix (leftmost columns)
+  bool eachWithPrefix(const std::string &aPrefix,
+                      const IndexVisitor &aCall) const;
+  // bitmap index: blocks of the rows where `field anOp aValue` may hold
+  // (rows without a value are always included)
+  [[nodiscard]] RoaringBitmap bitmapOf(Operators anOp,
+                                       const Value &aValue) const;
+  // fulltext index: blocks of the rows where `field LIKE / MATCH aText` may
+  // hold; nullopt if the pattern names no word to look up
+  [[nodiscard]] std::optional<RoaringBitmap> postingsOf(
+      Operators anOp, const std::string &aText) const;
 
   // ? custom
   // --------------------------------------------------------------------
 
-  static void encodeIndexKey(std::ostream &anOutput, const IndexKey &anIndexKey,
-                             const IndexType &anIdxType);
+  static uint64_t hashKey(const IndexKey &aKey);
 
-  static IndexKey toIndexKey(const std::string &aStr, IndexType anIdxType);
+  // build the key of aRow for this index; non-unique composite keys (and
+  // keys with a NULL column) end in aBlockNum so they never collide
+  [[nodiscard]] IndexKey makeKey(const KeyValues &aRow,
+                                 uint32_t aBlockNum) const;
+  [[nodiscard]] std::string keyToString(const IndexKey &aKey) const;
+  // the column values an entry carries (key columns, then included ones);
+  // a NULL composite column is left out, as it is in the row
+  [[nodiscard]] KeyValues valuesOf(const IndexKey &aKey) const;
 
   static IndexKey valueToIndexKey(Value theVal, DataTypes aDType) {
     if (DataTypes::int_type == aDType) {
@@ -106,12 +173,42 @@ class Index : public Storable, BlockIterator {
 
  protected:
   Storage &storage;
-  std::map<IndexKey, uint32_t> data;  //  IndexKey of data : blockNum of a Row?
+  // binary-comparable key (see bytesOf) : blockNum of a Row
+  AdaptiveRadixTree data;
+  // bitmapKey: value : blocks, fulltextKey: word : blocks
+  std::map<std::string, RoaringBitmap> bitmaps;
   std::string name{"Null"};           // attrName
+  StringList fields;                  // indexed attrNames, in key order
+  StringList included;  // compositeKey: columns stored after the key ones
   uint32_t entityId{0};               // ? Hash
   uint32_t blockNum{0};  // index block's blkNum (where index storage begins)
   IndexType type;
+  bool unique{true};  // primary / UNIQUE: one row per key
   bool changed{false};
+  bool loaded{true};
+  // negative lookups for unique indexes (keys are never removed from it)
+  std::optional<BloomFilter> bloom;
+
+  // the tree's key for aKey: ints as 4 big-endian bytes (so byte order is
+  // numeric order), strings as they are (aScratch is only used for ints)
+  static const std::string &bytesOf(const IndexKey &aKey,
+                                    std::string &aScratch);
+  [[nodiscard]] IndexKey keyOf(const std::string &aBytes) const;
+  // image layout before format versions: name, type, block number, then
+  // key / block number pairs as text (primary and meta indexes)
+  StatusResult decodeVersion1(std::istream &anInput);
+  // intKey: the group varint page of keys and block numbers
+  StatusResult decodeIntKeys(std::istream &anInput);
+  // string keyed types: the front coded key page and what each key maps to
+  StatusResult decodeStringKeys(std::istream &anInput);
+  void addToBloomFilter(const IndexKey &aKey);
+  void rebuildBloomFilter();
+  // bitmapKey: visit the keys (value + block number) in [aLow, aHigh]
+  bool eachBitmapKey(const std::string &aLow,
+                     const std::optional<std::string> &aHigh,
+                     const IndexVisitor &aCall) const;
+  // fulltextKey: the distinct words of the text in aKey
+  [[nodiscard]] StringList wordsOf(const std::string &aKey) const;
 };
 // table name : index or vector<index>
 // using IndexMap = std::map<std::string, std::vector<std::unique_ptr<Index>>>;
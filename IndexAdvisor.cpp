@@ -0,0 +1,129 @@
+/**
+ * @file IndexAdvisor.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "IndexAdvisor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ECE141 {
+
+// terms a btree index on the column can seek to
+static bool isSeekable(Operators anOp) {
+  switch (anOp) {
+    case Operators::equal_op:
+    case Operators::lt_op:
+    case Operators::lte_op:
+    case Operators::gt_op:
+    case Operators::gte_op:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void addOnce(StringList &aList, const std::string &aField) {
+  if (std::find(aList.begin(), aList.end(), aField) == aList.end()) {
+    aList.push_back(aField);
+  }
+}
+
+// The columns are taken as independent and equally selective: an index on
+// m of the k filtered columns still reads (matched/scanned)^(m/k) of the
+// rows. A composite candidate puts the equality columns first and one range
+// column last, the longest prefix a key range can use.
+IndexAdvisor &IndexAdvisor::recordScan(const std::string &aTable,
+                                       const PredicateList &aPredicates,
+                                       size_t aScanned, size_t aMatched,
+                                       double aSeconds) {
+  StringList theEquals;
+  StringList theRanges;
+  for (const auto &thePred : aPredicates) {
+    if (isSeekable(thePred.op)) {
+      addOnce(Operators::equal_op == thePred.op ? theEquals : theRanges,
+              thePred.field);
+    }
+  }
+  StringList theColumns{theEquals};
+  for (const auto &theField : theRanges) {
+    addOnce(theColumns, theField);
+  }
+  if (theColumns.empty() || 0 == aScanned) {
+    return *this;
+  }
+
+  double theSelectivity =
+      static_cast<double>(std::min(aMatched, aScanned)) / aScanned;
+  auto theSavings = [&](size_t aCovered) {
+    double theShare = static_cast<double>(aCovered) / theColumns.size();
+    return aSeconds * (1.0 - std::pow(theSelectivity, theShare));
+  };
+
+  for (const auto &theField : theColumns) {
+    credit(aTable, {theField}, theSavings(1));
+  }
+  StringList theComposite{theEquals};
+  for (const auto &theField : theRanges) {
+    if (std::find(theComposite.begin(), theComposite.end(), theField) ==
+        theComposite.end()) {
+      theComposite.push_back(theField);
+      break;
+    }
+  }
+  if (theComposite.size() > 1) {
+    credit(aTable, theComposite, theSavings(theComposite.size()));
+  }
+  return *this;
+}
+
+// without an index every probe reads the whole table; with one it reads the
+// matching rows, so (nearly) all of the scan time is saved
+IndexAdvisor &IndexAdvisor::recordJoin(const std::string &aTable,
+                                       const std::string &aField,
+                                       double aSeconds) {
+  credit(aTable, {aField}, aSeconds);
+  return *this;
+}
+
+IndexAdvisor &IndexAdvisor::forget(const std::string &aTable) {
+  for (auto theIter = candidates.begin(); theIter != candidates.end();) {
+    theIter = (aTable == theIter->first.first) ? candidates.erase(theIter)
+                                               : std::next(theIter);
+  }
+  return *this;
+}
+
+IndexAdvisor::AdviceList IndexAdvisor::advise(
+    const IndexedCheck &anIndexed) const {
+  AdviceList theList;
+  for (const auto &[theCandidate, theAdvice] : candidates) {
+    if (theAdvice.savings > 0 &&
+        !anIndexed(theCandidate.first, theCandidate.second)) {
+      theList.push_back(theAdvice);
+    }
+  }
+  std::stable_sort(theList.begin(), theList.end(),
+                   [](const Advice &aLHS, const Advice &aRHS) {
+                     return aLHS.savings > aRHS.savings;
+                   });
+  return theList;
+}
+
+void IndexAdvisor::credit(const std::string &aTable, const StringList &aFields,
+                          double aSavings) {
+  Advice &theAdvice = candidates[Candidate{aTable, aFields}];
+  theAdvice.table = aTable;
+  theAdvice.fields = aFields;
+  theAdvice.queries++;
+  theAdvice.savings += aSavings;
+}
+
+}  // namespace ECE141
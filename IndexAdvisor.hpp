@@ -0,0 +1,69 @@
+/**
+ * @file IndexAdvisor.hpp
+ * @author Yifan Wu
+ * @brief recommends indexes from the predicates and joins the workload ran
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef IndexAdvisor_hpp
+#define IndexAdvisor_hpp
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicTypes.hpp"
+#include "Filters.hpp"
+
+namespace ECE141 {
+
+// USE: the database reports every scan that read rows an index could have
+//      skipped (where-clause terms, join keys) with the time it took. Each
+//      one credits its candidate indexes with the share of that time they
+//      would have saved; advise() ranks the candidates no index serves yet.
+//      Kept in memory, so the advice covers this session's workload.
+class IndexAdvisor {
+ public:
+  struct Advice {
+    std::string table;
+    StringList fields;
+    size_t queries{0};   // scans the index would have helped
+    double savings{0};   // estimated seconds saved over those scans
+  };
+  using AdviceList = std::vector<Advice>;
+  // true if an index of aTable already serves lookups on aFields
+  using IndexedCheck =
+      std::function<bool(const std::string &, const StringList &)>;
+
+  // a scan of aTable that read aScanned rows in aSeconds, of which aMatched
+  // satisfied the conjunction aPredicates
+  IndexAdvisor &recordScan(const std::string &aTable,
+                           const PredicateList &aPredicates, size_t aScanned,
+                           size_t aMatched, double aSeconds);
+  // a join that read all of aTable in aSeconds to match on aField
+  IndexAdvisor &recordJoin(const std::string &aTable, const std::string &aField,
+                           double aSeconds);
+  IndexAdvisor &forget(const std::string &aTable);
+
+  // candidates anIndexed rejects are left out; best savings first
+  [[nodiscard]] AdviceList advise(const IndexedCheck &anIndexed) const;
+
+ protected:
+  using Candidate = std::pair<std::string, StringList>;  // table, fields
+
+  void credit(const std::string &aTable, const StringList &aFields,
+              double aSavings);
+
+  std::map<Candidate, Advice> candidates;
+};
+
+}  // namespace ECE141
+
+#endif /* IndexAdvisor_hpp */
@@ -0,0 +1,522 @@
+/**
+ * @file JoinOperators.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "JoinOperators.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "Database.hpp"
+#include "Filters.hpp"
+#include "Helpers.hpp"
+#include "KeyEncoder.hpp"
+#include "Timer.hpp"
+
+namespace ECE141 {
+
+// whole numbers of any type become ints, so equal numbers hash alike
+static Value keyPartOf(const Value &aValue) {
+  if (const bool *theBool = std::get_if<bool>(&aValue)) {
+    return Value{static_cast<int>(*theBool)};
+  }
+  if (const double *theDouble = std::get_if<double>(&aValue)) {
+    if (std::trunc(*theDouble) == *theDouble &&
+        std::abs(*theDouble) <= std::numeric_limits<int>::max()) {
+      return Value{static_cast<int>(*theDouble)};
+    }
+  }
+  return aValue;
+}
+
+size_t JoinKeyHash::operator()(const JoinKey &aKey) const {
+  size_t theHash{aKey.size()};
+  for (const auto &theValue : aKey) {
+    size_t thePart = std::visit(
+        [](const auto &aPart) {
+          return std::hash<std::decay_t<decltype(aPart)>>{}(aPart);
+        },
+        theValue);
+    theHash ^= thePart + 0x9e3779b9 + (theHash << 6) + (theHash >> 2);
+  }
+  return theHash;
+}
+
+// ---------------------------------------------------------------------------
+bool JoinColumns::canHash(const Join &aJoin) {
+  size_t theEntityId = Helpers::hashString(aJoin.table);
+  return !aJoin.exprs.empty() &&
+         std::all_of(
+             aJoin.exprs.begin(), aJoin.exprs.end(), [&](const auto &anExpr) {
+               const auto &theLogics = anExpr->logics;
+               return Operators::equal_op == anExpr->op &&
+                      TokenType::identifier == anExpr->lhs.ttype &&
+                      TokenType::identifier == anExpr->rhs.ttype &&
+                      (theEntityId == anExpr->lhs.entityId) !=
+                          (theEntityId == anExpr->rhs.entityId) &&
+                      std::find_if(theLogics.begin(), theLogics.end(),
+                                   [](Logical aLogic) {
+                                     return Logical::and_op != aLogic;
+                                   }) == theLogics.end();
+             });
+}
+
+JoinColumns::JoinColumns(const Join &aJoin) {
+  size_t theEntityId = Helpers::hashString(aJoin.table);
+  for (const auto &theExpr : aJoin.exprs) {
+    bool isLHSRight = theEntityId == theExpr->lhs.entityId;
+    left.push_back(isLHSRight ? theExpr->rhs.name : theExpr->lhs.name);
+    right.push_back(isLHSRight ? theExpr->lhs.name : theExpr->rhs.name);
+  }
+}
+
+bool JoinColumns::keyOf(const Row &aRow, bool isLeft, JoinKey &aKey) const {
+  const StringList &theFields = isLeft ? left : right;
+  const KeyValues &theData = aRow.getData();
+  aKey.clear();
+  for (const auto &theField : theFields) {
+    auto theIter = theData.find(theField);
+    if (theIter == theData.end()) {
+      return false;
+    }
+    // a row an earlier outer join padded
+    auto *theString = std::get_if<std::string>(&theIter->second);
+    if (theString && "NULL" == *theString) {
+      return false;
+    }
+    aKey.push_back(keyPartOf(theIter->second));
+  }
+  return true;
+}
+
+bool JoinColumns::sortKeyOf(const Row &aRow, bool isLeft,
+                            std::string &aKey) const {
+  JoinKey theKey;
+  aKey.clear();
+  if (!keyOf(aRow, isLeft, theKey)) {
+    return false;
+  }
+  aKey = KeyEncoder::encode(theKey);
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+JoinOutput::JoinOutput(Keywords aJoinType) : joinType{aJoinType} {}
+
+void JoinOutput::note(const Row &aRow, bool isLeft) {
+  std::unique_ptr<Row> &theNulls = isLeft ? leftNulls : rightNulls;
+  if (!theNulls) {
+    theNulls = std::make_unique<Row>(aRow);
+    theNulls->setAllNull();
+  }
+}
+
+void JoinOutput::emit(const Row &aLeft, const Row &aRight,
+                      std::unique_ptr<Row> &anOutput) const {
+  bool isRightJoin = Keywords::right_kw == joinType;
+  anOutput = std::make_unique<Row>(isRightJoin ? aRight : aLeft);
+  *anOutput += isRightJoin ? aLeft : aRight;
+}
+
+void JoinOutput::pad(const Row &aRow, bool isLeft,
+                     std::unique_ptr<Row> &anOutput) const {
+  anOutput = std::make_unique<Row>(aRow);
+  if (const Row *theNulls = (isLeft ? rightNulls : leftNulls).get()) {
+    *anOutput += *theNulls;
+  }
+}
+
+bool JoinOutput::keepsUnmatched(bool isLeft) const {
+  return Keywords::full_kw == joinType ||
+         (isLeft ? Keywords::left_kw : Keywords::right_kw) == joinType;
+}
+
+void JoinOutput::reset() {
+  leftNulls.reset();
+  rightNulls.reset();
+}
+
+// ---------------------------------------------------------------------------
+HashJoinOperator::HashJoinOperator(OperatorPtr aLeft, OperatorPtr aRight,
+                                   const Join &aJoin, Observer anObserver)
+    : left{std::move(aLeft)},
+      right{std::move(aRight)},
+      columns{aJoin},
+      output{aJoin.joinType},
+      observer{std::move(anObserver)} {}
+
+StatusResult HashJoinOperator::open() {
+  Timer theTimer;
+  reset();
+  StatusResult theResult = left->open();
+  if (theResult) {
+    theResult = right->open();
+  }
+  // the side that runs out first is the smaller one
+  RowCollection theRows[2];
+  bool isDone[2]{false, false};
+  std::unique_ptr<Row> theRow;
+  for (size_t theSide{0}; theResult && !isDone[0] && !isDone[1];
+       theSide ^= 1) {
+    if ((theResult = (0 == theSide ? left : right)->next(theRow))) {
+      if (theRow) {
+        theRows[theSide].push_back(std::move(theRow));
+      } else {
+        isDone[theSide] = true;
+      }
+    }
+  }
+  for (size_t theSide : {0, 1}) {
+    if (!theRows[theSide].empty()) {
+      output.note(*theRows[theSide].front(), 0 == theSide);
+    }
+  }
+  buildIsLeft = isDone[0];
+  buildRows = std::move(theRows[buildIsLeft ? 0 : 1]);
+  probeRows = std::move(theRows[buildIsLeft ? 1 : 0]);
+  matched.assign(buildRows.size(), false);
+  JoinKey theKey;
+  for (size_t i{0}; i < buildRows.size(); i++) {
+    if (columns.keyOf(*buildRows[i], buildIsLeft, theKey)) {
+      table[theKey].push_back(i);
+    }
+  }
+  seconds = theTimer.elapsed();
+  return theResult;
+}
+
+StatusResult HashJoinOperator::nextProbe(std::unique_ptr<Row> &aRow) {
+  if (probePosition < probeRows.size()) {
+    aRow = std::move(probeRows[probePosition++]);
+    return {Errors::noError};
+  }
+  probeRows.clear();
+  probePosition = 0;
+  StatusResult theResult = (buildIsLeft ? right : left)->next(aRow);
+  if (theResult && aRow) {
+    output.note(*aRow, !buildIsLeft);
+  }
+  return theResult;
+}
+
+StatusResult HashJoinOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  Timer theTimer;
+  StatusResult theResult{Errors::noError};
+  while (theResult && !aRow) {
+    if (current) {
+      if (bucket && position < bucket->size()) {
+        size_t theMatch = (*bucket)[position++];
+        matched[theMatch] = true;
+        const Row &theBuild = *buildRows[theMatch];
+        buildIsLeft ? output.emit(theBuild, *current, aRow)
+                    : output.emit(*current, theBuild, aRow);
+      } else {
+        if (!bucket && output.keepsUnmatched(!buildIsLeft)) {
+          output.pad(*current, !buildIsLeft, aRow);
+        }
+        current.reset();
+      }
+    } else if (!probeDone) {
+      if ((theResult = nextProbe(current)) && current) {
+        JoinKey theKey;
+        auto theIter = columns.keyOf(*current, !buildIsLeft, theKey)
+                           ? table.find(theKey)
+                           : table.end();
+        bucket = (theIter != table.end()) ? &theIter->second : nullptr;
+        position = 0;
+      } else {
+        probeDone = true;
+      }
+    } else {
+      // the build rows nothing matched
+      while (unmatched < buildRows.size() && matched[unmatched]) {
+        unmatched++;
+      }
+      if (!output.keepsUnmatched(buildIsLeft) ||
+          unmatched >= buildRows.size()) {
+        break;
+      }
+      output.pad(*buildRows[unmatched++], buildIsLeft, aRow);
+    }
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void HashJoinOperator::close() {
+  left->close();
+  right->close();
+  if (observer) {
+    observer(seconds);
+  }
+  reset();
+}
+
+void HashJoinOperator::reset() {
+  buildRows.clear();
+  probeRows.clear();
+  matched.clear();
+  table.clear();
+  output.reset();
+  current.reset();
+  bucket = nullptr;
+  probePosition = position = unmatched = 0;
+  probeDone = false;
+  seconds = 0;
+}
+
+// ---------------------------------------------------------------------------
+MergeJoinOperator::MergeJoinOperator(OperatorPtr aLeft, OperatorPtr aRight,
+                                     const Join &aJoin, Observer anObserver)
+    : left{std::move(aLeft)},
+      right{std::move(aRight)},
+      columns{aJoin},
+      output{aJoin.joinType},
+      observer{std::move(anObserver)} {}
+
+StatusResult MergeJoinOperator::open() {
+  Timer theTimer;
+  reset();
+  StatusResult theResult = left->open();
+  if (theResult) {
+    theResult = right->open();
+  }
+  // a first row of each side, so either NULL row exists before padding
+  if (theResult) {
+    theResult = pull(true, leftSide);
+  }
+  if (theResult) {
+    theResult = pull(false, rightSide);
+  }
+  seconds = theTimer.elapsed();
+  return theResult;
+}
+
+StatusResult MergeJoinOperator::pull(bool isLeft, Cursor &aCursor) {
+  StatusResult theResult = (isLeft ? left : right)->next(aCursor.row);
+  if (theResult && aCursor.row) {
+    output.note(*aCursor.row, isLeft);
+    aCursor.hasKey = columns.sortKeyOf(*aCursor.row, isLeft, aCursor.key);
+  } else {
+    aCursor.ended = true;
+  }
+  return theResult;
+}
+
+StatusResult MergeJoinOperator::loadGroup() {
+  StatusResult theResult{Errors::noError};
+  while (theResult) {
+    if (!rightSide.row) {
+      if (rightSide.ended || !(theResult = pull(false, rightSide)) ||
+          !rightSide.row) {
+        break;
+      }
+    }
+    if (!rightSide.hasKey) {
+      if (output.keepsUnmatched(false)) {
+        pending.emplace_back();
+        output.pad(*rightSide.row, false, pending.back());
+      }
+      rightSide.row.reset();
+    } else if (group.empty() || rightSide.key == groupKey) {
+      groupKey = rightSide.key;
+      group.push_back(std::move(rightSide.row));
+      matched.push_back(false);
+    } else {
+      break;
+    }
+  }
+  return theResult;
+}
+
+void MergeJoinOperator::finishGroup() {
+  for (size_t i{0}; i < group.size(); i++) {
+    if (!matched[i] && output.keepsUnmatched(false)) {
+      pending.emplace_back();
+      output.pad(*group[i], false, pending.back());
+    }
+  }
+  group.clear();
+  matched.clear();
+}
+
+StatusResult MergeJoinOperator::fill() {
+  StatusResult theResult{Errors::noError};
+  while (theResult && pending.empty() && !done) {
+    bool isRightDone = group.empty() && !rightSide.row && rightSide.ended;
+    if (!leftSide.row && !leftSide.ended) {
+      theResult = pull(true, leftSide);
+    } else if ((!leftSide.row && !output.keepsUnmatched(false)) ||
+               (isRightDone && !output.keepsUnmatched(true))) {
+      done = true;  // what is left of the other side can't come out
+    } else if (leftSide.row && !leftSide.hasKey) {
+      if (output.keepsUnmatched(true)) {
+        pending.emplace_back();
+        output.pad(*leftSide.row, true, pending.back());
+      }
+      leftSide.row.reset();
+    } else if (!group.empty() && (!leftSide.row || groupKey < leftSide.key)) {
+      finishGroup();  // no left row is left for this key
+    } else if (group.empty() && !isRightDone) {
+      theResult = loadGroup();
+    } else if (isRightDone) {
+      // the right side is done: the left rows still to come match nothing
+      if (leftSide.row && output.keepsUnmatched(true)) {
+        pending.emplace_back();
+        output.pad(*leftSide.row, true, pending.back());
+      }
+      done = !leftSide.row;
+      leftSide.row.reset();
+    } else {
+      // a left row whose key is not past the group's
+      if (groupKey == leftSide.key) {
+        for (size_t i{0}; i < group.size(); i++) {
+          pending.emplace_back();
+          output.emit(*leftSide.row, *group[i], pending.back());
+          matched[i] = true;
+        }
+      } else if (output.keepsUnmatched(true)) {
+        pending.emplace_back();
+        output.pad(*leftSide.row, true, pending.back());
+      }
+      leftSide.row.reset();
+    }
+  }
+  return theResult;
+}
+
+StatusResult MergeJoinOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  Timer theTimer;
+  StatusResult theResult = fill();
+  if (theResult && !pending.empty()) {
+    aRow = std::move(pending.front());
+    pending.pop_front();
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void MergeJoinOperator::close() {
+  left->close();
+  right->close();
+  if (observer) {
+    observer(seconds);
+  }
+  reset();
+}
+
+void MergeJoinOperator::reset() {
+  leftSide = Cursor{};
+  rightSide = Cursor{};
+  group.clear();
+  matched.clear();
+  groupKey.clear();
+  pending.clear();
+  output.reset();
+  done = false;
+  seconds = 0;
+}
+
+// ---------------------------------------------------------------------------
+IndexJoinOperator::IndexJoinOperator(Database &aDatabase, OperatorPtr aLeft,
+                                     const Join &aJoin,
+                                     std::string aProbeField, Probe aProbe,
+                                     Observer anObserver)
+    : database{aDatabase},
+      left{std::move(aLeft)},
+      table{aJoin.table},
+      columns{aJoin},
+      probe{std::move(aProbe)},
+      output{aJoin.joinType},
+      observer{std::move(anObserver)} {
+  auto theIter =
+      std::find(columns.left.begin(), columns.left.end(), aProbeField);
+  probeColumn = static_cast<size_t>(theIter - columns.left.begin());
+}
+
+StatusResult IndexJoinOperator::open() {
+  Timer theTimer;
+  current.reset();
+  blocks.clear();
+  output.reset();
+  StatusResult theResult = left->open();
+  // a row of the join table, so unmatched left rows pad to its columns
+  IndexCursor theCursor{database, table};
+  IndexKey theKey;
+  uint32_t theBlockNum{0};
+  if (theResult && output.keepsUnmatched(true) &&
+      theCursor.next(theKey, theBlockNum)) {
+    std::unique_ptr<Row> theRow;
+    if ((theResult = database.getStorage().loadRow(theBlockNum, theRow)) &&
+        theRow) {
+      output.note(*theRow, false);
+    }
+  }
+  seconds = theTimer.elapsed();
+  return theResult;
+}
+
+StatusResult IndexJoinOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  Timer theTimer;
+  StatusResult theResult{Errors::noError};
+  while (!aRow) {
+    if (!current) {
+      if (!(theResult = left->next(current)) || !current) {
+        break;
+      }
+      matched = false;
+      if (columns.keyOf(*current, true, key)) {
+        probe(key[probeColumn], blocks);
+      }
+    }
+    if (!blocks.empty()) {
+      std::unique_ptr<Row> theRow;
+      theResult = database.getStorage().loadRow(blocks.front(), theRow);
+      blocks.pop_front();
+      if (!theResult) {
+        break;
+      }
+      JoinKey theKey;
+      if (theRow) {
+        output.note(*theRow, false);
+        if (columns.keyOf(*theRow, false, theKey) && theKey == key) {
+          output.emit(*current, *theRow, aRow);
+          matched = true;
+        }
+      }
+    } else {
+      if (!matched && output.keepsUnmatched(true)) {
+        output.pad(*current, true, aRow);
+      }
+      current.reset();
+    }
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void IndexJoinOperator::close() {
+  left->close();
+  current.reset();
+  blocks.clear();
+  if (observer) {
+    observer(seconds);
+  }
+}
+
+}  // namespace ECE141
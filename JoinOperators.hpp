@@ -0,0 +1,207 @@
+/**
+ * @file JoinOperators.hpp
+ * @author Yifan Wu
+ * @brief join operators beyond the nested loop of QueryOperators
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef JoinOperators_hpp
+#define JoinOperators_hpp
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BasicTypes.hpp"
+#include "Errors.hpp"
+#include "Joins.hpp"
+#include "QueryOperators.hpp"
+#include "Row.hpp"
+#include "Storage.hpp"
+
+namespace ECE141 {
+
+class Database;
+
+// USE: the values of a row's join columns. Numbers with the same value are
+//      the same key whatever their type (1 = 1.0 = true); a number never
+//      equals a string.
+using JoinKey = std::vector<Value>;
+
+struct JoinKeyHash {
+  size_t operator()(const JoinKey &aKey) const;
+};
+
+// USE: which columns of each side a join's equality terms compare
+struct JoinColumns {
+  // false unless every term is `left.field = right.field`, ANDed
+  static bool canHash(const Join &aJoin);
+  explicit JoinColumns(const Join &aJoin);
+
+  // false if the row lacks one of the columns (NULL matches nothing)
+  bool keyOf(const Row &aRow, bool isLeft, JoinKey &aKey) const;
+  // the key as KeyEncoder bytes, whose order a merge join relies on
+  bool sortKeyOf(const Row &aRow, bool isLeft, std::string &aKey) const;
+
+  StringList left;   // fields of the rows already in the plan
+  StringList right;  // fields of aJoin.table
+};
+
+// USE: the rows a join type hands out. Matched rows are merged left +
+//      right (right + left for a right join, so the preserved side's
+//      columns win); an unmatched row of a preserved side keeps its columns
+//      and gets the other side's NULL row, made from the first row seen.
+class JoinOutput {
+ public:
+  explicit JoinOutput(Keywords aJoinType);
+
+  void note(const Row &aRow, bool isLeft);
+  void emit(const Row &aLeft, const Row &aRight,
+            std::unique_ptr<Row> &anOutput) const;
+  void pad(const Row &aRow, bool isLeft, std::unique_ptr<Row> &anOutput) const;
+  [[nodiscard]] bool keepsUnmatched(bool isLeft) const;
+  void reset();
+
+ protected:
+  Keywords joinType;
+  std::unique_ptr<Row> leftNulls;  // nullptr until a left row is seen
+  std::unique_ptr<Row> rightNulls;
+};
+
+// USE: equi-join of the plan so far (left) with the join table (right) for
+//      inner, left, right and full joins. open() pulls both sides in turn
+//      until one runs out and builds a hash table on that one, the smaller;
+//      the other side streams past it. Build rows never matched are padded
+//      once the probe side is done.
+class HashJoinOperator : public QueryOperator {
+ public:
+  using Observer = JoinOperator::Observer;
+
+  HashJoinOperator(OperatorPtr aLeft, OperatorPtr aRight, const Join &aJoin,
+                   Observer anObserver = nullptr);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  // next probe row: the buffered ones first, then the probe child's
+  StatusResult nextProbe(std::unique_ptr<Row> &aRow);
+  void reset();
+
+  OperatorPtr left;
+  OperatorPtr right;
+  JoinColumns columns;
+  JoinOutput output;
+  Observer observer;
+
+  bool buildIsLeft{false};
+  RowCollection buildRows;
+  std::vector<bool> matched;  // per build row
+  std::unordered_map<JoinKey, std::vector<size_t>, JoinKeyHash> table;
+  RowCollection probeRows;  // pulled while looking for the smaller side
+  size_t probePosition{0};
+  bool probeDone{false};
+
+  std::unique_ptr<Row> current;                // probe row being joined
+  const std::vector<size_t> *bucket{nullptr};  // build rows it matches
+  size_t position{0};                          // next one of them
+  size_t unmatched{0};  // next build row to check for padding
+  double seconds{0};
+};
+
+// USE: the same joins over inputs that both arrive in sortKeyOf order (an
+//      index scan, or an ExternalSortOperator). Both sides stream; only the
+//      right rows of the current key are held, so memory does not grow
+//      with the inputs.
+class MergeJoinOperator : public QueryOperator {
+ public:
+  using Observer = JoinOperator::Observer;
+
+  MergeJoinOperator(OperatorPtr aLeft, OperatorPtr aRight, const Join &aJoin,
+                    Observer anObserver = nullptr);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  // one row of a side with its key (hasKey false: NULL, matches nothing)
+  struct Cursor {
+    std::unique_ptr<Row> row;
+    std::string key;
+    bool hasKey{false};
+    bool ended{false};
+  };
+
+  StatusResult pull(bool isLeft, Cursor &aCursor);
+  // queue at least one output row, unless both sides are done
+  StatusResult fill();
+  // the next run of right rows sharing a key
+  StatusResult loadGroup();
+  // pad the rows of the group nothing matched, then drop it
+  void finishGroup();
+  void reset();
+
+  OperatorPtr left;
+  OperatorPtr right;
+  JoinColumns columns;
+  JoinOutput output;
+  Observer observer;
+
+  Cursor leftSide;
+  Cursor rightSide;  // lookahead past the group
+  RowCollection group;
+  std::vector<bool> matched;  // per group row
+  std::string groupKey;
+  std::deque<std::unique_ptr<Row>> pending;
+  bool done{false};
+  double seconds{0};
+};
+
+// USE: index nested loop join for inner and left joins. Each left row looks
+//      its probeField value up in an index of the join table (aProbe answers
+//      the blocks that may hold it), and only those rows are read and their
+//      join keys compared. Pays off when the left side is small: k left
+//      rows cost k lookups instead of a scan of the join table.
+class IndexJoinOperator : public QueryOperator {
+ public:
+  using Observer = JoinOperator::Observer;
+  using Probe = std::function<void(const Value &, BlockList &)>;
+
+  IndexJoinOperator(Database &aDatabase, OperatorPtr aLeft, const Join &aJoin,
+                    std::string aProbeField, Probe aProbe,
+                    Observer anObserver = nullptr);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  Database &database;
+  OperatorPtr left;
+  std::string table;
+  JoinColumns columns;
+  size_t probeColumn{0};  // position of the probe field in the join key
+  Probe probe;
+  JoinOutput output;
+  Observer observer;
+
+  std::unique_ptr<Row> current;  // left row being joined
+  JoinKey key;                   // its join key
+  BlockList blocks;              // its candidates still to read
+  bool matched{false};
+  double seconds{0};
+};
+
+}  // namespace ECE141
+
+#endif /* JoinOperators_hpp */
@@ -0,0 +1,187 @@
+/**
+ * @file KeyEncoder.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "KeyEncoder.hpp"
+
+#include <cstring>
+#include <type_traits>
+#include <variant>
+
+namespace ECE141 {
+
+template <typename T>
+static void appendBigEndian(std::string &aKey, T aBits) {
+  for (int i = static_cast<int>(sizeof(T)) - 1; i >= 0; i--) {
+    aKey.push_back(static_cast<char>((aBits >> (8 * i)) & 0xFF));
+  }
+}
+
+template <typename T>
+static T readBigEndian(const std::string &aKey, size_t aPos) {
+  T theBits{0};
+  for (size_t i = 0; i < sizeof(T) && aPos + i < aKey.size(); i++) {
+    theBits = static_cast<T>((theBits << 8) |
+                             static_cast<unsigned char>(aKey[aPos + i]));
+  }
+  return theBits;
+}
+
+std::string &KeyEncoder::append(std::string &aKey, const Value &aValue) {
+  std::visit(
+      [&](auto const &aVal) {
+        using T = std::decay_t<decltype(aVal)>;
+        if constexpr (std::is_same_v<T, bool>) {
+          aKey.push_back(kBoolTag);
+          aKey.push_back(static_cast<char>(aVal ? 1 : 0));
+        } else if constexpr (std::is_same_v<T, int>) {
+          aKey.push_back(kIntTag);
+          appendBigEndian(aKey, static_cast<uint32_t>(aVal) ^ 0x80000000U);
+        } else if constexpr (std::is_same_v<T, double>) {
+          uint64_t theBits{0};
+          std::memcpy(&theBits, &aVal, sizeof(theBits));
+          theBits = (theBits & 0x8000000000000000ULL)
+                        ? ~theBits
+                        : theBits ^ 0x8000000000000000ULL;
+          aKey.push_back(kDoubleTag);
+          appendBigEndian(aKey, theBits);
+        } else {
+          aKey.push_back(kStringTag);
+          for (char theChar : aVal) {
+            aKey.push_back(theChar);
+            if ('\0' == theChar) {
+              aKey.push_back('\xFF');
+            }
+          }
+          aKey.push_back('\0');
+          aKey.push_back('\x01');
+        }
+      },
+      aValue);
+  return aKey;
+}
+
+std::string &KeyEncoder::appendNull(std::string &aKey) {
+  aKey.push_back(kNullTag);
+  return aKey;
+}
+
+std::string KeyEncoder::encode(const ValuesList &aValues) {
+  std::string theKey;
+  for (const auto &theValue : aValues) {
+    append(theKey, theValue);
+  }
+  return theKey;
+}
+
+std::string &KeyEncoder::appendBlockNum(std::string &aKey,
+                                        uint32_t aBlockNum) {
+  appendBigEndian(aKey, aBlockNum);
+  return aKey;
+}
+
+uint32_t KeyEncoder::blockNumSuffix(const std::string &aKey) {
+  return (aKey.size() < sizeof(uint32_t))
+             ? 0
+             : readBigEndian<uint32_t>(aKey, aKey.size() - sizeof(uint32_t));
+}
+
+size_t KeyEncoder::decode(const std::string &aKey, size_t aPos,
+                          Value &aValue) {
+  if (aPos >= aKey.size()) {
+    return aKey.size();
+  }
+  switch (aKey[aPos++]) {
+    case kNullTag:
+      return aPos;
+    case kBoolTag:
+      aValue = (aPos < aKey.size()) && ('\0' != aKey[aPos]);
+      return aPos + 1;
+    case kIntTag:
+      aValue = static_cast<int>(readBigEndian<uint32_t>(aKey, aPos) ^
+                                0x80000000U);
+      return aPos + sizeof(uint32_t);
+    case kDoubleTag: {
+      auto theBits = readBigEndian<uint64_t>(aKey, aPos);
+      theBits = (theBits & 0x8000000000000000ULL)
+                    ? theBits ^ 0x8000000000000000ULL
+                    : ~theBits;
+      double theDouble{0};
+      std::memcpy(&theDouble, &theBits, sizeof(theDouble));
+      aValue = theDouble;
+      return aPos + sizeof(uint64_t);
+    }
+    case kStringTag: {
+      std::string theStr;
+      while (aPos < aKey.size()) {
+        char theChar = aKey[aPos++];
+        if ('\0' == theChar) {
+          if (aPos < aKey.size() && '\xFF' == aKey[aPos]) {
+            theStr.push_back('\0');
+            aPos++;
+            continue;
+          }
+          aPos++;  // skip terminator
+          break;
+        }
+        theStr.push_back(theChar);
+      }
+      aValue = theStr;
+      return aPos;
+    }
+    default:
+      return aKey.size();
+  }
+}
+
+ValuesList KeyEncoder::decode(const std::string &aKey, size_t aCount) {
+  ValuesList theValues;
+  size_t thePos{0};
+  while (theValues.size() < aCount && thePos < aKey.size()) {
+    Value theValue;
+    thePos = decode(aKey, thePos, theValue);
+    theValues.push_back(theValue);
+  }
+  return theValues;
+}
+
+bool KeyEncoder::isNull(const std::string &aKey, size_t aPos) {
+  return aPos < aKey.size() && kNullTag == aKey[aPos];
+}
+
+std::string KeyEncoder::upperBound(const std::string &aPrefix) {
+  return aPrefix + kMaxTag;
+}
+
+std::string KeyEncoder::toHex(const std::string &aKey) {
+  static const char *theDigits = "0123456789abcdef";
+  std::string theHex;
+  theHex.reserve(aKey.size() * 2);
+  for (unsigned char theChar : aKey) {
+    theHex.push_back(theDigits[theChar >> 4]);
+    theHex.push_back(theDigits[theChar & 0x0F]);
+  }
+  return theHex;
+}
+
+std::string KeyEncoder::fromHex(const std::string &aHex) {
+  auto toNibble = [](char aChar) {
+    return (aChar <= '9') ? aChar - '0' : aChar - 'a' + 10;
+  };
+  std::string theKey;
+  theKey.reserve(aHex.size() / 2);
+  for (size_t i = 0; i + 1 < aHex.size(); i += 2) {
+    theKey.push_back(
+        static_cast<char>((toNibble(aHex[i]) << 4) | toNibble(aHex[i + 1])));
+  }
+  return theKey;
+}
+
+}  // namespace ECE141
@@ -0,0 +1,69 @@
+/**
+ * @file KeyEncoder.hpp
+ * @author Yifan Wu
+ * @brief order-preserving byte encoding for (multi-column) index keys
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KeyEncoder_hpp
+#define KeyEncoder_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "BasicTypes.hpp"
+
+namespace ECE141 {
+
+// USE: encode Values so that comparing two encoded keys byte by byte (memcmp,
+//      or std::string::compare) gives the same order as comparing the values
+//      column by column. Every component starts with a type tag, so a key can
+//      be decoded again and a prefix of a key is a valid (shorter) key.
+//
+//   NULL   : tag 0x01, no bytes (sorts before every value)
+//   bool   : tag 'b' + 1 byte
+//   int    : tag 'i' + 4 bytes big-endian, sign bit flipped
+//   double : tag 'd' + 8 bytes big-endian, sign bit flipped (all bits if < 0)
+//   string : tag 's' + bytes (0x00 escaped as 0x00 0xFF) + 0x00 0x01
+class KeyEncoder {
+ public:
+  static constexpr char kNullTag{'\x01'};
+  static constexpr char kBoolTag{'b'};
+  static constexpr char kIntTag{'i'};
+  static constexpr char kDoubleTag{'d'};
+  static constexpr char kStringTag{'s'};
+  // sorts after every tag; append to a prefix to get its upper bound
+  static constexpr char kMaxTag{'\xFF'};
+
+  static std::string &append(std::string &aKey, const Value &aValue);
+  // a missing value (a column the row leaves out)
+  static std::string &appendNull(std::string &aKey);
+  static std::string encode(const ValuesList &aValues);
+
+  // row id suffix for non-unique keys (4 bytes big-endian)
+  static std::string &appendBlockNum(std::string &aKey, uint32_t aBlockNum);
+  static uint32_t blockNumSuffix(const std::string &aKey);
+
+  // decode one component starting at aPos; returns pos of next component.
+  // A NULL component leaves aValue as it is: check isNull() first
+  static size_t decode(const std::string &aKey, size_t aPos, Value &aValue);
+  // the first aCount components (a NULL one as a default Value)
+  static ValuesList decode(const std::string &aKey, size_t aCount);
+  static bool isNull(const std::string &aKey, size_t aPos);
+
+  // smallest key greater than every key starting with aPrefix
+  static std::string upperBound(const std::string &aPrefix);
+
+  // text-safe form for the (whitespace separated) index block image
+  static std::string toHex(const std::string &aKey);
+  static std::string fromHex(const std::string &aHex);
+};
+
+}  // namespace ECE141
+
+#endif /* KeyEncoder_hpp */
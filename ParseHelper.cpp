@@ -61,6 +61,9 @@ auto ParseHelper::parseAttributeOptions(Attribute &anAttribute)
           case Keywords::primary_kw:
             anAttribute.setPrimaryKey(true);
             break;
+          case Keywords::unique_kw:
+            anAttribute.setUnique(true);
+            break;
           case Keywords::not_kw:
             tokenizer.next();
             theToken = tokenizer.current();
@@ -85,6 +88,9 @@ auto ParseHelper::parseAttributeOptions(Attribute &anAttribute)
     }                  // switch
     tokenizer.next();  // skip ahead...
   }                    // while
+  if (anAttribute.isPrimaryKey()) {
+    anAttribute.setNullable(false);  // primary key implies NOT NULL
+  }
   return theResult;
 }
 
@@ -177,6 +183,20 @@ auto ParseHelper::parseOperator(Operators &anOp) -> StatusResult {
     if (Operators::unknown_op == anOp) {
       return {Errors::invalidOperator};
     }
+  } else if (theOpToken.type == TokenType::keyword) {
+    // LIKE / MATCH, optionally negated: `title not like '%sql%'`
+    bool isNegated{Keywords::not_kw == theOpToken.keyword &&
+                   tokenizer.remaining() > 1};
+    const Token &theWord = isNegated ? tokenizer.peek() : theOpToken;
+    if (Keywords::like_kw == theWord.keyword ||
+        Keywords::match_kw == theWord.keyword) {
+      anOp = Helpers::toOperator(theWord.data);
+      if (isNegated) {
+        anOp = Helpers::oppositeOpOf(anOp);
+        tokenizer.next();
+      }
+      tokenizer.next();
+    }
   }
   return {Errors::noError};
 }
@@ -0,0 +1,579 @@
+/**
+ * @file QueryOperators.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "QueryOperators.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+#include <variant>
+
+#include "Attribute.hpp"
+#include "BlockIO.hpp"
+#include "Config.hpp"
+#include "Database.hpp"
+#include "Helpers.hpp"
+#include "RowSorter.hpp"
+#include "Timer.hpp"
+
+namespace ECE141 {
+
+// ---------------------------------------------------------------------------
+IndexCursor::IndexCursor(Database &aDatabase, std::string anIndexKey,
+                         IndexKeyOpt aLow, IndexKeyOpt aHigh)
+    : database{aDatabase},
+      indexKey{std::move(anIndexKey)},
+      low{std::move(aLow)},
+      high{std::move(aHigh)} {}
+
+Index *IndexCursor::getIndex() { return database.getIndex(indexKey); }
+
+bool IndexCursor::next(IndexKey &aKey, uint32_t &aValue) {
+  if (batch.empty() && !refill()) {
+    return false;
+  }
+  std::tie(aKey, aValue) = std::move(batch.front());
+  batch.pop_front();
+  return true;
+}
+
+bool IndexCursor::refill() {
+  Index *theIndex = exhausted ? nullptr : getIndex();
+  if (nullptr == theIndex) {
+    return false;
+  }
+  // the resume key comes back first (bounds are inclusive): skip it
+  exhausted = theIndex->eachInRange(
+      last ? last : low, high, [&](const IndexKey &aKey, uint32_t aValue) {
+        if (last && aKey == *last) {
+          return true;
+        }
+        batch.emplace_back(aKey, aValue);
+        return batch.size() < kBatch;
+      });
+  if (!batch.empty()) {
+    last = batch.back().first;
+  }
+  return !batch.empty();
+}
+
+// ---------------------------------------------------------------------------
+ScanOperator::ScanOperator(Database &aDatabase, std::string aTableName,
+                           BlockFilter aFilter, bool aBuildZones)
+    : database{aDatabase},
+      tableName{std::move(aTableName)},
+      filter{std::move(aFilter)} {
+  if (aBuildZones) {
+    zones.emplace(static_cast<uint32_t>(Config::zoneBlocks));
+  }
+}
+
+StatusResult ScanOperator::open() {
+  if (!database.entityExistsInDB(tableName)) {
+    return {Errors::unknownTable};
+  }
+  entityId = Helpers::hashString(tableName);
+  blockNum = 0;
+  cursor.reset();
+  if (Config::useIndex() && nullptr != database.getIndex(tableName)) {
+    cursor.emplace(database, tableName);
+  }
+  return {Errors::noError};
+}
+
+std::optional<uint32_t> ScanOperator::nextBlock() {
+  if (cursor) {
+    IndexKey theKey;
+    uint32_t theBlockNum{0};
+    while (cursor->next(theKey, theBlockNum)) {
+      if (!filter || filter(theBlockNum)) {
+        return theBlockNum;
+      }
+    }
+    return std::nullopt;
+  }
+  Storage &theStorage = database.getStorage();
+  Block theBlock;
+  for (uint32_t theCount = theStorage.getBlockCount(); blockNum < theCount;) {
+    uint32_t theBlockNum = blockNum++;
+    if (theStorage.readBlock(theBlockNum, theBlock) &&
+        theBlock.isIdMatch(entityId) &&
+        theBlock.isTypeMatch(BlockType::data_block) &&
+        (!filter || filter(theBlockNum))) {
+      return theBlockNum;
+    }
+  }
+  return std::nullopt;
+}
+
+StatusResult ScanOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  std::optional<uint32_t> theBlockNum = nextBlock();
+  if (!theBlockNum) {
+    // a complete scan saw every row: its zone map is ready
+    if (zones) {
+      if (ZoneMap *theZoneMap = database.resetZoneMap(tableName)) {
+        *theZoneMap = std::move(*zones);
+      }
+      zones.reset();
+    }
+    return {Errors::noError};
+  }
+  StatusResult theResult =
+      database.getStorage().loadRow(*theBlockNum, aRow);
+  if (theResult && zones) {
+    zones->add(aRow->getData(), aRow->getBlockNum());
+  }
+  return theResult;
+}
+
+void ScanOperator::close() {
+  cursor.reset();
+  zones.reset();
+}
+
+// ---------------------------------------------------------------------------
+ParallelScanOperator::ParallelScanOperator(Database &aDatabase,
+                                           std::string aTableName,
+                                           const Filters &aFilters,
+                                           BlockFilter aBlockFilter,
+                                           Observer anObserver)
+    : database{aDatabase},
+      tableName{std::move(aTableName)},
+      filters{aFilters},
+      blockFilter{std::move(aBlockFilter)},
+      observer{std::move(anObserver)} {}
+
+ParallelScanOperator::~ParallelScanOperator() { stop(); }
+
+StatusResult ParallelScanOperator::open() {
+  stop();
+  if (!database.entityExistsInDB(tableName)) {
+    return {Errors::unknownTable};
+  }
+  Timer theTimer;
+  blocks.clear();
+  IndexCursor theCursor{database, tableName};
+  IndexKey theKey;
+  uint32_t theBlockNum{0};
+  while (theCursor.next(theKey, theBlockNum)) {
+    if (!blockFilter || blockFilter(theBlockNum)) {
+      blocks.push_back(theBlockNum);
+    }
+  }
+  size_t theMorselBlocks = std::max<size_t>(Config::morselBlocks, 1);
+  morsels = std::vector<Morsel>((blocks.size() + theMorselBlocks - 1) /
+                                theMorselBlocks);
+  submitted = current = position = 0;
+  seen = kept = 0;
+  window = 2 * std::max<size_t>(Config::scanWorkers, 1);
+  tasks = std::make_unique<TaskGroup>();
+  submit();
+  seconds = theTimer.elapsed();
+  return {Errors::noError};
+}
+
+void ParallelScanOperator::submit() {
+  size_t theEnd = std::min(morsels.size(), current + window);
+  for (; submitted < theEnd; submitted++) {
+    size_t theIndex = submitted;
+    tasks->run([this, theIndex] { scan(theIndex); });
+  }
+}
+
+void ParallelScanOperator::scan(size_t anIndex) {
+  size_t theMorselBlocks = std::max<size_t>(Config::morselBlocks, 1);
+  Storage &theStorage = database.getStorage();
+  Morsel theMorsel;
+  size_t theEnd = std::min(blocks.size(), (anIndex + 1) * theMorselBlocks);
+  for (size_t i = anIndex * theMorselBlocks;
+       i < theEnd && !tasks->isCancelled(); i++) {
+    std::stringstream theStream;
+    StorageInfo theInfo;
+    theMorsel.result = theStorage.load(theStream, theInfo, blocks[i]);
+    auto theRow = std::make_unique<Row>(theInfo.refId, blocks[i]);
+    if (!theMorsel.result ||
+        !(theMorsel.result = theRow->decode(theStream))) {
+      break;
+    }
+    theMorsel.seen++;
+    if (filters.matches(theRow->getData())) {
+      theMorsel.rows.push_back(std::move(theRow));
+    }
+  }
+  theMorsel.done = true;
+  {
+    std::lock_guard<std::mutex> theGuard(lock);
+    morsels[anIndex] = std::move(theMorsel);
+  }
+  finished.notify_all();
+}
+
+StatusResult ParallelScanOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  Timer theTimer;
+  StatusResult theResult{Errors::noError};
+  std::unique_lock<std::mutex> theGuard(lock);
+  while (current < morsels.size()) {
+    finished.wait(theGuard, [&] { return morsels[current].done; });
+    Morsel &theMorsel = morsels[current];
+    if (!(theResult = theMorsel.result)) {
+      break;
+    }
+    if (position < theMorsel.rows.size()) {
+      aRow = std::move(theMorsel.rows[position++]);
+      break;
+    }
+    seen += theMorsel.seen;
+    kept += theMorsel.rows.size();
+    theMorsel = Morsel{};  // release its rows
+    current++;
+    position = 0;
+    submit();
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void ParallelScanOperator::stop() {
+  if (tasks) {
+    tasks->cancel();
+    tasks->wait();
+    tasks.reset();
+  }
+}
+
+void ParallelScanOperator::close() {
+  stop();
+  morsels.clear();
+  blocks.clear();
+  if (observer) {
+    observer(seen, kept, seconds);
+  }
+}
+
+// ---------------------------------------------------------------------------
+IndexScanOperator::IndexScanOperator(Database &aDatabase, BlockList aBlocks)
+    : database{aDatabase}, blocks{std::move(aBlocks)} {}
+
+StatusResult IndexScanOperator::open() { return {Errors::noError}; }
+
+StatusResult IndexScanOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  if (blocks.empty()) {
+    return {Errors::noError};
+  }
+  uint32_t theBlockNum = blocks.front();
+  blocks.pop_front();
+  return database.getStorage().loadRow(theBlockNum, aRow);
+}
+
+void IndexScanOperator::close() { blocks.clear(); }
+
+// ---------------------------------------------------------------------------
+OrderedScanOperator::OrderedScanOperator(Database &aDatabase,
+                                         std::string anIndexKey)
+    : database{aDatabase}, indexKey{std::move(anIndexKey)} {}
+
+StatusResult OrderedScanOperator::open() {
+  if (nullptr == database.getIndex(indexKey)) {
+    return {Errors::unknownIndex};
+  }
+  cursor.emplace(database, indexKey);
+  return {Errors::noError};
+}
+
+StatusResult OrderedScanOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  IndexKey theKey;
+  uint32_t theBlockNum{0};
+  if (!cursor || !cursor->next(theKey, theBlockNum)) {
+    return {Errors::noError};
+  }
+  return database.getStorage().loadRow(theBlockNum, aRow);
+}
+
+void OrderedScanOperator::close() { cursor.reset(); }
+
+// ---------------------------------------------------------------------------
+IndexOnlyScanOperator::IndexOnlyScanOperator(Database &aDatabase,
+                                             std::string anIndexKey,
+                                             Entity anEntity, IndexKeyOpt aLow,
+                                             IndexKeyOpt aHigh)
+    : database{aDatabase},
+      indexKey{std::move(anIndexKey)},
+      entity{std::move(anEntity)},
+      low{std::move(aLow)},
+      high{std::move(aHigh)} {}
+
+StatusResult IndexOnlyScanOperator::open() {
+  cursor.emplace(database, indexKey, low, high);
+  return {Errors::noError};
+}
+
+StatusResult IndexOnlyScanOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  IndexKey theKey;
+  uint32_t theBlockNum{0};
+  if (!cursor || !cursor->next(theKey, theBlockNum)) {
+    return {Errors::noError};
+  }
+  Index *theIndex = cursor->getIndex();
+  if (nullptr == theIndex) {
+    return {Errors::unknownIndex};
+  }
+  aRow = std::make_unique<Row>(Helpers::hashString(entity.getName()),
+                               theBlockNum);
+  for (const auto &[theField, theValue] : theIndex->valuesOf(theKey)) {
+    aRow->insert(theField, theValue);
+  }
+  return {Errors::noError};
+}
+
+void IndexOnlyScanOperator::close() { cursor.reset(); }
+
+// ---------------------------------------------------------------------------
+FilterOperator::FilterOperator(OperatorPtr aChild, const Filters &aFilters,
+                               Observer anObserver)
+    : child{std::move(aChild)},
+      filters{aFilters},
+      observer{std::move(anObserver)} {}
+
+StatusResult FilterOperator::open() {
+  seen = kept = 0;
+  seconds = 0;
+  Timer theTimer;
+  StatusResult theResult = child->open();
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+StatusResult FilterOperator::next(std::unique_ptr<Row> &aRow) {
+  Timer theTimer;
+  StatusResult theResult{Errors::noError};
+  while ((theResult = child->next(aRow)) && aRow) {
+    seen++;
+    if (filters.matches(aRow->getData())) {
+      kept++;
+      break;
+    }
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void FilterOperator::close() {
+  child->close();
+  if (observer) {
+    observer(seen, kept, seconds);
+  }
+}
+
+// ---------------------------------------------------------------------------
+ProjectOperator::ProjectOperator(OperatorPtr aChild, StringList aFields)
+    : child{std::move(aChild)}, fields{std::move(aFields)} {}
+
+StatusResult ProjectOperator::open() { return child->open(); }
+
+StatusResult ProjectOperator::next(std::unique_ptr<Row> &aRow) {
+  StatusResult theResult = child->next(aRow);
+  if (theResult && aRow) {
+    KeyValues &theData = aRow->getData();
+    for (auto theIter = theData.begin(); theIter != theData.end();) {
+      bool isSelected = std::find(fields.begin(), fields.end(),
+                                  theIter->first) != fields.end();
+      theIter = isSelected ? std::next(theIter) : theData.erase(theIter);
+    }
+  }
+  return theResult;
+}
+
+void ProjectOperator::close() { child->close(); }
+
+// ---------------------------------------------------------------------------
+JoinOperator::JoinOperator(OperatorPtr anOuter, OperatorPtr anInner,
+                           const Join &aJoin, Observer anObserver)
+    : outer{std::move(anOuter)},
+      inner{std::move(anInner)},
+      join{aJoin},
+      terms{aJoin.exprs},
+      observer{std::move(anObserver)} {}
+
+StatusResult JoinOperator::open() {
+  Timer theTimer;
+  innerRows.clear();
+  current.reset();
+  nullRow.reset();
+  StatusResult theResult = inner->open();
+  std::unique_ptr<Row> theRow;
+  while (theResult && (theResult = inner->next(theRow)) && theRow) {
+    innerRows.push_back(std::move(theRow));
+  }
+  inner->close();
+  if (theResult && !innerRows.empty()) {
+    nullRow = std::make_unique<Row>(*innerRows.front());
+    nullRow->setAllNull();
+  }
+  if (theResult) {
+    theResult = outer->open();
+  }
+  seconds = theTimer.elapsed();
+  return theResult;
+}
+
+StatusResult JoinOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  // no join terms or no inner rows: nothing to join with
+  if (join.exprs.empty() || innerRows.empty()) {
+    return {Errors::noError};
+  }
+  Timer theTimer;
+  StatusResult theResult{Errors::noError};
+  while (!aRow) {
+    if (!current) {
+      if (!(theResult = outer->next(current)) || !current) {
+        break;
+      }
+      position = 0;
+      matched = false;
+    }
+    while (position < innerRows.size()) {
+      const Row &theInner = *innerRows[position++];
+      if (terms(current->getData(), theInner.getData())) {
+        aRow = std::make_unique<Row>(*current + theInner);
+        matched = true;
+        break;
+      }
+    }
+    if (!aRow && position >= innerRows.size()) {
+      if (!matched) {
+        aRow = std::make_unique<Row>(*current + *nullRow);
+      }
+      current.reset();
+    }
+  }
+  seconds += theTimer.elapsed();
+  return theResult;
+}
+
+void JoinOperator::close() {
+  outer->close();
+  innerRows.clear();
+  current.reset();
+  if (observer) {
+    observer(seconds);
+  }
+}
+
+// ---------------------------------------------------------------------------
+SortOperator::SortOperator(OperatorPtr aChild, StringList anOrder,
+                           size_t aLimit)
+    : child{std::move(aChild)}, order{std::move(anOrder)}, limit{aLimit} {}
+
+StatusResult SortOperator::open() {
+  rows.clear();
+  position = 0;
+  sorter.reset();
+  if (0 == limit) {
+    sorter = std::make_unique<RowSorter>(order, Config::sortMemoryBytes);
+  }
+  StatusResult theResult = child->open();
+  std::unique_ptr<Row> theRow;
+  while (theResult && (theResult = child->next(theRow)) && theRow) {
+    if (sorter) {
+      theResult = sorter->add(std::move(theRow));
+      continue;
+    }
+    rows.push_back(std::move(theRow));
+    if (rows.size() >= 2 * limit) {
+      RowSorter::sort(rows, order, limit);
+      rows.resize(limit);
+    }
+  }
+  child->close();
+  if (theResult) {
+    if (sorter) {
+      theResult = sorter->rewind();
+    } else {
+      RowSorter::sort(rows, order, limit);
+    }
+  }
+  return theResult;
+}
+
+StatusResult SortOperator::next(std::unique_ptr<Row> &aRow) {
+  if (sorter) {
+    return sorter->next(aRow);
+  }
+  aRow = (position < rows.size()) ? std::move(rows[position++]) : nullptr;
+  return {Errors::noError};
+}
+
+void SortOperator::close() {
+  rows.clear();
+  sorter.reset();
+}
+
+// ---------------------------------------------------------------------------
+ExternalSortOperator::ExternalSortOperator(Database &aDatabase,
+                                           OperatorPtr aChild,
+                                           KeyFunction aKeyOf)
+    : database{aDatabase}, child{std::move(aChild)}, keyOf{std::move(aKeyOf)} {}
+
+StatusResult ExternalSortOperator::open() {
+  sorter = std::make_unique<ExternalSorter>(Config::sortRunLimit);
+  StatusResult theResult = child->open();
+  std::unique_ptr<Row> theRow;
+  while (theResult && (theResult = child->next(theRow)) && theRow) {
+    theResult = sorter->add(keyOf(*theRow), theRow->getBlockNum());
+  }
+  child->close();
+  if (theResult) {
+    theResult = sorter->rewind();
+  }
+  return theResult;
+}
+
+StatusResult ExternalSortOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  IndexEntry theEntry;
+  if (!sorter || !sorter->next(theEntry)) {
+    return {Errors::noError};
+  }
+  return database.getStorage().loadRow(theEntry.second, aRow);
+}
+
+void ExternalSortOperator::close() { sorter.reset(); }
+
+// ---------------------------------------------------------------------------
+LimitOperator::LimitOperator(OperatorPtr aChild, size_t aLimit)
+    : child{std::move(aChild)}, limit{aLimit} {}
+
+StatusResult LimitOperator::open() {
+  count = 0;
+  return child->open();
+}
+
+StatusResult LimitOperator::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  if (count >= limit) {
+    return {Errors::noError};
+  }
+  StatusResult theResult = child->next(aRow);
+  if (aRow) {
+    count++;
+  }
+  return theResult;
+}
+
+void LimitOperator::close() { child->close(); }
+
+}  // namespace ECE141
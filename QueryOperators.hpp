@@ -0,0 +1,350 @@
+/**
+ * @file QueryOperators.hpp
+ * @author Yifan Wu
+ * @brief pull-based (open / next / close) operator tree of a select
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef QueryOperators_hpp
+#define QueryOperators_hpp
+
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicTypes.hpp"
+#include "Entity.hpp"
+#include "Errors.hpp"
+#include "ExternalSorter.hpp"
+#include "Filters.hpp"
+#include "Index.hpp"
+#include "Joins.hpp"
+#include "Row.hpp"
+#include "RowSorter.hpp"
+#include "Storage.hpp"
+#include "TaskScheduler.hpp"
+#include "ZoneMap.hpp"
+
+namespace ECE141 {
+
+class Database;
+
+// USE: one stage of a query. open() prepares it, every next() hands out one
+//      row (nullptr once it is exhausted) and close() releases what it
+//      holds. Rows flow up one at a time, so a plan only keeps the rows a
+//      stage needs all of (the inner side of a join, a sort).
+class QueryOperator {
+ public:
+  virtual ~QueryOperator() = default;
+
+  virtual StatusResult open() = 0;
+  virtual StatusResult next(std::unique_ptr<Row> &aRow) = 0;
+  virtual void close() = 0;
+};
+
+using OperatorPtr = std::unique_ptr<QueryOperator>;
+
+// USE: pages through (key, value) entries of an index, a batch at a time.
+//      Each refill looks the index up again by its map key and resumes after
+//      the last key handed out, so other lookups may evict and reload the
+//      index between batches.
+class IndexCursor {
+ public:
+  static constexpr size_t kBatch{64};
+
+  IndexCursor(Database &aDatabase, std::string anIndexKey,
+              IndexKeyOpt aLow = std::nullopt,
+              IndexKeyOpt aHigh = std::nullopt);
+
+  // false once every entry in [low, high] was handed out
+  bool next(IndexKey &aKey, uint32_t &aValue);
+  // the index being paged (nullptr if it was dropped)
+  Index *getIndex();
+
+ protected:
+  bool refill();
+
+  Database &database;
+  std::string indexKey;
+  IndexKeyOpt low;
+  IndexKeyOpt high;
+  std::optional<IndexKey> last;  // resume point (exclusive)
+  std::deque<std::pair<IndexKey, uint32_t>> batch;
+  bool exhausted{false};
+};
+
+// USE: every row of a table, in primary key order (in block order when
+//      indexes are off). Blocks aFilter rejects are not read. With
+//      aBuildZones the rows also fill a zone map, installed once the scan
+//      reaches the end.
+class ScanOperator : public QueryOperator {
+ public:
+  ScanOperator(Database &aDatabase, std::string aTableName,
+               BlockFilter aFilter = nullptr, bool aBuildZones = false);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  // next block number of the table, nullopt at the end
+  std::optional<uint32_t> nextBlock();
+
+  Database &database;
+  std::string tableName;
+  BlockFilter filter;
+  std::optional<IndexCursor> cursor;  // primary index, if used
+  uint32_t blockNum{0};               // brute force: next block to look at
+  uint32_t entityId{0};
+  std::optional<ZoneMap> zones;
+};
+
+// USE: a table scan with its where clause, run as TaskScheduler tasks. The
+//      blocks (primary key order, minus those aBlockFilter rejects) are cut
+//      into morsels of Config::morselBlocks, one task each, which decodes
+//      and filters its rows; next() hands the morsels out in order, so the
+//      rows come in scan order. next() keeps at most 2 * Config::scanWorkers
+//      morsels in flight ahead of it. Block reads share the storage stream,
+//      so they take turns; decoding and filtering run side by side. The
+//      observer is as FilterOperator's.
+class ParallelScanOperator : public QueryOperator {
+ public:
+  using Observer = std::function<void(size_t, size_t, double)>;
+
+  ParallelScanOperator(Database &aDatabase, std::string aTableName,
+                       const Filters &aFilters, BlockFilter aBlockFilter,
+                       Observer anObserver = nullptr);
+  ~ParallelScanOperator() override;
+
+  ParallelScanOperator(const ParallelScanOperator &) = delete;
+  ParallelScanOperator &operator=(const ParallelScanOperator &) = delete;
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  struct Morsel {
+    RowCollection rows;  // the ones the where clause holds for
+    size_t seen{0};
+    StatusResult result{Errors::noError};
+    bool done{false};
+  };
+
+  // submit morsels until the window past current is full
+  void submit();
+  void scan(size_t anIndex);
+  // cancel the morsels in flight and wait for them
+  void stop();
+
+  Database &database;
+  std::string tableName;
+  const Filters &filters;
+  BlockFilter blockFilter;
+  Observer observer;
+
+  std::vector<uint32_t> blocks;
+  std::vector<Morsel> morsels;
+  size_t submitted{0};  // morsels handed to the scheduler
+  size_t current{0};    // morsel next() reads from
+  size_t position{0};   // its next row
+  size_t window{0};     // morsels past current that may be in flight
+  std::mutex lock;  // guards morsels
+  std::condition_variable finished;  // a morsel is done
+  std::unique_ptr<TaskGroup> tasks;
+
+  size_t seen{0};
+  size_t kept{0};
+  double seconds{0};
+};
+
+// USE: the rows of known blocks (an access path's answer), in list order
+class IndexScanOperator : public QueryOperator {
+ public:
+  IndexScanOperator(Database &aDatabase, BlockList aBlocks);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  Database &database;
+  BlockList blocks;
+};
+
+// USE: the rows of a table in the order of one of its indexes (the
+//      primary, or a secondary one keyed "Table.index"), paged from the
+//      index so memory stays constant
+class OrderedScanOperator : public QueryOperator {
+ public:
+  OrderedScanOperator(Database &aDatabase, std::string anIndexKey);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  Database &database;
+  std::string indexKey;
+  std::optional<IndexCursor> cursor;
+};
+
+// USE: index-only scan: rows made of the entries of an index in [aLow,
+//      aHigh] (keys and included columns), no data block is read
+class IndexOnlyScanOperator : public QueryOperator {
+ public:
+  IndexOnlyScanOperator(Database &aDatabase, std::string anIndexKey,
+                        Entity anEntity, IndexKeyOpt aLow, IndexKeyOpt aHigh);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  Database &database;
+  std::string indexKey;
+  Entity entity;
+  IndexKeyOpt low;
+  IndexKeyOpt high;
+  std::optional<IndexCursor> cursor;
+};
+
+// USE: rows of the child the where clause holds for. An observer hears
+//      the rows pulled, the rows kept and the seconds spent pulling them
+//      when the filter closes.
+class FilterOperator : public QueryOperator {
+ public:
+  using Observer = std::function<void(size_t, size_t, double)>;
+
+  FilterOperator(OperatorPtr aChild, const Filters &aFilters,
+                 Observer anObserver = nullptr);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  OperatorPtr child;
+  const Filters &filters;
+  Observer observer;
+  size_t seen{0};
+  size_t kept{0};
+  double seconds{0};
+};
+
+// USE: trims rows to the select list
+class ProjectOperator : public QueryOperator {
+ public:
+  ProjectOperator(OperatorPtr aChild, StringList aFields);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  OperatorPtr child;
+  StringList fields;
+};
+
+// USE: nested loop join. The inner rows are read once, on open; each outer
+//      row comes out joined with every inner row the join terms match, or
+//      with an all-NULL inner row if none does. An observer hears the
+//      seconds spent when the join closes.
+class JoinOperator : public QueryOperator {
+ public:
+  using Observer = std::function<void(double)>;
+
+  JoinOperator(OperatorPtr anOuter, OperatorPtr anInner, const Join &aJoin,
+               Observer anObserver = nullptr);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  OperatorPtr outer;
+  OperatorPtr inner;
+  const Join &join;
+  CompiledFilter terms;  // of join.exprs
+  Observer observer;
+  RowCollection innerRows;
+  std::unique_ptr<Row> nullRow;
+  std::unique_ptr<Row> current;  // outer row being joined
+  size_t position{0};            // next inner row to try against it
+  bool matched{false};
+  double seconds{0};
+};
+
+// USE: orders the child's rows by the order by list. Without a limit the
+//      rows go through a RowSorter, which spills sorted runs to disk past
+//      Config::sortMemoryBytes. With a limit only the first aLimit rows are
+//      needed, so the buffer is cut back to them whenever it doubles.
+class SortOperator : public QueryOperator {
+ public:
+  SortOperator(OperatorPtr aChild, StringList anOrder, size_t aLimit = 0);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  OperatorPtr child;
+  StringList order;
+  size_t limit;
+  RowCollection rows;  // with a limit
+  size_t position{0};
+  std::unique_ptr<RowSorter> sorter;  // without one
+};
+
+// USE: the child's rows ordered by aKeyOf (byte order), for inputs too big
+//      to sort in memory. Only (key, block number) pairs are sorted, through
+//      an ExternalSorter, and rows are read again from their blocks, so the
+//      child must hand out stored rows (a scan of one table).
+class ExternalSortOperator : public QueryOperator {
+ public:
+  using KeyFunction = std::function<std::string(const Row &)>;
+
+  ExternalSortOperator(Database &aDatabase, OperatorPtr aChild,
+                       KeyFunction aKeyOf);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  Database &database;
+  OperatorPtr child;
+  KeyFunction keyOf;
+  std::unique_ptr<ExternalSorter> sorter;
+};
+
+// USE: stops after the first aLimit rows of the child
+class LimitOperator : public QueryOperator {
+ public:
+  LimitOperator(OperatorPtr aChild, size_t aLimit);
+
+  StatusResult open() override;
+  StatusResult next(std::unique_ptr<Row> &aRow) override;
+  void close() override;
+
+ protected:
+  OperatorPtr child;
+  size_t limit;
+  size_t count{0};
+};
+
+}  // namespace ECE141
+
+#endif /* QueryOperators_hpp */
@@ -0,0 +1,376 @@
+/**
+ * @file RoaringBitmap.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "RoaringBitmap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "Errors.hpp"
+#include "Helpers.hpp"
+#include "KeyEncoder.hpp"
+
+namespace ECE141 {
+
+static size_t popCount(uint64_t aWord) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(__builtin_popcountll(aWord));
+#else
+  size_t theCount{0};
+  for (; 0 != aWord; aWord &= aWord - 1) {
+    theCount++;
+  }
+  return theCount;
+#endif
+}
+
+static unsigned lowestBit(uint64_t aWord) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(aWord));
+#else
+  unsigned theBit{0};
+  for (; 0 == (aWord & 1); aWord >>= 1) {
+    theBit++;
+  }
+  return theBit;
+#endif
+}
+
+static size_t countBits(const std::vector<uint64_t> &aWords) {
+  size_t theCount{0};
+  for (uint64_t theWord : aWords) {
+    theCount += popCount(theWord);
+  }
+  return theCount;
+}
+
+// Container ------------------------------------------
+bool RoaringBitmap::Container::add(uint16_t aLow) {
+  if (isDense()) {
+    uint64_t &theWord = bits[aLow >> 6];
+    uint64_t theMask = uint64_t{1} << (aLow & 63);
+    if (0 != (theWord & theMask)) {
+      return false;
+    }
+    theWord |= theMask;
+  } else {
+    auto theIter = std::lower_bound(array.begin(), array.end(), aLow);
+    if (array.end() != theIter && *theIter == aLow) {
+      return false;
+    }
+    array.insert(theIter, aLow);
+  }
+  count++;
+  normalize();
+  return true;
+}
+
+bool RoaringBitmap::Container::remove(uint16_t aLow) {
+  if (isDense()) {
+    uint64_t &theWord = bits[aLow >> 6];
+    uint64_t theMask = uint64_t{1} << (aLow & 63);
+    if (0 == (theWord & theMask)) {
+      return false;
+    }
+    theWord &= ~theMask;
+  } else {
+    auto theIter = std::lower_bound(array.begin(), array.end(), aLow);
+    if (array.end() == theIter || *theIter != aLow) {
+      return false;
+    }
+    array.erase(theIter);
+  }
+  count--;
+  normalize();
+  return true;
+}
+
+bool RoaringBitmap::Container::contains(uint16_t aLow) const {
+  if (isDense()) {
+    return 0 != (bits[aLow >> 6] & (uint64_t{1} << (aLow & 63)));
+  }
+  return std::binary_search(array.begin(), array.end(), aLow);
+}
+
+void RoaringBitmap::Container::toDense() {
+  if (isDense()) {
+    return;
+  }
+  bits.assign(kWords, 0);
+  for (uint16_t theLow : array) {
+    bits[theLow >> 6] |= uint64_t{1} << (theLow & 63);
+  }
+  array.clear();
+  array.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::normalize() {
+  if (isDense() && count <= kArrayMax) {
+    array.clear();
+    array.reserve(count);
+    for (size_t i = 0; i < kWords; i++) {
+      for (uint64_t theWord = bits[i]; 0 != theWord; theWord &= theWord - 1) {
+        array.push_back(static_cast<uint16_t>(64 * i + lowestBit(theWord)));
+      }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+  } else if (!isDense() && count > kArrayMax) {
+    toDense();
+  }
+}
+
+auto RoaringBitmap::intersect(const Container &aLHS, const Container &aRHS)
+    -> Container {
+  Container theResult;
+  if (aLHS.isDense() && aRHS.isDense()) {
+    theResult.bits.resize(kWords);
+    for (size_t i = 0; i < kWords; i++) {
+      theResult.bits[i] = aLHS.bits[i] & aRHS.bits[i];
+    }
+    theResult.count = countBits(theResult.bits);
+  } else if (!aLHS.isDense() && !aRHS.isDense()) {
+    std::set_intersection(aLHS.array.begin(), aLHS.array.end(),
+                          aRHS.array.begin(), aRHS.array.end(),
+                          std::back_inserter(theResult.array));
+    theResult.count = theResult.array.size();
+  } else {
+    const Container &theSparse = aLHS.isDense() ? aRHS : aLHS;
+    const Container &theDense = aLHS.isDense() ? aLHS : aRHS;
+    std::copy_if(theSparse.array.begin(), theSparse.array.end(),
+                 std::back_inserter(theResult.array),
+                 [&](uint16_t aLow) { return theDense.contains(aLow); });
+    theResult.count = theResult.array.size();
+  }
+  theResult.normalize();
+  return theResult;
+}
+
+auto RoaringBitmap::unite(const Container &aLHS, const Container &aRHS)
+    -> Container {
+  Container theResult;
+  if (!aLHS.isDense() && !aRHS.isDense()) {
+    std::set_union(aLHS.array.begin(), aLHS.array.end(), aRHS.array.begin(),
+                   aRHS.array.end(), std::back_inserter(theResult.array));
+    theResult.count = theResult.array.size();
+  } else {
+    theResult = aLHS.isDense() ? aLHS : aRHS;
+    const Container &theOther = aLHS.isDense() ? aRHS : aLHS;
+    if (theOther.isDense()) {
+      for (size_t i = 0; i < kWords; i++) {
+        theResult.bits[i] |= theOther.bits[i];
+      }
+    } else {
+      for (uint16_t theLow : theOther.array) {
+        theResult.bits[theLow >> 6] |= uint64_t{1} << (theLow & 63);
+      }
+    }
+    theResult.count = countBits(theResult.bits);
+  }
+  theResult.normalize();
+  return theResult;
+}
+
+auto RoaringBitmap::subtract(const Container &aLHS, const Container &aRHS)
+    -> Container {
+  Container theResult;
+  if (!aLHS.isDense()) {
+    std::copy_if(aLHS.array.begin(), aLHS.array.end(),
+                 std::back_inserter(theResult.array),
+                 [&](uint16_t aLow) { return !aRHS.contains(aLow); });
+    theResult.count = theResult.array.size();
+  } else {
+    theResult = aLHS;
+    if (aRHS.isDense()) {
+      for (size_t i = 0; i < kWords; i++) {
+        theResult.bits[i] &= ~aRHS.bits[i];
+      }
+    } else {
+      for (uint16_t theLow : aRHS.array) {
+        theResult.bits[theLow >> 6] &= ~(uint64_t{1} << (theLow & 63));
+      }
+    }
+    theResult.count = countBits(theResult.bits);
+  }
+  theResult.normalize();
+  return theResult;
+}
+
+// RoaringBitmap --------------------------------------
+void RoaringBitmap::add(uint32_t aValue) {
+  containers[static_cast<uint16_t>(aValue >> 16)].add(
+      static_cast<uint16_t>(aValue & 0xFFFF));
+}
+
+void RoaringBitmap::remove(uint32_t aValue) {
+  auto theIter = containers.find(static_cast<uint16_t>(aValue >> 16));
+  if (containers.end() != theIter &&
+      theIter->second.remove(static_cast<uint16_t>(aValue & 0xFFFF)) &&
+      0 == theIter->second.count) {
+    containers.erase(theIter);
+  }
+}
+
+bool RoaringBitmap::contains(uint32_t aValue) const {
+  auto theIter = containers.find(static_cast<uint16_t>(aValue >> 16));
+  return containers.end() != theIter &&
+         theIter->second.contains(static_cast<uint16_t>(aValue & 0xFFFF));
+}
+
+size_t RoaringBitmap::cardinality() const {
+  size_t theCount{0};
+  for (const auto &[theHigh, theContainer] : containers) {
+    theCount += theContainer.count;
+  }
+  return theCount;
+}
+
+bool RoaringBitmap::isEmpty() const { return containers.empty(); }
+
+RoaringBitmap &RoaringBitmap::operator&=(const RoaringBitmap &aBitmap) {
+  for (auto theIter = containers.begin(); theIter != containers.end();) {
+    auto theOther = aBitmap.containers.find(theIter->first);
+    if (aBitmap.containers.end() != theOther) {
+      theIter->second = intersect(theIter->second, theOther->second);
+    }
+    theIter = (aBitmap.containers.end() == theOther ||
+               0 == theIter->second.count)
+                  ? containers.erase(theIter)
+                  : std::next(theIter);
+  }
+  return *this;
+}
+
+RoaringBitmap &RoaringBitmap::operator|=(const RoaringBitmap &aBitmap) {
+  for (const auto &[theHigh, theContainer] : aBitmap.containers) {
+    auto theIter = containers.find(theHigh);
+    if (containers.end() == theIter) {
+      containers.emplace(theHigh, theContainer);
+    } else {
+      theIter->second = unite(theIter->second, theContainer);
+    }
+  }
+  return *this;
+}
+
+RoaringBitmap &RoaringBitmap::operator-=(const RoaringBitmap &aBitmap) {
+  for (auto theIter = containers.begin(); theIter != containers.end();) {
+    auto theOther = aBitmap.containers.find(theIter->first);
+    if (aBitmap.containers.end() != theOther) {
+      theIter->second = subtract(theIter->second, theOther->second);
+    }
+    theIter = (0 == theIter->second.count) ? containers.erase(theIter)
+                                           : std::next(theIter);
+  }
+  return *this;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap &aBitmap) const {
+  if (containers.size() != aBitmap.containers.size()) {
+    return false;
+  }
+  return std::equal(
+      containers.begin(), containers.end(), aBitmap.containers.begin(),
+      [](const auto &aLHS, const auto &aRHS) {
+        return aLHS.first == aRHS.first &&
+               aLHS.second.array == aRHS.second.array &&
+               aLHS.second.bits == aRHS.second.bits;
+      });
+}
+
+bool RoaringBitmap::each(const std::function<bool(uint32_t)> &aVisitor) const {
+  for (const auto &[theHigh, theContainer] : containers) {
+    uint32_t theBase = static_cast<uint32_t>(theHigh) << 16;
+    if (theContainer.isDense()) {
+      for (size_t i = 0; i < kWords; i++) {
+        for (uint64_t theWord = theContainer.bits[i]; 0 != theWord;
+             theWord &= theWord - 1) {
+          if (!aVisitor(theBase + 64 * i + lowestBit(theWord))) {
+            return false;
+          }
+        }
+      }
+    } else {
+      for (uint16_t theLow : theContainer.array) {
+        if (!aVisitor(theBase + theLow)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// sparse containers: 'A' count, then deltas; dense ones: 'D' and the words
+// as hex
+StatusResult RoaringBitmap::encode(std::ostream &anOutput) const {
+  Helpers::encodeInto(anOutput, containers.size());
+  for (const auto &[theHigh, theContainer] : containers) {
+    Helpers::encodeInto(anOutput, theHigh);
+    if (theContainer.isDense()) {
+      std::string theBytes(kWords * sizeof(uint64_t), '\0');
+      std::memcpy(theBytes.data(), theContainer.bits.data(), theBytes.size());
+      Helpers::encodeInto(anOutput, 'D');
+      Helpers::encodeInto(anOutput, KeyEncoder::toHex(theBytes));
+    } else {
+      Helpers::encodeInto(anOutput, 'A');
+      Helpers::encodeInto(anOutput, theContainer.array.size());
+      uint16_t thePrev{0};
+      for (uint16_t theLow : theContainer.array) {
+        Helpers::encodeInto(anOutput, theLow - thePrev);
+        thePrev = theLow;
+      }
+    }
+  }
+  return {Errors::noError};
+}
+
+StatusResult RoaringBitmap::decode(std::istream &anInput) {
+  containers.clear();
+  size_t theCount{0};
+  Helpers::decodeFrom(anInput, theCount);
+  for (size_t i = 0; i < theCount; i++) {
+    uint16_t theHigh{0};
+    char theForm{0};
+    Helpers::decodeFrom(anInput, theHigh);
+    Helpers::decodeFrom(anInput, theForm);
+    Container &theContainer = containers[theHigh];
+    if ('D' == theForm) {
+      std::string theHex;
+      Helpers::decodeFrom(anInput, theHex);
+      std::string theBytes = KeyEncoder::fromHex(theHex);
+      if (theBytes.size() != kWords * sizeof(uint64_t)) {
+        return {Errors::readError};
+      }
+      theContainer.bits.resize(kWords);
+      std::memcpy(theContainer.bits.data(), theBytes.data(), theBytes.size());
+      theContainer.count = countBits(theContainer.bits);
+    } else {
+      size_t theSize{0};
+      Helpers::decodeFrom(anInput, theSize);
+      theContainer.array.resize(theSize);
+      uint32_t theLow{0};
+      for (auto &theValue : theContainer.array) {
+        uint32_t theDelta{0};
+        Helpers::decodeFrom(anInput, theDelta);
+        theLow += theDelta;
+        theValue = static_cast<uint16_t>(theLow);
+      }
+      theContainer.count = theSize;
+    }
+  }
+  return Helpers::checkStreamNotFail(anInput);
+}
+
+}  // namespace ECE141
@@ -0,0 +1,76 @@
+/**
+ * @file RoaringBitmap.hpp
+ * @author Yifan Wu
+ * @brief compressed bitmap of uint32_t (Roaring-style containers)
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef RoaringBitmap_hpp
+#define RoaringBitmap_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+namespace ECE141 {
+
+class StatusResult;
+
+// USE: the high 16 bits of a value pick a container, which holds the low 16
+//      bits either as a sorted array (sparse, <= 4096 values) or as a 65536
+//      bit bitmap (dense). AND/OR/AND-NOT work container by container, with
+//      whole 64-bit words at a time when both sides are dense.
+class RoaringBitmap {
+ public:
+  static constexpr size_t kArrayMax{4096};
+  static constexpr size_t kWords{1024};  // 65536 bits
+
+  void add(uint32_t aValue);
+  void remove(uint32_t aValue);
+  [[nodiscard]] bool contains(uint32_t aValue) const;
+  [[nodiscard]] size_t cardinality() const;
+  [[nodiscard]] bool isEmpty() const;
+
+  RoaringBitmap &operator&=(const RoaringBitmap &aBitmap);
+  RoaringBitmap &operator|=(const RoaringBitmap &aBitmap);
+  RoaringBitmap &operator-=(const RoaringBitmap &aBitmap);  // AND NOT
+  bool operator==(const RoaringBitmap &aBitmap) const;
+
+  // visit values in ascending order; stops when aVisitor returns false
+  bool each(const std::function<bool(uint32_t)> &aVisitor) const;
+
+  StatusResult encode(std::ostream &anOutput) const;
+  StatusResult decode(std::istream &anInput);
+
+ protected:
+  struct Container {
+    std::vector<uint16_t> array;  // sorted low bits (sparse form)
+    std::vector<uint64_t> bits;   // kWords words (dense form), else empty
+    size_t count{0};
+
+    [[nodiscard]] bool isDense() const { return !bits.empty(); }
+    bool add(uint16_t aLow);
+    bool remove(uint16_t aLow);
+    [[nodiscard]] bool contains(uint16_t aLow) const;
+    // switch form to the smaller one for the current count
+    void normalize();
+    void toDense();
+  };
+
+  static Container intersect(const Container &aLHS, const Container &aRHS);
+  static Container unite(const Container &aLHS, const Container &aRHS);
+  static Container subtract(const Container &aLHS, const Container &aRHS);
+
+  std::map<uint16_t, Container> containers;
+};
+
+}  // namespace ECE141
+
+#endif /* RoaringBitmap_hpp */
@@ -0,0 +1,365 @@
+/**
+ * @file RowSorter.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "RowSorter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <numeric>
+#include <utility>
+#include <variant>
+
+#include "Config.hpp"
+#include "KeyEncoder.hpp"
+#include "TaskScheduler.hpp"
+
+namespace ECE141 {
+
+// ---------------------------------------------------------------------------
+void LoserTree::reset(size_t aCount, Less aLess) {
+  count = aCount;
+  less = std::move(aLess);
+  losers.assign(std::max<size_t>(count, 1), 0);
+  // play the first round bottom up: node n's children are 2n and 2n + 1
+  std::vector<size_t> theWinners(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    theWinners[count + i] = i;
+  }
+  for (size_t n = count - 1; n > 0 && count > 1; n--) {
+    size_t theLeft = theWinners[2 * n];
+    size_t theRight = theWinners[2 * n + 1];
+    bool isRight = less(theRight, theLeft);
+    theWinners[n] = isRight ? theRight : theLeft;
+    losers[n] = isRight ? theLeft : theRight;
+  }
+  losers[0] = (count > 1) ? theWinners[1] : 0;
+}
+
+size_t LoserTree::winner() const { return losers[0]; }
+
+void LoserTree::replay(size_t aSource) {
+  size_t theWinner = aSource;
+  for (size_t n = (aSource + count) / 2; n > 0; n /= 2) {
+    if (less(losers[n], theWinner)) {
+      std::swap(losers[n], theWinner);
+    }
+  }
+  losers[0] = theWinner;
+}
+
+// ---------------------------------------------------------------------------
+// sort key of a row: per order by column, the Value's type (a column missing
+// from the row sorts first) and its KeyEncoder bytes. Keys compare bytewise
+// in the order Values compare.
+static std::string orderKeyOf(const Row &aRow, const StringList &anOrder) {
+  std::string theKey;
+  const KeyValues &theData = aRow.getData();
+  for (const std::string &theField : anOrder) {
+    auto theIt = theData.find(theField);
+    if (theIt == theData.end()) {
+      theKey += '\0';
+      continue;
+    }
+    theKey += static_cast<char>(1 + theIt->second.index());
+    KeyEncoder::append(theKey, theIt->second);
+  }
+  return theKey;
+}
+
+// run aTask over [begin, end) slices of aCount, as TaskScheduler tasks
+static void eachSlice(size_t aCount, size_t aSliceSize,
+                      const std::function<void(size_t, size_t)> &aTask) {
+  if (aCount <= aSliceSize) {
+    aTask(0, aCount);
+    return;
+  }
+  TaskGroup theTasks;
+  for (size_t theBegin = 0; theBegin < aCount; theBegin += aSliceSize) {
+    size_t theEnd = std::min(aCount, theBegin + aSliceSize);
+    theTasks.run([&aTask, theBegin, theEnd] { aTask(theBegin, theEnd); });
+  }
+}
+
+// Keys are made once per row, then a permutation is sorted: slices of
+// Config::sortChunkRows rows in parallel, merged pairwise in parallel
+// rounds. aKeys gets the keys in the rows' new order.
+static void sortKeyed(RowCollection &aRows, const StringList &anOrder,
+                      size_t aLimit, std::vector<std::string> &aKeys) {
+  size_t theCount = aRows.size();
+  size_t theSlice = std::max<size_t>(Config::sortChunkRows, 1);
+  std::vector<std::string> theKeys(theCount);
+  eachSlice(theCount, theSlice, [&](size_t aBegin, size_t anEnd) {
+    for (size_t i = aBegin; i < anEnd; i++) {
+      theKeys[i] = orderKeyOf(*aRows[i], anOrder);
+    }
+  });
+  std::vector<size_t> theOrder(theCount);
+  std::iota(theOrder.begin(), theOrder.end(), 0);
+  auto cmp = [&](size_t a, size_t b) {
+    int theCompare = theKeys[a].compare(theKeys[b]);
+    return theCompare < 0 || (0 == theCompare && a < b);
+  };
+  auto theBegin = theOrder.begin();
+  if (aLimit > 0 && aLimit < theCount) {
+    std::partial_sort(theBegin, theBegin + static_cast<long>(aLimit),
+                      theOrder.end(), cmp);
+  } else {
+    eachSlice(theCount, theSlice, [&](size_t aFirst, size_t anEnd) {
+      std::sort(theBegin + static_cast<long>(aFirst),
+                theBegin + static_cast<long>(anEnd), cmp);
+    });
+    for (size_t theRun = theSlice; theRun < theCount; theRun *= 2) {
+      eachSlice(theCount, 2 * theRun, [&](size_t aFirst, size_t anEnd) {
+        size_t theMiddle = std::min(anEnd, aFirst + theRun);
+        std::inplace_merge(theBegin + static_cast<long>(aFirst),
+                           theBegin + static_cast<long>(theMiddle),
+                           theBegin + static_cast<long>(anEnd), cmp);
+      });
+    }
+  }
+  RowCollection theSorted;
+  theSorted.reserve(theCount);
+  aKeys.clear();
+  aKeys.reserve(theCount);
+  for (size_t theIndex : theOrder) {
+    theSorted.push_back(std::move(aRows[theIndex]));
+    aKeys.push_back(std::move(theKeys[theIndex]));
+  }
+  aRows.swap(theSorted);
+}
+
+void RowSorter::sort(RowCollection &aRows, const StringList &anOrder,
+                     size_t aLimit) {
+  if (!anOrder.empty() && aRows.size() > 1) {
+    std::vector<std::string> theKeys;
+    sortKeyed(aRows, anOrder, aLimit, theKeys);
+  }
+}
+
+// ---------------------------------------------------------------------------
+RowSorter::RowSorter(StringList anOrder, size_t aMemoryLimit)
+    : order{std::move(anOrder)},
+      memoryLimit{std::max<size_t>(aMemoryLimit, 1)} {}
+
+RowSorter::~RowSorter() {
+  for (auto &theRun : runs) {
+    theRun->file.close();
+    std::error_code theError;
+    std::filesystem::remove(theRun->path, theError);
+  }
+}
+
+size_t RowSorter::getRunCount() const { return runs.size(); }
+
+// rough heap footprint: the row, plus a map node per field
+size_t RowSorter::bytesOf(const Row &aRow) {
+  constexpr size_t kNodeBytes{64};
+  size_t theBytes = sizeof(Row);
+  for (const auto &[theName, theValue] : aRow.getData()) {
+    theBytes += kNodeBytes + sizeof(Value) + theName.size();
+    if (const auto *theString = std::get_if<std::string>(&theValue)) {
+      theBytes += theString->size();
+    }
+  }
+  return theBytes;
+}
+
+StatusResult RowSorter::add(std::unique_ptr<Row> aRow) {
+  bytes += bytesOf(*aRow);
+  rows.push_back(std::move(aRow));
+  if (bytes >= memoryLimit) {
+    return spill();
+  }
+  return {Errors::noError};
+}
+
+StatusResult RowSorter::spill() {
+  static std::atomic<size_t> theRunFiles{0};
+  auto theRun = std::make_unique<Run>();
+  theRun->path =
+      Config::getStoragePath() + "/sort-" +
+      std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count()) +
+      "-" + std::to_string(theRunFiles++) + ".run";
+  theRun->file.open(theRun->path, std::ios::in | std::ios::out |
+                                      std::ios::trunc | std::ios::binary);
+  if (!theRun->file.is_open()) {
+    return {Errors::writeError};
+  }
+  std::vector<std::string> theKeys;
+  sortKeyed(rows, order, 0, theKeys);
+  for (size_t i = 0; i < rows.size(); i++) {
+    writeRow(theRun->file, theKeys[i], *rows[i]);
+  }
+  theRun->file.flush();
+  runs.push_back(std::move(theRun));
+  if (!runs.back()->file) {
+    return {Errors::writeError};
+  }
+  rows.clear();
+  bytes = 0;
+  return {Errors::noError};
+}
+
+StatusResult RowSorter::rewind() {
+  position = 0;
+  if (runs.empty()) {
+    sort(rows, order);
+    return {Errors::noError};
+  }
+  if (!rows.empty()) {
+    if (StatusResult theResult = spill(); !theResult) {
+      return theResult;
+    }
+  }
+  for (auto &theRun : runs) {
+    theRun->file.clear();
+    theRun->file.seekg(0);
+    theRun->ended = false;
+    if (StatusResult theResult = pull(*theRun); !theResult) {
+      return theResult;
+    }
+  }
+  tree.reset(runs.size(), [this](size_t a, size_t b) {
+    if (runs[a]->ended || runs[b]->ended) {
+      return !runs[a]->ended;
+    }
+    int theCompare = runs[a]->key.compare(runs[b]->key);
+    return theCompare < 0 || (0 == theCompare && a < b);
+  });
+  return {Errors::noError};
+}
+
+StatusResult RowSorter::pull(Run &aRun) {
+  if (!readRow(aRun.file, aRun.key, aRun.row)) {
+    aRun.row.reset();
+    aRun.ended = true;
+    if (!aRun.file.eof()) {
+      return {Errors::readError};
+    }
+  }
+  return {Errors::noError};
+}
+
+StatusResult RowSorter::next(std::unique_ptr<Row> &aRow) {
+  aRow.reset();
+  if (runs.empty()) {
+    if (position < rows.size()) {
+      aRow = std::move(rows[position++]);
+    }
+    return {Errors::noError};
+  }
+  size_t theWinner = tree.winner();
+  Run &theRun = *runs[theWinner];
+  if (theRun.ended) {
+    return {Errors::noError};
+  }
+  aRow = std::move(theRun.row);
+  StatusResult theResult = pull(theRun);
+  tree.replay(theWinner);
+  return theResult;
+}
+
+// run record: key (length + bytes), entity id, block number, field count,
+// then per field its name (length + bytes), type index and value
+template <typename T>
+static void writeRaw(std::ostream &anOutput, const T &aValue) {
+  anOutput.write(reinterpret_cast<const char *>(&aValue), sizeof(aValue));
+}
+
+template <typename T>
+static bool readRaw(std::istream &anInput, T &aValue) {
+  return static_cast<bool>(
+      anInput.read(reinterpret_cast<char *>(&aValue), sizeof(aValue)));
+}
+
+static void writeString(std::ostream &anOutput, const std::string &aString) {
+  writeRaw(anOutput, static_cast<uint32_t>(aString.size()));
+  anOutput.write(aString.data(), static_cast<std::streamsize>(aString.size()));
+}
+
+static bool readString(std::istream &anInput, std::string &aString) {
+  uint32_t theLength{0};
+  if (!readRaw(anInput, theLength)) {
+    return false;
+  }
+  aString.resize(theLength);
+  return static_cast<bool>(anInput.read(aString.data(), theLength));
+}
+
+void RowSorter::writeRow(std::ostream &anOutput, const std::string &aKey,
+                         const Row &aRow) {
+  writeString(anOutput, aKey);
+  writeRaw(anOutput, aRow.getEntityId());
+  writeRaw(anOutput, aRow.getBlockNum());
+  writeRaw(anOutput, static_cast<uint32_t>(aRow.getData().size()));
+  for (const auto &[theName, theValue] : aRow.getData()) {
+    writeString(anOutput, theName);
+    writeRaw(anOutput, static_cast<uint8_t>(theValue.index()));
+    std::visit(
+        [&](const auto &aValue) {
+          using T = std::decay_t<decltype(aValue)>;
+          if constexpr (std::is_same_v<T, std::string>) {
+            writeString(anOutput, aValue);
+          } else {
+            writeRaw(anOutput, aValue);
+          }
+        },
+        theValue);
+  }
+}
+
+bool RowSorter::readRow(std::istream &anInput, std::string &aKey,
+                        std::unique_ptr<Row> &aRow) {
+  uint32_t theEntityId{0};
+  uint32_t theBlockNum{0};
+  uint32_t theCount{0};
+  if (!readString(anInput, aKey) || !readRaw(anInput, theEntityId) ||
+      !readRaw(anInput, theBlockNum) || !readRaw(anInput, theCount)) {
+    return false;
+  }
+  aRow = std::make_unique<Row>(theEntityId, theBlockNum);
+  std::string theName;
+  for (uint32_t i = 0; i < theCount; i++) {
+    uint8_t theType{0};
+    if (!readString(anInput, theName) || !readRaw(anInput, theType)) {
+      return false;
+    }
+    Value theValue;
+    bool isRead{false};
+    if (0 == theType) {
+      bool theBool{false};
+      isRead = readRaw(anInput, theBool);
+      theValue = theBool;
+    } else if (1 == theType) {
+      int theInt{0};
+      isRead = readRaw(anInput, theInt);
+      theValue = theInt;
+    } else if (2 == theType) {
+      double theDouble{0};
+      isRead = readRaw(anInput, theDouble);
+      theValue = theDouble;
+    } else if (3 == theType) {
+      std::string theString;
+      isRead = readString(anInput, theString);
+      theValue = std::move(theString);
+    }
+    if (!isRead) {
+      return false;
+    }
+    aRow->insert(theName, theValue);
+  }
+  return true;
+}
+
+}  // namespace ECE141
@@ -0,0 +1,104 @@
+/**
+ * @file RowSorter.hpp
+ * @author Yifan Wu
+ * @brief order by: rows sorted on byte keys, spilled to runs past a budget
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef RowSorter_hpp
+#define RowSorter_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BasicTypes.hpp"
+#include "Errors.hpp"
+#include "Row.hpp"
+
+namespace ECE141 {
+
+// USE: k-way merge selection. Each inner node keeps the loser of the match
+//      below it, so after the winner's source moves on, replay() plays only
+//      the matches on its path to the root: log2(k) comparisons, one per
+//      level, instead of a heap's two.
+class LoserTree {
+ public:
+  // is source a's head before source b's (an ended source never is)
+  using Less = std::function<bool(size_t, size_t)>;
+
+  void reset(size_t aCount, Less aLess);
+  [[nodiscard]] size_t winner() const;
+  // aSource (the winner) has a new head
+  void replay(size_t aSource);
+
+ protected:
+  size_t count{0};
+  std::vector<size_t> losers;  // [0] is the winner; leaves are count + i
+  Less less;
+};
+
+// USE: the rows of an order by, in order. add() rows in any order; while
+//      they fit in aMemoryLimit bytes they stay in memory, and past it they
+//      are sorted and written as a run to a temp file in the storage
+//      directory. rewind() sorts what is left, and next() hands the rows out,
+//      from memory or by merging the runs through a LoserTree. Ties keep
+//      their add() order.
+class RowSorter {
+ public:
+  RowSorter(StringList anOrder, size_t aMemoryLimit);
+  ~RowSorter();  // removes the run files
+
+  RowSorter(const RowSorter &) = delete;
+  RowSorter &operator=(const RowSorter &) = delete;
+
+  // order aRows in memory; if aLimit, only the first aLimit of them
+  static void sort(RowCollection &aRows, const StringList &anOrder,
+                   size_t aLimit = 0);
+
+  StatusResult add(std::unique_ptr<Row> aRow);
+  StatusResult rewind();
+  StatusResult next(std::unique_ptr<Row> &aRow);
+
+  [[nodiscard]] size_t getRunCount() const;
+
+ protected:
+  struct Run {
+    std::string path;
+    std::fstream file;
+    std::string key;  // head row and its sort key
+    std::unique_ptr<Row> row;
+    bool ended{false};
+  };
+
+  // sort the buffered rows and write them out as one run
+  StatusResult spill();
+  StatusResult pull(Run &aRun);
+
+  static size_t bytesOf(const Row &aRow);
+  static void writeRow(std::ostream &anOutput, const std::string &aKey,
+                       const Row &aRow);
+  static bool readRow(std::istream &anInput, std::string &aKey,
+                      std::unique_ptr<Row> &aRow);
+
+  StringList order;
+  size_t memoryLimit;
+  size_t bytes{0};  // estimated size of the buffered rows
+  RowCollection rows;
+  size_t position{0};
+  std::vector<std::unique_ptr<Run>> runs;
+  LoserTree tree;
+};
+
+}  // namespace ECE141
+
+#endif /* RowSorter_hpp */
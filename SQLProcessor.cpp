@@ -73,6 +73,14 @@ Statement* showIdxStmtFactory(DBProcessor* aDbp) {
   return new ShowIdxStatement(aDbp);
 }
 
+Statement* createIdxStmtFactory(DBProcessor* aDbp) {
+  return new CreateIndexStatement(aDbp);
+}
+
+Statement* analyzeTableStmtFactory(DBProcessor* aDbp) {
+  return new AnalyzeTableStatement(aDbp);
+}
+
 // ---------------------------------------------------------------
 // SQLProcessor class
 SQLProcessor::SQLProcessor(std::ostream& anOutput, DBProcessor* aDbp)
@@ -86,7 +94,9 @@ Database* SQLProcessor ::getActiveDB() {
 
 // virtual --------------------------------------
 CmdProcessor* SQLProcessor::recognizes(Tokenizer& aTokenizer) {
-  if (CreateTableStatement::recognize(aTokenizer) ||
+  if (AnalyzeTableStatement::recognize(aTokenizer) ||
+      CreateTableStatement::recognize(aTokenizer) ||
+      CreateIndexStatement::recognize(aTokenizer) ||
       ShowTableStatement::recognize(aTokenizer) ||
       DropTableStatement::recognize(aTokenizer) ||
       DescribeTableStatement::recognize(aTokenizer) ||
@@ -109,6 +119,7 @@ using KeywordPair = std::pair<Keywords, Keywords>;
 Statement* SQLProcessor::makeStatement(Tokenizer& aTokenizer,
                                        [[maybe_unused]] StatusResult& aResult) {
   static std::map<Keywords, TableStmtFactory> factories{
+      {Keywords::analyze_kw, analyzeTableStmtFactory},
       {Keywords::create_kw, createTableStmtFactory},
       {Keywords::delete_kw, deleteRowStmtFactory},
       {Keywords::describe_kw, describeTableStmtFactory},
@@ -118,27 +129,33 @@ Statement* SQLProcessor::makeStatement(Tokenizer& aTokenizer,
       {Keywords::update_kw, updateRowStmtFactory},
   };
 
-  static std::map<KeywordPair, TableStmtFactory> showFactories{
+  // two-keyword statements; checked first so "create index" wins over
+  // "create table"
+  static std::map<KeywordPair, TableStmtFactory> pairFactories{
+      {{Keywords::create_kw, Keywords::bitmap_kw}, createIdxStmtFactory},
+      {{Keywords::create_kw, Keywords::fulltext_kw}, createIdxStmtFactory},
+      {{Keywords::create_kw, Keywords::index_kw}, createIdxStmtFactory},
+      {{Keywords::create_kw, Keywords::unique_kw}, createIdxStmtFactory},
       {{Keywords::show_kw, Keywords::index_kw}, showIdxStmtFactory},
       {{Keywords::show_kw, Keywords::indexes_kw}, showAllIdxStmtFactory},
       {{Keywords::show_kw, Keywords::tables_kw}, showTablesStmtFactory},
   };
 
   const Keywords& theFirstKW = aTokenizer.current().keyword;
-  if (factories.find(theFirstKW) != factories.end()) {
-    if (Statement* theStatement = (factories.at(theFirstKW))(dbp)) {
+  const Keywords theSecondKW = (aTokenizer.remaining() > 1)
+                                   ? aTokenizer.peek(1).keyword
+                                   : Keywords::unknown_kw;
+  KeywordPair theKVPair = std::make_pair(theFirstKW, theSecondKW);
+  if (pairFactories.find(theKVPair) != pairFactories.end()) {
+    if (Statement* theStatement = pairFactories.at(theKVPair)(dbp)) {
       if (theStatement->parse(aTokenizer)) {
         return theStatement;
       }
     }
-  } else {
-    const Keywords& theSecondKW = aTokenizer.peek(1).keyword;
-    KeywordPair theKVPair = std::make_pair(theFirstKW, theSecondKW);
-    if (showFactories.find(theKVPair) != showFactories.end()) {
-      if (Statement* theStatement = showFactories.at(theKVPair)(dbp)) {
-        if (theStatement->parse(aTokenizer)) {
-          return theStatement;
-        }
+  } else if (factories.find(theFirstKW) != factories.end()) {
+    if (Statement* theStatement = (factories.at(theFirstKW))(dbp)) {
+      if (theStatement->parse(aTokenizer)) {
+        return theStatement;
       }
     }
   }
@@ -146,14 +163,20 @@ Statement* SQLProcessor::makeStatement(Tokenizer& aTokenizer,
 }
 
 // new ----------------------------------------------------------
-// at the beginning the rowCollections is just empty
-StatusResult SQLProcessor::showQuery(const DBQuery& aQuery,
-                                     RowCollection& aCollection) {
+// rows go from the operator tree to the output one at a time
+StatusResult SQLProcessor::showQuery(const DBQuery& aQuery) {
   StatusResult theResult{Errors::noDatabaseInUse};
   if (auto* theActiveDB = getActiveDB()) {
-    theResult = theActiveDB->selectRow(aQuery, aCollection);
-    TabularView theTableView(output, aCollection, aQuery.getFieldList());
-    theTableView.show();
+    OperatorPtr thePlan;
+    TabularView theTableView(output, aQuery.getFieldList());
+    if ((theResult = theActiveDB->makePlan(aQuery, thePlan, true)) &&
+        (theResult = thePlan->open())) {
+      theResult = theTableView.show(*thePlan);
+      thePlan->close();
+    } else {
+      theTableView.layout();
+      theTableView.show();  // the empty table
+    }
   }
   return theResult;
 }
@@ -163,8 +186,11 @@ StatusResult SQLProcessor::updateQuery(const DBQuery& aQuery,
   StatusResult theResult{Errors::noDatabaseInUse};
   if (auto* theActiveDB = getActiveDB()) {
     theResult = theActiveDB->updateRow(aQuery, aCollection);
-    TabularView theTableView(output, aCollection, aQuery.getFieldList());
-    theTableView.showFooter(aCollection.size(), Config::getTimer().elapsed());
+    if (theResult) {
+      TabularView theTableView(output, aCollection, aQuery.getFieldList());
+      theTableView.showFooter(aCollection.size(),
+                              Config::getTimer().elapsed());
+    }
   }
   return theResult;
 }
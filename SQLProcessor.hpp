@@ -56,7 +56,7 @@ class SQLProcessor : public CmdProcessor {
   Database* getActiveDB();
 
   // new ---------------------------------------------------------------
-  StatusResult showQuery(const DBQuery& aQuery, RowCollection& aCollection);
+  StatusResult showQuery(const DBQuery& aQuery);
   StatusResult updateQuery(const DBQuery& aQuery, RowCollection& aCollection);
   StatusResult deleteQuery(const DBQuery& aQuery, RowCollection& aCollection);
 
@@ -24,6 +24,7 @@
 #include "Errors.hpp"
 #include "Filters.hpp"
 #include "Helpers.hpp"
+#include "Index.hpp"
 #include "ParseHelper.hpp"
 #include "Row.hpp"
 #include "SQLProcessor.hpp"
@@ -407,8 +408,7 @@ StatusResult SelectStatement::run(
   if (nullptr == dbp->getActiveDB()) {
     return {Errors::noDatabaseInUse};
   }
-  RowCollection theRows;
-  return dbp->getSqlProcessor().showQuery(query, theRows);
+  return dbp->getSqlProcessor().showQuery(query);
 }
 
 // * UPDATE Users set zipcode="12345" WHERE id=10;
@@ -544,6 +544,7 @@ StatusResult ShowAllIdxStatement::run(
 // ---------------------------------------------------------------------------
 // * 6. show index {attr-name} from {table-name}
 // show index id from Users;
+// show index advice;
 ShowIdxStatement::ShowIdxStatement(DBProcessor *aDbp)
     : SelectStatement{aDbp, Keywords::show_kw} {}
 
@@ -551,6 +552,14 @@ StatusResult ShowIdxStatement::parse(Tokenizer &aTokenizer) {
   TokenSequencer theSeq{aTokenizer};
   ParseHelper theParseHelper{aTokenizer};
 
+  if (aTokenizer.remaining() > 2 &&
+      TokenSequencer{aTokenizer}.currentIsNoSkip(
+          {Keywords::show_kw, Keywords::index_kw, Keywords::advice_kw})) {
+    advice = true;
+    aTokenizer.next(3);
+    aTokenizer.skipIf(semicolon);
+    return {Errors::noError};
+  }
   StatusResult theResult{Errors::identifierExpected};
   while (aTokenizer.remaining()) {
     if (theSeq.currentIs({Keywords::show_kw, Keywords::index_kw})) {
@@ -575,7 +584,127 @@ bool ShowIdxStatement::recognize(Tokenizer &aTokenizer) {
 
 StatusResult ShowIdxStatement::run(
     [[maybe_unused]] std::ostream &anOutput) const {
+  if (advice) {
+    return dbp->showIndexAdvice();
+  }
   return dbp->showIndexFromTable(tableName, fieldList);
 }
 
+// ---------------------------------------------------------------------------
+// * 8. create index {index-name} on {table-name} ({attr-name}, ...)
+// create index user_title on Books (user_id, title);
+// create bitmap index by_zip on Users (zip);
+// create fulltext index by_words on Books (title);
+CreateIndexStatement::CreateIndexStatement(DBProcessor *aDbp)
+    : SQLStatement{aDbp, Keywords::create_kw} {}
+
+bool CreateIndexStatement::recognize(Tokenizer &aTokenizer) {
+  TokenSequencer theSeq(aTokenizer);
+  return theSeq.currentIsNoSkip({Keywords::create_kw, Keywords::index_kw}) ||
+         theSeq.clear().currentIsNoSkip(
+             {Keywords::create_kw, Keywords::unique_kw, Keywords::index_kw}) ||
+         theSeq.clear().currentIsNoSkip(
+             {Keywords::create_kw, Keywords::bitmap_kw, Keywords::index_kw}) ||
+         theSeq.clear().currentIsNoSkip(
+             {Keywords::create_kw, Keywords::fulltext_kw, Keywords::index_kw});
+}
+
+StatusResult CreateIndexStatement::parse(Tokenizer &aTokenizer) {
+  TokenSequencer theSeq{aTokenizer};
+  ParseHelper theParseHelper{aTokenizer};
+
+  StatusResult theResult{Errors::identifierExpected};
+  if (theSeq.currentIs({Keywords::create_kw})) {
+    unique = aTokenizer.skipIf(Keywords::unique_kw);
+    bitmap = !unique && aTokenizer.skipIf(Keywords::bitmap_kw);
+    fulltext = !unique && !bitmap && aTokenizer.skipIf(Keywords::fulltext_kw);
+  }
+  if (theSeq && aTokenizer.skipIf(Keywords::index_kw) &&
+      TokenType::identifier == aTokenizer.current().type) {
+    indexName = aTokenizer.current().data;
+    aTokenizer.next();
+    if (aTokenizer.skipIf(Keywords::on_kw) &&
+        TokenType::identifier == aTokenizer.current().type) {
+      tableName = aTokenizer.current().data;
+      aTokenizer.next();
+      if (aTokenizer.skipIf(left_paren)) {
+        theResult = theParseHelper.parseIdentifierList(fieldList);
+        if (theResult && fieldList.empty()) {
+          theResult.error = Errors::identifierExpected;
+        }
+        if (theResult && aTokenizer.skipIf(Keywords::include_kw)) {
+          theResult.error = Errors::identifierExpected;
+          if (aTokenizer.skipIf(left_paren)) {
+            theResult = theParseHelper.parseIdentifierList(includeList);
+          }
+          if (theResult && includeList.empty()) {
+            theResult.error = Errors::identifierExpected;
+          }
+        }
+        if (theResult && aTokenizer.skipIf(Keywords::with_kw)) {
+          theResult = parseOptions(aTokenizer);
+        }
+        aTokenizer.skipIf(semicolon);
+      }
+    }
+  }
+  return theResult;
+}
+
+// WITH (parallel = N): N threads extract and sort the keys
+StatusResult CreateIndexStatement::parseOptions(Tokenizer &aTokenizer) {
+  if (aTokenizer.skipIf(left_paren) &&
+      aTokenizer.skipIf(Keywords::parallel_kw) && aTokenizer.skipIf('=') &&
+      TokenType::number == aTokenizer.current().type &&
+      Helpers::isNumber<int>(aTokenizer.current().data)) {
+    int theCount = std::stoi(aTokenizer.current().data);
+    aTokenizer.next();
+    if (theCount > 0 && aTokenizer.skipIf(right_paren)) {
+      parallel = static_cast<size_t>(theCount);
+      return {Errors::noError};
+    }
+  }
+  return {Errors::syntaxError};
+}
+
+StatusResult CreateIndexStatement::run(
+    [[maybe_unused]] std::ostream &anOutput) const {
+  IndexType theType{bitmap     ? IndexType::bitmapKey
+                    : fulltext ? IndexType::fulltextKey
+                               : IndexType::compositeKey};
+  return dbp->createIndex(tableName, indexName, fieldList, unique, theType,
+                          includeList, parallel);
+}
+
+// ---------------------------------------------------------------------------
+// * 9. analyze [table] {table-name}
+// analyze Users;
+AnalyzeTableStatement::AnalyzeTableStatement(DBProcessor *aDbp)
+    : SQLStatement{aDbp, Keywords::analyze_kw} {}
+
+bool AnalyzeTableStatement::recognize(Tokenizer &aTokenizer) {
+  TokenSequencer theSeq(aTokenizer);
+  return theSeq.currentIsNoSkip({Keywords::analyze_kw});
+}
+
+StatusResult AnalyzeTableStatement::parse(Tokenizer &aTokenizer) {
+  StatusResult theResult{Errors::identifierExpected};
+  if (aTokenizer.skipIf(Keywords::analyze_kw)) {
+    aTokenizer.skipIf(Keywords::table_kw);
+    if (aTokenizer.more() &&
+        TokenType::identifier == aTokenizer.current().type) {
+      identifierData = aTokenizer.current().data;
+      aTokenizer.next();
+      aTokenizer.skipIf(semicolon);
+      theResult.error = Errors::noError;
+    }
+  }
+  return theResult;
+}
+
+StatusResult AnalyzeTableStatement::run(
+    [[maybe_unused]] std::ostream &anOutput) const {
+  return dbp->analyzeTable(identifierData);
+}
+
 }  // namespace ECE141
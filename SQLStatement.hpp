@@ -164,6 +164,39 @@ class ShowIdxStatement : public SelectStatement {
  protected:
   std::string tableName;
   StringList fieldList;
+  bool advice{false};  // show index advice
+};
+
+// ------------------------------------------------------------------------------
+// 8. create [unique | bitmap | fulltext] index {index-name} on {table-name} ({attr-name}, ...)
+class CreateIndexStatement : public SQLStatement {
+ public:
+  explicit CreateIndexStatement(DBProcessor* aDbp);
+  static bool recognize(Tokenizer& aTokenizer);
+  StatusResult parse(Tokenizer& aTokenizer) override;
+  StatusResult run(std::ostream& aStream) const override;
+
+ protected:
+  std::string indexName;
+  std::string tableName;
+  StringList fieldList;
+  StringList includeList;  // INCLUDE (...): stored, not searched
+  size_t parallel{1};      // WITH (parallel = N)
+  bool unique{false};
+  bool bitmap{false};
+  bool fulltext{false};
+
+  StatusResult parseOptions(Tokenizer& aTokenizer);
+};
+
+// ------------------------------------------------------------------------------
+// 9. analyze [table] {table-name}
+class AnalyzeTableStatement : public SQLStatement {
+ public:
+  explicit AnalyzeTableStatement(DBProcessor* aDbp);
+  static bool recognize(Tokenizer& aTokenizer);
+  StatusResult parse(Tokenizer& aTokenizer) override;
+  StatusResult run(std::ostream& aStream) const override;
 };
 
 }  // namespace ECE141
@@ -38,6 +38,9 @@ void ScriptRunner::showErrors(StatusResult &aResult, std::ostream &anOutput) {
       {Errors::databaseExists, "Database exists"},
       {Errors::entityBlockNumNotFound, "Entity BlockNum Not Found"},
       {Errors::illegalIdentifier, "Illegal identifier"},
+      {Errors::indexExists, "Index exists"},
+      {Errors::cantCreateIndex, "Can't create index"},
+      {Errors::unknownAttribute, "Unknown attribute"},
       {Errors::integerExpected, "integerExpected"},
       {Errors::invalidCommand, "invalid Command"},
       {Errors::invalidExpression, "invalid Expression"},
@@ -51,6 +54,7 @@ void ScriptRunner::showErrors(StatusResult &aResult, std::ostream &anOutput) {
       {Errors::unknownDatabase, "Unknown database"},
       {Errors::unknownError, "Unknown error"},
       {Errors::unknownIdentifier, "Unknown identifier"},
+      {Errors::uniqueViolation, "Duplicate entry for unique key"},
       {Errors::unknownTable, "Unknown table"},
       {Errors::writeError, "write Error"},
   };
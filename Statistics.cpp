@@ -0,0 +1,438 @@
+/**
+ * @file Statistics.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+#include "BloomFilter.hpp"
+#include "Entity.hpp"
+#include "Errors.hpp"
+#include "Helpers.hpp"
+#include "KeyEncoder.hpp"
+
+namespace ECE141 {
+
+// ints and doubles compare by value, anything else by variant order
+static std::optional<double> toNumber(const Value &aValue) {
+  if (const auto *theInt = std::get_if<int>(&aValue)) {
+    return static_cast<double>(*theInt);
+  }
+  if (const auto *theDouble = std::get_if<double>(&aValue)) {
+    return *theDouble;
+  }
+  return std::nullopt;
+}
+
+static bool valueLess(const Value &aLHS, const Value &aRHS) {
+  auto theLHS = toNumber(aLHS);
+  auto theRHS = toNumber(aRHS);
+  return (theLHS && theRHS) ? *theLHS < *theRHS : aLHS < aRHS;
+}
+
+static bool sameValue(const Value &aLHS, const Value &aRHS) {
+  return !valueLess(aLHS, aRHS) && !valueLess(aRHS, aLHS);
+}
+
+static std::string valueToHex(const Value &aValue) {
+  return KeyEncoder::toHex(KeyEncoder::encode({aValue}));
+}
+
+static Value hexToValue(const std::string &aHex) {
+  ValuesList theValues = KeyEncoder::decode(KeyEncoder::fromHex(aHex), 1);
+  return theValues.empty() ? Value{0} : theValues.front();
+}
+
+static StatusResult encodeOptValue(std::ostream &anOutput,
+                                   const std::optional<Value> &aValue) {
+  Helpers::encodeInto(anOutput, aValue.has_value());
+  if (aValue) {
+    Helpers::encodeInto(anOutput, valueToHex(*aValue));
+  }
+  return {Errors::noError};
+}
+
+static StatusResult decodeOptValue(std::istream &anInput,
+                                   std::optional<Value> &aValue) {
+  bool theHasValue{false};
+  Helpers::decodeFrom(anInput, theHasValue);
+  aValue.reset();
+  if (theHasValue) {
+    std::string theHex;
+    Helpers::decodeFrom(anInput, theHex);
+    aValue = hexToValue(theHex);
+  }
+  return Helpers::checkStreamNotFail(anInput);
+}
+
+// HyperLogLog ----------------------------------------
+void HyperLogLog::add(uint64_t aHash) {
+  size_t theRegister = aHash >> (64 - kPrecision);
+  uint64_t theRest = aHash << kPrecision;
+  uint8_t theRank{1};
+  while (theRank <= 64 - kPrecision && 0 == (theRest & (uint64_t{1} << 63))) {
+    theRest <<= 1;
+    theRank++;
+  }
+  registers[theRegister] = std::max(registers[theRegister], theRank);
+}
+
+double HyperLogLog::estimate() const {
+  constexpr double theM = kRegisters;
+  const double theAlpha = 0.7213 / (1.0 + 1.079 / theM);
+  double theSum{0};
+  size_t theZeros{0};
+  for (uint8_t theRank : registers) {
+    theSum += std::ldexp(1.0, -theRank);
+    theZeros += (0 == theRank);
+  }
+  double theEstimate = theAlpha * theM * theM / theSum;
+  // small cardinalities: linear counting over the empty registers
+  if (theEstimate <= 2.5 * theM && theZeros > 0) {
+    theEstimate = theM * std::log(theM / static_cast<double>(theZeros));
+  }
+  return theEstimate;
+}
+
+// few distinct values leave most registers empty: store only the set ones
+// ('S' count (register rank)...) unless the dense hex dump ('D') is shorter
+StatusResult HyperLogLog::encode(std::ostream &anOutput) const {
+  size_t theSet = kRegisters - static_cast<size_t>(std::count(
+                                   registers.begin(), registers.end(), 0));
+  if (theSet * 6 < 2 * kRegisters) {
+    Helpers::encodeInto(anOutput, 'S');
+    Helpers::encodeInto(anOutput, theSet);
+    for (size_t i = 0; i < kRegisters; i++) {
+      if (0 != registers[i]) {
+        Helpers::encodeInto(anOutput, i);
+        Helpers::encodeInto(anOutput, static_cast<int>(registers[i]));
+      }
+    }
+    return {Errors::noError};
+  }
+  std::string theBytes(registers.begin(), registers.end());
+  Helpers::encodeInto(anOutput, 'D');
+  return Helpers::encodeInto(anOutput, KeyEncoder::toHex(theBytes));
+}
+
+StatusResult HyperLogLog::decode(std::istream &anInput) {
+  char theFormat{0};
+  Helpers::decodeFrom(anInput, theFormat);
+  registers.fill(0);
+  if ('S' == theFormat) {
+    size_t theSet{0};
+    Helpers::decodeFrom(anInput, theSet);
+    for (size_t i = 0; i < theSet; i++) {
+      size_t theRegister{0};
+      int theRank{0};
+      Helpers::decodeFrom(anInput, theRegister);
+      Helpers::decodeFrom(anInput, theRank);
+      if (theRegister >= kRegisters) {
+        return {Errors::readError};
+      }
+      registers[theRegister] = static_cast<uint8_t>(theRank);
+    }
+    return Helpers::checkStreamNotFail(anInput);
+  }
+  std::string theHex;
+  Helpers::decodeFrom(anInput, theHex);
+  std::string theBytes = KeyEncoder::fromHex(theHex);
+  if ('D' != theFormat || theBytes.size() != kRegisters) {
+    return {Errors::readError};
+  }
+  std::copy(theBytes.begin(), theBytes.end(), registers.begin());
+  return {Errors::noError};
+}
+
+// ColumnStats ----------------------------------------
+void ColumnStats::add(const Value &aValue) {
+  valueCount++;
+  distinct.add(BloomFilter::hash(KeyEncoder::encode({aValue})));
+  if (!min || valueLess(aValue, *min)) {
+    min = aValue;
+  }
+  if (!max || valueLess(*max, aValue)) {
+    max = aValue;
+  }
+  auto theBound =
+      std::lower_bound(bounds.begin(), bounds.end(), aValue, valueLess);
+  if (bounds.end() == theBound) {
+    if (bounds.empty()) {
+      bounds.push_back(aValue);
+      counts.push_back(0);
+    }
+    bounds.back() = aValue;  // the last bucket stretches to the new max
+    theBound = std::prev(bounds.end());
+  }
+  counts[std::distance(bounds.begin(), theBound)]++;
+}
+
+void ColumnStats::remove(const Value &aValue) {
+  valueCount -= (valueCount > 0);
+  auto theBound =
+      std::lower_bound(bounds.begin(), bounds.end(), aValue, valueLess);
+  if (bounds.end() != theBound) {
+    size_t &theCount = counts[std::distance(bounds.begin(), theBound)];
+    theCount -= (theCount > 0);
+  }
+}
+
+size_t ColumnStats::getDistinct() const {
+  if (0 == valueCount) {
+    return 0;
+  }
+  auto theEstimate = static_cast<size_t>(std::llround(distinct.estimate()));
+  return std::clamp<size_t>(theEstimate, 1, valueCount);
+}
+
+double ColumnStats::fractionBelow(const Value &aValue) const {
+  size_t theTotal{0};
+  for (size_t theCount : counts) {
+    theTotal += theCount;
+  }
+  if (0 == theTotal) {
+    return 0.0;
+  }
+  double theBelow{0};
+  for (size_t i = 0; i < bounds.size(); i++) {
+    const Value &theUpper = bounds[i];
+    if (valueLess(theUpper, aValue)) {
+      theBelow += static_cast<double>(counts[i]);
+      continue;
+    }
+    // aValue falls inside bucket i: interpolate numbers, else assume half
+    const Value &theLower = (0 == i) ? min.value_or(theUpper) : bounds[i - 1];
+    double thePart{0.5};
+    auto theLow = toNumber(theLower);
+    auto theHigh = toNumber(theUpper);
+    auto theValue = toNumber(aValue);
+    if (theLow && theHigh && theValue) {
+      thePart = (*theHigh > *theLow)
+                    ? (*theValue - *theLow) / (*theHigh - *theLow)
+                    : 0.0;
+    }
+    if (valueLess(aValue, theLower)) {
+      thePart = 0.0;
+    }
+    theBelow += static_cast<double>(counts[i]) * std::clamp(thePart, 0.0, 1.0);
+    break;
+  }
+  return std::clamp(theBelow / static_cast<double>(theTotal), 0.0, 1.0);
+}
+
+double ColumnStats::selectivity(Operators anOp, const Value &aValue) const {
+  if (0 == valueCount) {
+    return 0.0;
+  }
+  double theEqual = (valueLess(aValue, *min) || valueLess(*max, aValue))
+                        ? 0.0
+                        : 1.0 / static_cast<double>(getDistinct());
+  switch (anOp) {
+    case Operators::equal_op:
+      return theEqual;
+    case Operators::notequal_op:
+      return 1.0 - theEqual;
+    case Operators::lt_op:
+      return fractionBelow(aValue);
+    case Operators::lte_op:
+      return std::min(1.0, fractionBelow(aValue) + theEqual);
+    case Operators::gt_op:
+      return std::max(0.0, 1.0 - fractionBelow(aValue) - theEqual);
+    case Operators::gte_op:
+      return 1.0 - fractionBelow(aValue);
+    default:
+      return 1.0 / 3;  // unknown predicate: the textbook guess
+  }
+}
+
+StatusResult ColumnStats::encode(std::ostream &anOutput) const {
+  distinct.encode(anOutput);
+  Helpers::encodeInto(anOutput, nullCount);
+  Helpers::encodeInto(anOutput, valueCount);
+  encodeOptValue(anOutput, min);
+  encodeOptValue(anOutput, max);
+  Helpers::encodeInto(anOutput, bounds.size());
+  for (size_t i = 0; i < bounds.size(); i++) {
+    Helpers::encodeInto(anOutput, valueToHex(bounds[i]));
+    Helpers::encodeInto(anOutput, counts[i]);
+  }
+  return {Errors::noError};
+}
+
+StatusResult ColumnStats::decode(std::istream &anInput) {
+  StatusResult theResult = distinct.decode(anInput);
+  size_t theBuckets{0};
+  Helpers::decodeFrom(anInput, nullCount);
+  Helpers::decodeFrom(anInput, valueCount);
+  decodeOptValue(anInput, min);
+  decodeOptValue(anInput, max);
+  Helpers::decodeFrom(anInput, theBuckets);
+  bounds.clear();
+  counts.clear();
+  for (size_t i = 0; theResult && i < theBuckets; i++) {
+    std::string theHex;
+    size_t theCount{0};
+    Helpers::decodeFrom(anInput, theHex);
+    theResult = Helpers::decodeFrom(anInput, theCount);
+    bounds.push_back(hexToValue(theHex));
+    counts.push_back(theCount);
+  }
+  return theResult ? Helpers::checkStreamNotFail(anInput) : theResult;
+}
+
+// TableStats -----------------------------------------
+TableStats::TableStats(uint32_t aBlockNum) : blockNum{aBlockNum} {}
+
+TableStats &TableStats::analyze(const Entity &anEntity,
+                                const RowCollection &aRows) {
+  columns.clear();
+  rowCount = aRows.size();
+  for (const auto &theAttr : anEntity.getAttributes()) {
+    ColumnStats &theColumn = columns[theAttr.getName()];
+    std::vector<Value> theValues;
+    theValues.reserve(aRows.size());
+    for (const auto &theRow : aRows) {
+      const KeyValues &theData = theRow->getData();
+      auto theIter = theData.find(theAttr.getName());
+      if (theData.end() == theIter) {
+        theColumn.nullCount++;
+      } else {
+        theValues.push_back(theIter->second);
+        theColumn.distinct.add(
+            BloomFilter::hash(KeyEncoder::encode({theIter->second})));
+      }
+    }
+    theColumn.valueCount = theValues.size();
+    if (theValues.empty()) {
+      continue;
+    }
+    std::sort(theValues.begin(), theValues.end(), valueLess);
+    theColumn.min = theValues.front();
+    theColumn.max = theValues.back();
+
+    // equi-depth: bucket b ends at the (b+1)/n quantile; a value repeated
+    // across a boundary stays in one (deeper) bucket
+    size_t theBuckets = std::min(ColumnStats::kMaxBuckets, theValues.size());
+    size_t theStart{0};
+    for (size_t b = 0; b < theBuckets; b++) {
+      size_t theEnd = (b + 1) * theValues.size() / theBuckets;
+      const Value &theBound = theValues[theEnd - 1];
+      if (!theColumn.bounds.empty() &&
+          sameValue(theColumn.bounds.back(), theBound)) {
+        theColumn.counts.back() += theEnd - theStart;
+      } else {
+        theColumn.bounds.push_back(theBound);
+        theColumn.counts.push_back(theEnd - theStart);
+      }
+      theStart = theEnd;
+    }
+  }
+  changed = true;
+  return *this;
+}
+
+TableStats &TableStats::add(const KeyValues &aRow) {
+  rowCount++;
+  for (auto &[theName, theColumn] : columns) {
+    auto theIter = aRow.find(theName);
+    if (aRow.end() == theIter) {
+      theColumn.nullCount++;
+    } else {
+      theColumn.add(theIter->second);
+    }
+  }
+  changed = true;
+  return *this;
+}
+
+TableStats &TableStats::remove(const KeyValues &aRow) {
+  rowCount -= (rowCount > 0);
+  for (auto &[theName, theColumn] : columns) {
+    auto theIter = aRow.find(theName);
+    if (aRow.end() == theIter) {
+      theColumn.nullCount -= (theColumn.nullCount > 0);
+    } else {
+      theColumn.remove(theIter->second);
+    }
+  }
+  changed = true;
+  return *this;
+}
+
+double TableStats::selectivity(const std::string &aField, Operators anOp,
+                               const Value &aValue) const {
+  const ColumnStats *theColumn = getColumn(aField);
+  if (nullptr == theColumn || 0 == rowCount) {
+    return (Operators::equal_op == anOp) ? 0.1 : 1.0 / 3;
+  }
+  double theNonNull = std::min(
+      1.0, static_cast<double>(theColumn->valueCount) / rowCount);
+  return theNonNull * theColumn->selectivity(anOp, aValue);
+}
+
+double TableStats::estimateRows(const std::string &aField, Operators anOp,
+                                const Value &aValue) const {
+  return static_cast<double>(rowCount) * selectivity(aField, anOp, aValue);
+}
+
+size_t TableStats::getRowCount() const { return rowCount; }
+
+const ColumnStats *TableStats::getColumn(const std::string &aField) const {
+  auto theIter = columns.find(aField);
+  return (columns.end() == theIter) ? nullptr : &theIter->second;
+}
+
+const std::map<std::string, ColumnStats> &TableStats::getColumns() const {
+  return columns;
+}
+
+uint32_t TableStats::getBlockNum() const { return blockNum; }
+TableStats &TableStats::setBlockNum(uint32_t aBlockNum) {
+  blockNum = aBlockNum;
+  return *this;
+}
+
+bool TableStats::isChanged() const { return changed; }
+TableStats &TableStats::setChanged(bool aChanged) {
+  changed = aChanged;
+  return *this;
+}
+
+// Storable interface --------------------------------
+StatusResult TableStats::encode(std::ostream &anOutput) const {
+  Helpers::encodeInto(anOutput, rowCount);
+  Helpers::encodeInto(anOutput, columns.size());
+  for (const auto &[theName, theColumn] : columns) {
+    Helpers::encodeInto(anOutput, theName);
+    theColumn.encode(anOutput);
+  }
+  return {Errors::noError};
+}
+
+StatusResult TableStats::decode(std::istream &anInput) {
+  size_t theCount{0};
+  Helpers::decodeFrom(anInput, rowCount);
+  StatusResult theResult = Helpers::decodeFrom(anInput, theCount);
+  columns.clear();
+  for (size_t i = 0; theResult && i < theCount; i++) {
+    std::string theName;
+    Helpers::decodeFrom(anInput, theName);
+    theResult = columns[theName].decode(anInput);
+  }
+  changed = false;
+  return theResult;
+}
+
+}  // namespace ECE141
@@ -0,0 +1,121 @@
+/**
+ * @file Statistics.hpp
+ * @author Yifan Wu
+ * @brief per-table column statistics (ANALYZE) for cost estimates
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef Statistics_hpp
+#define Statistics_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "BasicTypes.hpp"
+#include "Row.hpp"
+#include "Storage.hpp"
+#include "keywords.hpp"
+
+namespace ECE141 {
+
+class Entity;
+
+// USE: distinct-value sketch. Each value hashes to one of 2^kPrecision
+//      registers, which keeps the longest run of leading zeros seen; the
+//      harmonic mean of the registers estimates the count (~6% error).
+class HyperLogLog {
+ public:
+  static constexpr size_t kPrecision{8};
+  static constexpr size_t kRegisters{size_t{1} << kPrecision};
+
+  void add(uint64_t aHash);
+  [[nodiscard]] double estimate() const;
+
+  StatusResult encode(std::ostream &anOutput) const;
+  StatusResult decode(std::istream &anInput);
+
+ protected:
+  std::array<uint8_t, kRegisters> registers{};
+};
+
+// USE: statistics of one attribute. The histogram is equi-depth: every
+//      bucket held about the same number of rows when ANALYZE ran, and
+//      bounds[i] is the largest value of bucket i. Inserts and deletes
+//      keep counts current; bounds, min/max and distinct only widen until
+//      the next ANALYZE.
+struct ColumnStats {
+  static constexpr size_t kMaxBuckets{16};
+
+  void add(const Value &aValue);
+  void remove(const Value &aValue);
+
+  // fraction of the non-null rows matching `column anOp aValue`
+  [[nodiscard]] double selectivity(Operators anOp, const Value &aValue) const;
+  [[nodiscard]] size_t getDistinct() const;
+
+  StatusResult encode(std::ostream &anOutput) const;
+  StatusResult decode(std::istream &anInput);
+
+  HyperLogLog distinct;
+  std::optional<Value> min;
+  std::optional<Value> max;
+  size_t nullCount{0};
+  size_t valueCount{0};  // non-null rows
+  std::vector<Value> bounds;
+  std::vector<size_t> counts;
+
+ protected:
+  // fraction of the non-null rows with a value below aValue
+  [[nodiscard]] double fractionBelow(const Value &aValue) const;
+};
+
+// USE: ANALYZE fills these for a table; the access path uses them to
+//      compare candidate indexes by the number of rows they would fetch.
+//      Stored in a meta block referenced by the table's entity.
+class TableStats : public Storable {
+ public:
+  explicit TableStats(uint32_t aBlockNum = 0);
+
+  TableStats &analyze(const Entity &anEntity, const RowCollection &aRows);
+  TableStats &add(const KeyValues &aRow);
+  TableStats &remove(const KeyValues &aRow);
+
+  // estimated fraction of all rows where `aField anOp aValue` holds
+  [[nodiscard]] double selectivity(const std::string &aField, Operators anOp,
+                                   const Value &aValue) const;
+  [[nodiscard]] double estimateRows(const std::string &aField, Operators anOp,
+                                    const Value &aValue) const;
+
+  [[nodiscard]] size_t getRowCount() const;
+  [[nodiscard]] const ColumnStats *getColumn(const std::string &aField) const;
+  [[nodiscard]] const std::map<std::string, ColumnStats> &getColumns() const;
+
+  [[nodiscard]] uint32_t getBlockNum() const;
+  TableStats &setBlockNum(uint32_t aBlockNum);
+  [[nodiscard]] bool isChanged() const;
+  TableStats &setChanged(bool aChanged);
+
+  // Storable interface
+  StatusResult encode(std::ostream &anOutput) const override;
+  StatusResult decode(std::istream &anInput) override;
+
+ protected:
+  std::map<std::string, ColumnStats> columns;
+  size_t rowCount{0};
+  uint32_t blockNum;
+  bool changed{false};
+};
+
+}  // namespace ECE141
+
+#endif /* Statistics_hpp */
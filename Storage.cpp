@@ -28,6 +28,7 @@
 #include "Helpers.hpp"
 #include "Index.hpp"
 #include "Row.hpp"
+#include "Statistics.hpp"
 
 namespace ECE141 {
 StorageInfo::StorageInfo(size_t aRefId, size_t aSize, int32_t aStartPos,
@@ -148,6 +149,9 @@ StatusResult Storage::save(std::iostream &aStream, StorageInfo &anInfo,
     size_t theBufSize = std::min(anInfo.size, kPayloadSize);
     // extracts characters from stream to block
     aStream.read(reinterpret_cast<char *>(&theBlock.payload), theBufSize);
+    // last chunk: don't leave the previous chunk's tail behind
+    std::fill(theBlock.payload.begin() + static_cast<long>(theBufSize),
+              theBlock.payload.end(), '\0');
     anInfo.size -= theBufSize;
 
     theBlock.header.count = theCount;
@@ -155,14 +159,17 @@ StatusResult Storage::save(std::iostream &aStream, StorageInfo &anInfo,
     theBlock.header.entityHash = anInfo.refId;
     theBlock.header.type = static_cast<char>(anInfo.type);
 
-    for (size_t i = 0; i < anInfo.extra.size(); i++) {
-      theBlock.header.extra.at(i) = anInfo.extra.at(i);
-    }
+    theBlock.header.setExtra(anInfo.extra);
     // if one block's capacity cannot contain the data
-    theBlock.header.next = (anInfo.size > 0) ? getFreeBlock() : 0;
+    uint32_t theNext = (anInfo.size > 0) ? getFreeBlock() : 0;
+    if (0 != theNext && theNext == theBlockNum) {
+      theNext++;  // this block isn't written yet, so EOF hasn't moved
+    }
+    theBlock.header.next = theNext;
     // ? uncomment for debug
     // std::cerr << "Save to " << aDBName << " :\n" << theBlock;
     theResult = writeBlock(theBlockNum, theBlock);
+    theBlockNum = theNext;
   }
   theResult.value = theStartBlock;
   return theResult;
@@ -171,6 +178,7 @@ StatusResult Storage::save(std::iostream &aStream, StorageInfo &anInfo,
 StatusResult Storage::load(std::iostream &anOut, StorageInfo &anInfo,
                            uint32_t aStartBlockNum,
                            [[maybe_unused]] const std::string &aDBName) {
+  std::lock_guard<std::mutex> theGuard(readLock);
   StatusResult theResult{Errors::seekError};
   if (getBlockCount() > aStartBlockNum) {
     Block theLoadBlock;
@@ -213,8 +221,10 @@ StatusResult Storage::decodeIndexMap(std::istream &anInput,
     Helpers::decodeFrom(anInput, theTableName);
     uint32_t theIndexBlockNum;
     Helpers::decodeFrom(anInput, theIndexBlockNum);
-    anIndexMap.emplace(theTableName,
-                       std::make_unique<Index>(*this, theIndexBlockNum));
+    // stub: keys stay on disk until the index is first used
+    auto theIndex = std::make_unique<Index>(*this, theIndexBlockNum);
+    theIndex->setLoaded(false);
+    anIndexMap.emplace(theTableName, std::move(theIndex));
   }
   return {Errors::noError};
 }
@@ -228,26 +238,30 @@ StatusResult Storage::saveIndexMap(const IndexMap &anIndexMap) {
     StorageInfo theInfo = getLookUpStorageInfo(theMapStrm.tellg());
     theMapStrm.seekg(0, std::ios::beg);
     theResult = save(theMapStrm, theInfo);
-    // Encode each Index in map
+    // Encode each Index in map (unloaded/unchanged ones match the disk)
     for (const auto &[theTableName, theIndex] : anIndexMap) {
-      // TODO: no need to overwrite if index not change.(bug)
-      // if(!theIndex->isChanged()) {
-      //   continue;
-      // }
-      std::stringstream theIndexStrm;
-      theResult = theIndex->encode(theIndexStrm);
-      if (!(theIndexStrm >> std::ws).eof() && theResult) {
-        theIndexStrm.seekg(0, std::ios::end);
-        StorageInfo theIndexInfo =
-            theIndex->getStorageInfo(theIndexStrm.tellg(), theTableName);
-        theIndexStrm.seekg(0, std::ios::beg);
-        theResult = save(theIndexStrm, theIndexInfo);
+      if (theIndex->isLoaded() && theIndex->isChanged()) {
+        theResult = saveIndex(theTableName, *theIndex);
       }
     }
   }
   return theResult;
 }
 
+StatusResult Storage::saveIndex(const std::string &anIndexKey,
+                                const Index &anIndex) {
+  std::stringstream theIndexStrm;
+  StatusResult theResult = anIndex.encode(theIndexStrm);
+  if (!(theIndexStrm >> std::ws).eof() && theResult) {
+    theIndexStrm.seekg(0, std::ios::end);
+    StorageInfo theIndexInfo =
+        anIndex.getStorageInfo(theIndexStrm.tellg(), anIndexKey);
+    theIndexStrm.seekg(0, std::ios::beg);
+    theResult = save(theIndexStrm, theIndexInfo);
+  }
+  return theResult;
+}
+
 StatusResult Storage::loadIndexMap(IndexMap &anIndexMap) {
   std::stringstream theMapStrm;
   StorageInfo theIdxMapInfo;
@@ -256,47 +270,71 @@ StatusResult Storage::loadIndexMap(IndexMap &anIndexMap) {
   if (!(theMapStrm >> std::ws).eof() && theResult &&
       '\0' != theMapStrm.peek()) {
     theResult = decodeIndexMap(theMapStrm, anIndexMap);
+  }
+  return theResult;
+}
 
-    // Need to decode each index in IndexMap
-    for (auto &[theTableName, theIndex] : anIndexMap) {
-      std::stringstream theIndexStrm;
-      StorageInfo theIndexInfo;
-      theResult = load(theIndexStrm, theIndexInfo, theIndex->getBlockNum());
-      // std::cerr << "#|" << theIndexStrm.str() << "|\n";
-      if (!(theIndexStrm >> std::ws).eof() && theResult) {
-        theResult = theIndex->decode(theIndexStrm);
-      }
-    }
+StatusResult Storage::loadIndex(Index &anIndex) {
+  std::stringstream theIndexStrm;
+  StorageInfo theIndexInfo;
+  StatusResult theResult =
+      load(theIndexStrm, theIndexInfo, anIndex.getBlockNum());
+  // std::cerr << "#|" << theIndexStrm.str() << "|\n";
+  if (!(theIndexStrm >> std::ws).eof() && theResult) {
+    theResult = anIndex.decode(theIndexStrm);
   }
+  anIndex.setLoaded(true);
   return theResult;
 }
 
-StatusResult Storage::getRowsByIndex(const std::string &anEntityName,
-                                     const IndexMap &anIndexMap,
-                                     RowCollection &aCollection) {
+StatusResult Storage::getRowsByIndex(Index &anIndex,
+                                     RowCollection &aCollection,
+                                     const BlockFilter &aFilter) {
   StatusResult theResult{Errors::entityBlockNumNotFound};
-  if (anIndexMap.find(anEntityName) != anIndexMap.end()) {
-    auto &theIndex = anIndexMap.at(anEntityName);
-    auto theBlkVisitor = [&]([[maybe_unused]] const Block &aBlock,
-                             uint32_t aBlockNum) {
-      // working directly with Index to get Row
-      std::stringstream theDecodeStream;
-      StorageInfo theLoadInfo;
-      if (!(theResult = load(theDecodeStream, theLoadInfo, aBlockNum))) {
-        std::cerr << "Index storage.load() fail\n";
-        return false;
-      }
-      auto theMatchedRow =
-          std::make_unique<Row>(theLoadInfo.refId, theLoadInfo.start);
-      if (!(theResult = theMatchedRow->decode(theDecodeStream))) {
-        std::cerr << "Index row decode fail\n";
-        return false;
-      }
-      // std::cout << *theMatchedRow;
-      aCollection.push_back(std::move(theMatchedRow));
+  auto theBlkVisitor = [&]([[maybe_unused]] const Block &aBlock,
+                           uint32_t aBlockNum) {
+    if (aFilter && !aFilter(aBlockNum)) {
+      theResult.error = Errors::noError;  // skipped, not missing
       return true;
-    };
-    theIndex->each(theBlkVisitor);
+    }
+    // working directly with Index to get Row
+    return static_cast<bool>(theResult = loadRow(aBlockNum, aCollection));
+  };
+  anIndex.each(theBlkVisitor);
+  return theResult;
+}
+
+StatusResult Storage::loadRow(uint32_t aBlockNum, RowCollection &aCollection) {
+  std::unique_ptr<Row> theMatchedRow;
+  StatusResult theResult = loadRow(aBlockNum, theMatchedRow);
+  if (theResult) {
+    aCollection.push_back(std::move(theMatchedRow));
+  }
+  return theResult;
+}
+
+StatusResult Storage::loadRow(uint32_t aBlockNum, std::unique_ptr<Row> &aRow) {
+  std::stringstream theDecodeStream;
+  StorageInfo theLoadInfo;
+  StatusResult theResult = load(theDecodeStream, theLoadInfo, aBlockNum);
+  if (!theResult) {
+    std::cerr << "Index storage.load() fail\n";
+    return theResult;
+  }
+  aRow = std::make_unique<Row>(theLoadInfo.refId, theLoadInfo.start);
+  if (!(theResult = aRow->decode(theDecodeStream))) {
+    std::cerr << "Index row decode fail\n";
+  }
+  return theResult;
+}
+
+StatusResult Storage::getRowsByBlockList(const BlockList &aBlockList,
+                                         RowCollection &aCollection) {
+  StatusResult theResult{Errors::noError};
+  for (auto theBlockNum : aBlockList) {
+    if (!(theResult = loadRow(theBlockNum, aCollection))) {
+      break;
+    }
   }
   return theResult;
 }
@@ -307,13 +345,18 @@ StatusResult Storage::getRowsByBruteForce(const Entity &anEntity,
 }
 
 StatusResult Storage::getRowsByBruteForce(const std::string &anEntityName,
-                                          RowCollection &aCollection) {
+                                          RowCollection &aCollection,
+                                          const BlockFilter &aFilter) {
   StatusResult theResult{Errors::readError};
   uint32_t theHash = Helpers::hashString(anEntityName);
   // working directly with storage to get rows
   auto theBlkVisitor = [&](const Block &aBlock, uint32_t aBlockNum) {
     if (aBlock.isIdMatch(theHash) &&
         aBlock.isTypeMatch(BlockType::data_block)) {
+      if (aFilter && !aFilter(aBlockNum)) {
+        theResult.error = Errors::noError;  // skipped, not missing
+        return true;
+      }
       std::stringstream theDecodeStream;
       StorageInfo theLoadInfo;
       theResult = load(theDecodeStream, theLoadInfo, aBlockNum);
@@ -359,26 +402,22 @@ StatusResult Storage::dropRowsByBruteForce(const std::string &anEntityName) {
   return theResult;
 }
 
-StatusResult Storage::dropRowsByIndex(const std::string &anEntityName,
-                                      IndexMap &anIndexMap) {
+StatusResult Storage::dropRowsByIndex(Index &anIndex) {
   StatusResult theResult{Errors::entityBlockNumNotFound};
-  if (anIndexMap.find(anEntityName) != anIndexMap.end()) {
-    auto &theIndex = anIndexMap.at(anEntityName);
-    // working directly with Index to get BlockNum
-    uint32_t theCount{0};
-    auto theBlkVisitor = [&]([[maybe_unused]] const Block &aBlock,
-                             uint32_t aBlockNum) {
-      theResult = releaseBlocks(aBlockNum, true);
-      if (!theResult) {
-        std::cerr << "Indexed Data Block Drop Fail\n";
-        return false;
-      }
-      theCount++;
-      return true;
-    };
-    if (theIndex->each(theBlkVisitor)) {
-      theResult.value = theCount;
+  // working directly with Index to get BlockNum
+  uint32_t theCount{0};
+  auto theBlkVisitor = [&]([[maybe_unused]] const Block &aBlock,
+                           uint32_t aBlockNum) {
+    theResult = releaseBlocks(aBlockNum, true);
+    if (!theResult) {
+      std::cerr << "Indexed Data Block Drop Fail\n";
+      return false;
     }
+    theCount++;
+    return true;
+  };
+  if (anIndex.each(theBlkVisitor)) {
+    theResult.value = theCount;
   }
   // Do not perform Index erase here
   return theResult;
@@ -419,6 +458,37 @@ StorageInfo getLookUpStorageInfo(std::streampos aSize) {
           LOOKUP_BLOCK_NUM, BlockType::meta_block, "LookUp"};
 }
 
+// first save allocates the chain; its head is kept in aStats (and, by the
+// caller, in the table's entity)
+StatusResult Storage::saveStats(const std::string &aTableName,
+                                TableStats &aStats) {
+  std::stringstream theStatsStrm;
+  StatusResult theResult = aStats.encode(theStatsStrm);
+  if (theResult) {
+    theStatsStrm.seekg(0, std::ios::end);
+    int32_t theStart = (0 == aStats.getBlockNum())
+                           ? kNewBlock
+                           : static_cast<int32_t>(aStats.getBlockNum());
+    StorageInfo theInfo{Helpers::hashString(aTableName), theStatsStrm.tellg(),
+                        theStart, BlockType::meta_block, aTableName + "#stats"};
+    theStatsStrm.seekg(0, std::ios::beg);
+    if ((theResult = save(theStatsStrm, theInfo))) {
+      aStats.setBlockNum(theResult.value).setChanged(false);
+    }
+  }
+  return theResult;
+}
+
+StatusResult Storage::loadStats(TableStats &aStats) {
+  std::stringstream theStatsStrm;
+  StorageInfo theInfo;
+  StatusResult theResult = load(theStatsStrm, theInfo, aStats.getBlockNum());
+  if (theResult) {
+    theResult = aStats.decode(theStatsStrm);
+  }
+  return theResult;
+}
+
 StatusResult Storage::saveEntityBlock(const Entity &anEntity,
                                       int32_t BlockNum) {
   std::stringstream theEntityStrm;
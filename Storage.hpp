@@ -20,6 +20,7 @@
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,7 @@ class Entity;
 class Index;
 class Row;
 class StatusResult;
+class TableStats;
 using RowCollection = std::vector<std::unique_ptr<Row>>;
 using IndexMap = std::map<std::string, std::unique_ptr<Index>>;
 
@@ -71,6 +73,8 @@ StorageInfo getLookUpStorageInfo(std::streampos aSize);
 // ---------------------------------------------------------
 
 using BlockVisitor = std::function<bool(const Block &, uint32_t)>;
+// false: a scan can skip the block without reading it
+using BlockFilter = std::function<bool(uint32_t)>;
 using BlockList = std::deque<uint32_t>;
 
 struct BlockIterator {
@@ -85,6 +89,7 @@ class Storage : public BlockIO, public BlockIterator {
   StatusResult save(std::iostream &aStream, StorageInfo &anInfo,
                     const std::string &aDBName = "");
 
+  // may run on several threads at once (parallel scans and index builds)
   StatusResult load(std::iostream &aStream, StorageInfo &anInfo,
                     uint32_t aStartBlockNum, const std::string &aDBName = "");
 
@@ -99,8 +104,16 @@ class Storage : public BlockIO, public BlockIterator {
   StatusResult saveMetaBlock(const Index &anIndex);
   StatusResult loadMetaBlock(Index &anIndex);
 
+  // the lookup block is the index catalog (map key -> index block); index
+  // contents are read on demand with loadIndex, only changed ones are saved
   StatusResult saveIndexMap(const IndexMap &anIndexMap);
   StatusResult loadIndexMap(IndexMap &anIndexMap);
+  StatusResult saveIndex(const std::string &anIndexKey, const Index &anIndex);
+  StatusResult loadIndex(Index &anIndex);
+
+  // ANALYZE statistics of a table (meta block chain, see TableStats)
+  StatusResult saveStats(const std::string &aTableName, TableStats &aStats);
+  StatusResult loadStats(TableStats &aStats);
 
   StatusResult saveEntityBlock(const Entity &anEntity,
                                int32_t BlockNum = kNewBlock);
@@ -116,20 +129,32 @@ class Storage : public BlockIO, public BlockIterator {
   StatusResult getRowsByBruteForce(const Entity &anEntity,
                                    RowCollection &aCollection);
   StatusResult getRowsByBruteForce(const std::string &anEntityName,
-                                   RowCollection &aCollection);
+                                   RowCollection &aCollection,
+                                   const BlockFilter &aFilter = nullptr);
   StatusResult dropRowsByBruteForce(const std::string &anEntityName);
 
   // ----------------------------------------------
   // get/drop Row by using index
-  StatusResult getRowsByIndex(const std::string &anEntityName,
-                              const IndexMap &anIndexMap,
-                              RowCollection &aCollection);
-  StatusResult dropRowsByIndex(const std::string &anEntityName,
-                               IndexMap &anIndexMap);
+  StatusResult getRowsByIndex(Index &anIndex, RowCollection &aCollection,
+                              const BlockFilter &aFilter = nullptr);
+  StatusResult dropRowsByIndex(Index &anIndex);
+
+  // ----------------------------------------------
+  // get Row(s) from known data block(s), e.g. result of an index scan
+  StatusResult loadRow(uint32_t aBlockNum, RowCollection &aCollection);
+  StatusResult loadRow(uint32_t aBlockNum, std::unique_ptr<Row> &aRow);
+  StatusResult getRowsByBlockList(const BlockList &aBlockList,
+                                  RowCollection &aCollection);
 
   BlockList available;
+  std::mutex readLock;  // load(): reads share the stream and block cache
   friend class Database;
   friend class DBProcessor;
+  friend class ScanOperator;
+  friend class IndexScanOperator;
+  friend class OrderedScanOperator;
+  friend class ExternalSortOperator;
+  friend class IndexJoinOperator;
 };
 
 }  // namespace ECE141
@@ -25,7 +25,9 @@
 
 #include "BasicTypes.hpp"
 #include "Config.hpp"
+#include "Errors.hpp"
 #include "Helpers.hpp"
+#include "QueryOperators.hpp"
 #include "Row.hpp"
 #include "View.hpp"
 
@@ -37,11 +39,24 @@ class TabularView : public View {
   TabularView(std::ostream &anOutput, RowCollection &aRows,
               StringList aFieldList)
       : output{anOutput}, rows{aRows}, fieldList{std::move(aFieldList)} {
+    layout();
+  }
+
+  // USE: a view of rows streamed by show(QueryOperator &)
+  TabularView(std::ostream &anOutput, StringList aFieldList)
+      : output{anOutput}, rows{first}, fieldList{std::move(aFieldList)} {}
+
+  // USE: columns and their widths, from the field list and the first row
+  void layout() {
+    widths.clear();
     if (!fieldList.empty()) {
       if ("*" == fieldList[0]) {
         fieldList.clear();
-        for (const auto &[theAttr, theValue] : rows.front()->getData()) {
-          fieldList.push_back(theAttr);
+        // an empty result has no row to take the field names from
+        if (!rows.empty()) {
+          for (const auto &[theAttr, theValue] : rows.front()->getData()) {
+            fieldList.push_back(theAttr);
+          }
         }
       }
       std::sort(fieldList.begin(), fieldList.end(),
@@ -54,18 +69,28 @@ class TabularView : public View {
                   }
                   return a < b;
                 });
-      const auto &theData = rows[0]->getData();
       std::transform(
           fieldList.begin(), fieldList.end(), std::back_inserter(widths),
           [&](const auto &theAttr) -> std::streamsize {
-            return std::max(static_cast<std::streamsize>(theAttr.size() + 2),
-                            Helpers::getWidthFromVal(theData.at(theAttr)));
+            auto theWidth = static_cast<std::streamsize>(theAttr.size() + 2);
+            if (rows.empty()) {
+              return theWidth;
+            }
+            const auto &theData = rows[0]->getData();
+            auto theIter = theData.find(theAttr);
+            return (theIter != theData.end())
+                       ? std::max(theWidth,
+                                  Helpers::getWidthFromVal(theIter->second))
+                       : theWidth;
           });
     }
   }
 
   // USE: create header for tabular view...
   TabularView &showHeader() {
+    if (fieldList.empty()) {
+      return *this;
+    }
     printBreak();
     output.fill(' ');
     output.setf(std::ios::left, std::ios::adjustfield);
@@ -83,9 +108,11 @@ class TabularView : public View {
     return *this;
   }
 
-  TabularView &showFooter() {
+  TabularView &showFooter() { return showFooter(rows.size()); }
+
+  TabularView &showFooter(size_t aCount) {
     printBreak();
-    output << rows.size() << " rows in set (" << Config::getTimer().elapsed()
+    output << aCount << " rows in set (" << Config::getTimer().elapsed()
            << " sec)\n";
     return *this;
   }
@@ -145,9 +172,32 @@ class TabularView : public View {
     return true;
   }
 
+  // USE: print the rows of an opened operator tree as they come; only the
+  // first one is kept (it lays out the columns)
+  StatusResult show(QueryOperator &aSource) {
+    std::unique_ptr<Row> theRow;
+    StatusResult theResult = aSource.next(theRow);
+    if (theResult && theRow) {
+      first.push_back(std::move(theRow));
+    }
+    layout();
+    showHeader();
+    size_t theCount{first.size()};
+    if (!first.empty()) {
+      showRow(*first.front());
+      while ((theResult = aSource.next(theRow)) && theRow) {
+        showRow(*theRow);
+        theCount++;
+      }
+    }
+    showFooter(theCount);
+    return theResult;
+  }
+
  protected:
   // Entity              &entity; //if necessary?
   std::ostream &output;
+  RowCollection first;  // streamed view: the row the layout came from
   RowCollection &rows;
   StringList fieldList;
   std::string separator;
@@ -0,0 +1,204 @@
+/**
+ * @file TaskScheduler.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "Config.hpp"
+
+namespace ECE141 {
+
+// the scheduler the calling thread works for, and its worker number there
+static thread_local const TaskScheduler *tScheduler{nullptr};
+static thread_local size_t tWorker{0};
+
+TaskScheduler::TaskScheduler(size_t aThreads) {
+  size_t theCount = std::max<size_t>(aThreads, 1);
+  for (size_t i = 0; i < theCount; i++) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < theCount; i++) {
+    threads.emplace_back(&TaskScheduler::loop, this, i);
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> theGuard(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &theThread : threads) {
+    theThread.join();
+  }
+}
+
+TaskScheduler &TaskScheduler::get() {
+  static TaskScheduler theScheduler{Config::workerThreads};
+  return theScheduler;
+}
+
+size_t TaskScheduler::getSize() const { return workers.size(); }
+
+TaskScheduler::Stats TaskScheduler::getStats() const {
+  Stats theStats;
+  theStats.threads = workers.size();
+  theStats.tasks = tasks;
+  theStats.steals = steals;
+  theStats.busySeconds = static_cast<double>(busyMicros) / 1e6;
+  double theCapacity =
+      static_cast<double>(workers.size()) * started.elapsed();
+  theStats.utilization =
+      theCapacity > 0 ? std::min(theStats.busySeconds / theCapacity, 1.0)
+                      : 0.0;
+  return theStats;
+}
+
+size_t TaskScheduler::workerOfThisThread() const {
+  return (this == tScheduler) ? tWorker : workers.size();
+}
+
+void TaskScheduler::submit(Task aTask) {
+  size_t theWorker = workerOfThisThread();
+  if (theWorker >= workers.size()) {
+    theWorker = dealt++ % workers.size();
+  }
+  {
+    std::lock_guard<std::mutex> theGuard(workers[theWorker]->lock);
+    workers[theWorker]->tasks.push_back(std::move(aTask));
+  }
+  queued++;
+  // under the lock, so a worker about to sleep sees the task or the wake
+  { std::lock_guard<std::mutex> theGuard(lock); }
+  wake.notify_one();
+}
+
+bool TaskScheduler::take(size_t aWorker, Task &aTask) {
+  if (aWorker < workers.size()) {
+    Worker &theOwn = *workers[aWorker];
+    std::lock_guard<std::mutex> theGuard(theOwn.lock);
+    if (!theOwn.tasks.empty()) {
+      aTask = std::move(theOwn.tasks.back());
+      theOwn.tasks.pop_back();
+      queued--;
+      return true;
+    }
+  }
+  // steal, starting past our own deque so thieves spread out
+  size_t theCount = workers.size();
+  for (size_t i = 1; i <= theCount; i++) {
+    Worker &theVictim = *workers[(aWorker + i) % theCount];
+    std::lock_guard<std::mutex> theGuard(theVictim.lock);
+    if (!theVictim.tasks.empty()) {
+      aTask = std::move(theVictim.tasks.front());
+      theVictim.tasks.pop_front();
+      queued--;
+      if (aWorker < theCount) {
+        steals++;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskScheduler::runTask(Task &aTask) {
+  tasks++;  // before it runs, so a group's wait() sees it counted
+  Timer theTimer;
+  aTask();
+  aTask = nullptr;  // release what it captured before the next one
+  busyMicros += static_cast<uint64_t>(theTimer.elapsed() * 1e6);
+}
+
+bool TaskScheduler::runOne() {
+  Task theTask;
+  if (!take(workerOfThisThread(), theTask)) {
+    return false;
+  }
+  runTask(theTask);
+  return true;
+}
+
+void TaskScheduler::loop(size_t aWorker) {
+  tScheduler = this;
+  tWorker = aWorker;
+  Task theTask;
+  while (true) {
+    if (take(aWorker, theTask)) {
+      runTask(theTask);
+      continue;
+    }
+    std::unique_lock<std::mutex> theGuard(lock);
+    wake.wait(theGuard, [&] { return stopping || queued > 0; });
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+TaskGroup::TaskGroup(TaskScheduler &aScheduler)
+    : scheduler{aScheduler}, state{std::make_shared<State>()} {}
+
+TaskGroup::~TaskGroup() { finish(); }
+
+void TaskGroup::run(TaskScheduler::Task aTask) {
+  state->pending++;
+  scheduler.submit([theState = state, theTask = std::move(aTask)] {
+    if (!theState->cancelled) {
+      try {
+        theTask();
+      } catch (...) {
+        std::lock_guard<std::mutex> theGuard(theState->lock);
+        if (!theState->error) {
+          theState->error = std::current_exception();
+        }
+        theState->cancelled = true;
+      }
+    }
+    if (0 == --theState->pending) {
+      { std::lock_guard<std::mutex> theGuard(theState->lock); }
+      theState->done.notify_all();
+    }
+  });
+}
+
+void TaskGroup::wait() {
+  finish();
+  std::exception_ptr theError;
+  {
+    std::lock_guard<std::mutex> theGuard(state->lock);
+    std::swap(theError, state->error);
+  }
+  if (theError) {
+    std::rethrow_exception(theError);
+  }
+}
+
+void TaskGroup::finish() {
+  while (state->pending > 0) {
+    if (!scheduler.runOne()) {
+      // ours are running elsewhere (or queued behind busy workers)
+      std::unique_lock<std::mutex> theGuard(state->lock);
+      state->done.wait_for(theGuard, std::chrono::milliseconds(1),
+                           [&] { return 0 == state->pending; });
+    }
+  }
+}
+
+void TaskGroup::cancel() { state->cancelled = true; }
+
+bool TaskGroup::isCancelled() const { return state->cancelled; }
+
+}  // namespace ECE141
@@ -0,0 +1,132 @@
+/**
+ * @file TaskScheduler.hpp
+ * @author Yifan Wu
+ * @brief work-stealing thread pool the engine runs its parallel work on
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef TaskScheduler_hpp
+#define TaskScheduler_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Timer.hpp"
+
+namespace ECE141 {
+
+// USE: the engine's thread pool. Every worker owns a deque of tasks: it
+//      pushes and pops its own at the back (newest first, while their data
+//      is warm) and, once that is empty, steals from the front of another
+//      worker's (oldest first). Tasks from threads outside the pool are
+//      dealt to the deques round robin. Submit through a TaskGroup.
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  struct Stats {
+    size_t threads{0};
+    size_t tasks{0};   // started so far
+    size_t steals{0};  // of them, taken from another worker's deque
+    double busySeconds{0};
+    double utilization{0};  // busy share of every thread's time since start
+  };
+
+  explicit TaskScheduler(size_t aThreads);
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+  // the engine's scheduler: Config::workerThreads threads, started on first
+  // use
+  static TaskScheduler &get();
+
+  [[nodiscard]] size_t getSize() const;
+  [[nodiscard]] Stats getStats() const;
+
+ protected:
+  friend class TaskGroup;
+
+  struct Worker {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  void submit(Task aTask);
+  // run one queued task on the calling thread; false if none was queued
+  bool runOne();
+  // the calling thread's next task: its own deque's newest if it is a
+  // worker (aWorker), else the oldest of any deque
+  bool take(size_t aWorker, Task &aTask);
+  void runTask(Task &aTask);
+  void loop(size_t aWorker);
+  // the calling thread's worker number here, or the worker count if none
+  [[nodiscard]] size_t workerOfThisThread() const;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  std::mutex lock;                // idle workers sleep on wake
+  std::condition_variable wake;
+  std::atomic<size_t> queued{0};  // tasks in the deques
+  std::atomic<size_t> dealt{0};   // round robin for outside submits
+  std::atomic<size_t> tasks{0};
+  std::atomic<size_t> steals{0};
+  std::atomic<uint64_t> busyMicros{0};
+  bool stopping{false};
+  Timer started;
+};
+
+// USE: tasks that run on a scheduler as a unit. wait() returns once every
+//      task ran, and runs queued tasks itself meanwhile, so a task may wait
+//      for the tasks it spawned. cancel() is cooperative: tasks not started
+//      yet are dropped, and running ones see isCancelled() and can return
+//      early. A task that throws cancels the rest of the group, and wait()
+//      rethrows its exception (the first, if several threw). The destructor
+//      waits but never throws.
+class TaskGroup {
+ public:
+  explicit TaskGroup(TaskScheduler &aScheduler = TaskScheduler::get());
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  void run(TaskScheduler::Task aTask);
+  void wait();
+  void cancel();
+  [[nodiscard]] bool isCancelled() const;
+
+ protected:
+  // shared with the queued tasks, which may finish after a cancel
+  struct State {
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> cancelled{false};
+    std::mutex lock;
+    std::condition_variable done;
+    std::exception_ptr error;  // the first task's to throw; under lock
+  };
+
+  // until every task ran, whether or not one threw
+  void finish();
+
+  TaskScheduler &scheduler;
+  std::shared_ptr<State> state;
+};
+
+}  // namespace ECE141
+
+#endif /* TaskScheduler_hpp */
@@ -17,18 +17,42 @@
 #include <vector>
 #include <initializer_list>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <optional>
 #include <random>
 #include <stack>
+#include <stdexcept>
+#include <thread>
 
 #include "Application.hpp"
 #include "AboutUs.hpp"
+#include "AdaptiveRadixTree.hpp"
+#include "BatchOperators.hpp"
+#include "BloomFilter.hpp"
+#include "Entity.hpp"
 #include "Errors.hpp"
 #include "Config.hpp"
+#include "ExternalSorter.hpp"
+#include "FrontCodedKeys.hpp"
+#include "GroupVarint.hpp"
+#include "Helpers.hpp"
+#include "IndexAdvisor.hpp"
+#include "JoinOperators.hpp"
+#include "KeyEncoder.hpp"
+#include "QueryOperators.hpp"
+#include "RoaringBitmap.hpp"
+#include "RowSorter.hpp"
 #include "FolderReader.hpp"
 #include "TestSequencer.hpp"
 #include "Faked.hpp"
 #include "Timer.hpp"
 #include "ScriptRunner.hpp"
+#include "Statistics.hpp"
+#include "TaskScheduler.hpp"
+#include "TextSearch.hpp"
+#include "ZoneMap.hpp"
 
 //void showErrors(ECE141::StatusResult &aResult, std::ostream &anOutput) {
 //
@@ -1630,6 +1654,2234 @@ namespace ECE141 {
       return theResult;
     }
 
+    // ----------------------------------------------------
+    bool doCustomCompositeIndexTest() {
+      std::string theDBName("CompositeIdx");
+      std::string theDBName2("Dummy");
+      std::stringstream theStream1;
+      theStream1 << "create database " << theDBName << ";\n";
+      theStream1 << "create database " << theDBName2 << ";\n";
+      theStream1 << "use " << theDBName << ";\n";
+
+      addUsersTable(theStream1);
+      insertUsers(theStream1, 0, 10);
+      addBooksTable(theStream1);
+      insertBooks(theStream1, 0, 14);
+
+      theStream1 << "create index user_title on Books (user_id, title);\n";
+      theStream1 << "create index name_age on Users (last_name, age);\n";
+      // reload index from disk
+      theStream1 << "use " << theDBName2 << ";\n";
+      theStream1 << "use " << theDBName << ";\n";
+
+      theStream1 << "select * from Books where user_id=4;\n";
+      theStream1 << "select * from Books where user_id=1 and title=Mort;\n";
+      theStream1 << "select * from Books where user_id>1 and user_id<4;\n";
+      theStream1 << "select * from Users where last_name=King and age>70;\n";
+      insertBooks(theStream1, 0, 5);
+      theStream1 << "select * from Books where user_id=4;\n";
+      theStream1 << "delete from Books where user_id=1;\n";
+      theStream1 << "select * from Books where user_id<3;\n";
+      theStream1 << "update Books set user_id=5 where title=Misery;\n";
+      theStream1 << "select * from Books where user_id=5;\n";
+      theStream1 << "show indexes;\n";
+      theStream1 << "show index user_id, title from Books;\n";
+      theStream1 << "drop table Books;\n";
+      theStream1 << "show indexes;\n";
+
+      // rows without the range column: an index returns what a scan does
+      theStream1 << "create table Ages (id int NOT NULL auto_increment "
+                    "primary key, name varchar(20), age int);\n";
+      theStream1 << "insert into Ages (name, age) values (Bob, 30);\n";
+      theStream1 << "insert into Ages (name) values (Al);\n";
+      theStream1 << "select * from Ages where age < 35;\n";
+      theStream1 << "create index by_age on Ages (age);\n";
+      theStream1 << "select * from Ages where age < 35;\n";
+      theStream1 << "create index name_age on Ages (name, age);\n";
+      theStream1 << "select * from Ages where name=Al and age < 35;\n";
+      theStream1 << "select * from Ages where name=Al and age > 5;\n";
+
+      theStream1 << "drop database " << theDBName << ";\n";
+      theStream1 << "drop database " << theDBName2 << ";\n";
+      theStream1 << "quit;\n";
+
+      std::stringstream theInput(theStream1.str());
+      std::stringstream theOutput;
+
+      bool theResult = doScriptTest(theInput, theOutput);
+      if (theResult) {
+        Responses theResponses;
+        size_t theCount = analyzeOutput(theOutput, theResponses);
+        Expected theExpected({
+            {Commands::createDB, 1},
+            {Commands::createDB, 1},
+            {Commands::useDB, 0},
+            {Commands::createTable, 1},
+            {Commands::insert, 10},
+            {Commands::createTable, 1},
+            {Commands::insert, 14},
+            {Commands::useDB, 0},
+            {Commands::useDB, 0},
+            {Commands::select, 5},
+            {Commands::select, 1},
+            {Commands::select, 4},
+            {Commands::select, 1},
+            {Commands::insert, 5},
+            {Commands::select, 10},
+            {Commands::delet, 4},
+            {Commands::select, 3},
+            {Commands::update, 2},
+            {Commands::select, 3},
+            {Commands::showIndexes, 4},
+            {Commands::showIndex, 15},
+            {Commands::dropTable, 16},
+            {Commands::showIndexes, 2},
+            {Commands::createTable, 1},
+            {Commands::insert, 1},
+            {Commands::insert, 1},
+            {Commands::select, 2},
+            {Commands::select, 2},
+            {Commands::select, 1},
+            {Commands::select, 0},
+            {Commands::dropDB, 0},
+            {Commands::dropDB, 0},
+        });
+        if (!theCount || !(theExpected == theResponses)) {
+          theResult = false;
+        }
+      }
+      return theResult;
+    }
+
+    bool doCustomUniqueTest() {
+      std::string theDBName("UniqueIdx");
+      std::stringstream theStream1;
+      theStream1 << "create database " << theDBName << ";\n";
+      theStream1 << "use " << theDBName << ";\n";
+      theStream1 << "create table Members (";
+      theStream1 << " id int NOT NULL auto_increment primary key,";
+      theStream1 << " email varchar(30) unique,";
+      theStream1 << " zip int);\n";
+      theStream1 << "insert into Members (email, zip) values (a1,1),(a2,2),"
+                    "(a3,3);\n";
+      theStream1 << "create unique index zip_idx on Members (zip);\n";
+      theStream1 << "quit;\n";
+
+      std::stringstream theInput1(theStream1.str());
+      std::stringstream theOutput1;
+      bool theResult = doScriptTest(theInput1, theOutput1);
+      if (theResult) {
+        Responses theResponses;
+        size_t theCount = analyzeOutput(theOutput1, theResponses);
+        Expected theExpected({
+            {Commands::createDB, 1},
+            {Commands::useDB, 0},
+            {Commands::createTable, 1},
+            {Commands::insert, 3},
+        });
+        theResult = theCount && theExpected == theResponses;
+      }
+
+      // every one of these must be rejected before anything is written
+      std::vector<std::string> theViolations{
+          "insert into Members (email, zip) values (a4,4),(a1,5);",
+          "insert into Members (email, zip) values (a6,6),(a6,7);",
+          "insert into Members (id, email, zip) values (1,a8,8);",
+          "update Members set email=a2 where id=1;",
+          "update Members set zip=3 where id=1;",
+      };
+      for (const auto &theCommand : theViolations) {
+        std::stringstream theInput("use " + theDBName + ";\n" + theCommand +
+                                   "\nquit;\n");
+        std::stringstream theOutput;
+        StatusResult theStatus = doScriptTest(theInput, theOutput);
+        theResult = theResult && Errors::uniqueViolation == theStatus.error;
+      }
+
+      std::stringstream theStream2;
+      theStream2 << "use " << theDBName << ";\n";
+      theStream2 << "select * from Members;\n";
+      theStream2 << "update Members set id=9 where id=1;\n";
+      theStream2 << "select * from Members where id=9;\n";
+      theStream2 << "insert into Members (email, zip) values (a4,4);\n";
+      // no data block leaked by the rejected statements
+      theStream2 << "dump database " << theDBName << ";\n";
+      theStream2 << "drop database " << theDBName << ";\n";
+      theStream2 << "quit;\n";
+
+      std::stringstream theInput2(theStream2.str());
+      std::stringstream theOutput2;
+      if (theResult && (theResult = doScriptTest(theInput2, theOutput2))) {
+        Responses theResponses;
+        size_t theCount = analyzeOutput(theOutput2, theResponses);
+        Expected theExpected({
+            {Commands::useDB, 0},
+            {Commands::select, 3},
+            {Commands::update, 1},
+            {Commands::select, 1},
+            {Commands::insert, 1},
+            {Commands::dumpDB, 10},
+            {Commands::dropDB, 0},
+        });
+        theResult = theCount && theExpected == theResponses;
+      }
+      return theResult;
+    }
+
+    bool doCustomBloomFilterTest() {
+      constexpr uint32_t theKeyCount{5000};
+      BloomFilter theFilter(2 * theKeyCount);
+      for (uint32_t i = 0; i < theKeyCount; i++) {
+        theFilter.insert(BloomFilter::hash(i));
+        theFilter.insert(BloomFilter::hash("key" + std::to_string(i)));
+      }
+      // no false negatives...
+      for (uint32_t i = 0; i < theKeyCount; i++) {
+        if (!theFilter.mayContain(BloomFilter::hash(i)) ||
+            !theFilter.mayContain(
+                BloomFilter::hash("key" + std::to_string(i)))) {
+          return false;
+        }
+      }
+      // ...and few false positives (~1% at 10 bits per key)
+      size_t theFalsePositives{0};
+      for (uint32_t i = theKeyCount; i < 11 * theKeyCount; i++) {
+        theFalsePositives += theFilter.mayContain(BloomFilter::hash(i));
+      }
+      if (theFalsePositives > theKeyCount / 5) {
+        return false;
+      }
+
+      // survives an encode/decode round trip
+      std::stringstream theStream;
+      BloomFilter theCopy;
+      if (!theFilter.encode(theStream) || !theCopy.decode(theStream) ||
+          theCopy.getBlockCount() != theFilter.getBlockCount()) {
+        return false;
+      }
+      for (uint32_t i = 0; i < 11 * theKeyCount; i++) {
+        if (theCopy.mayContain(BloomFilter::hash(i)) !=
+            theFilter.mayContain(BloomFilter::hash(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool doCustomLazyIndexTest() {
+      // keep a single index in memory so every table switch evicts one
+      size_t thePrevSize = Config::getCacheSize(CacheType::indexes);
+      Config::setCacheSize(CacheType::indexes, 1);
+
+      std::string theDBName("LazyIdx");
+      std::string theDBName2("Dummy");
+      std::stringstream theStream1;
+      theStream1 << "create database " << theDBName << ";\n";
+      theStream1 << "create database " << theDBName2 << ";\n";
+      theStream1 << "use " << theDBName << ";\n";
+      addUsersTable(theStream1);
+      insertUsers(theStream1, 0, 10);
+      addBooksTable(theStream1);
+      insertBooks(theStream1, 0, 14);
+      theStream1 << "create index user_title on Books (user_id, title);\n";
+      // reopen: only the index catalog is read
+      theStream1 << "use " << theDBName2 << ";\n";
+      theStream1 << "use " << theDBName << ";\n";
+
+      theStream1 << "select * from Users where id=3;\n";
+      theStream1 << "select * from Books where user_id=4;\n";
+      insertUsers(theStream1, 0, 3);
+      insertBooks(theStream1, 0, 5);
+      theStream1 << "select * from Users;\n";
+      theStream1 << "select * from Books where user_id=4;\n";
+      // evicted (changed) indexes must have been written back
+      theStream1 << "use " << theDBName2 << ";\n";
+      theStream1 << "use " << theDBName << ";\n";
+      theStream1 << "select * from Books;\n";
+      theStream1 << "select * from Users;\n";
+      theStream1 << "show indexes;\n";
+      theStream1 << "drop database " << theDBName << ";\n";
+      theStream1 << "drop database " << theDBName2 << ";\n";
+      theStream1 << "quit;\n";
+
+      std::stringstream theInput(theStream1.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Config::setCacheSize(CacheType::indexes, thePrevSize);
+      if (theResult) {
+        Responses theResponses;
+        size_t theCount = analyzeOutput(theOutput, theResponses);
+        Expected theExpected({
+            {Commands::createDB, 1},
+            {Commands::createDB, 1},
+            {Commands::useDB, 0},
+            {Commands::createTable, 1},
+            {Commands::insert, 10},
+            {Commands::createTable, 1},
+            {Commands::insert, 14},
+            {Commands::useDB, 0},
+            {Commands::useDB, 0},
+            {Commands::select, 1},
+            {Commands::select, 5},
+            {Commands::insert, 3},
+            {Commands::insert, 5},
+            {Commands::select, 13},
+            {Commands::select, 10},
+            {Commands::useDB, 0},
+            {Commands::useDB, 0},
+            {Commands::select, 19},
+            {Commands::select, 13},
+            {Commands::showIndexes, 3},
+            {Commands::dropDB, 0},
+            {Commands::dropDB, 0},
+        });
+        if (!theCount || !(theExpected == theResponses)) {
+          theResult = false;
+        }
+      }
+      return theResult;
+    }
+
+    bool doCustomExternalSortTest() {
+      // a tiny run limit forces many spilled runs and a k-way merge
+      constexpr size_t theRunLimit{7};
+      std::mt19937 theRandom(141);
+      ExternalSorter theInts(theRunLimit);
+      ExternalSorter theStrings(theRunLimit);
+      for (uint32_t i = 0; i < 1000; i++) {
+        uint32_t theKey = theRandom() % 500;
+        theInts.add(theKey, i);
+        theStrings.add("key" + std::to_string(theKey), i);
+      }
+      for (auto* theSorter : {&theInts, &theStrings}) {
+        if (theSorter->getSize() != 1000 || theSorter->getRunCount() < 2) {
+          return false;
+        }
+        size_t theCount{0};
+        std::optional<IndexEntry> thePrev;
+        bool theSorted = theSorter->each([&](const IndexEntry& anEntry) {
+          theCount++;
+          bool theInOrder = !thePrev || !(anEntry < *thePrev);
+          thePrev = anEntry;
+          return theInOrder;
+        });
+        if (!theSorted || theCount != 1000) {
+          return false;
+        }
+      }
+
+      // CREATE INDEX streams the table through the external sort
+      size_t thePrevLimit = Config::sortRunLimit;
+      Config::sortRunLimit = theRunLimit;
+      std::string theDBName("ExtSort");
+      std::stringstream theStream;
+      theStream << "create database " << theDBName << ";\n";
+      theStream << "use " << theDBName << ";\n";
+      addUsersTable(theStream);
+      insertUsers(theStream, 0, 10);
+      addBooksTable(theStream);
+      insertBooks(theStream, 0, 14);
+      theStream << "create index user_title on Books (user_id, title);\n";
+      theStream << "select * from Books where user_id=4;\n";
+      theStream << "show indexes;\n";
+      theStream << "create unique index uniq_user on Books (user_id);\n";
+      theStream << "drop database " << theDBName << ";\n";
+      theStream << "quit;\n";
+
+      std::stringstream theInput(theStream.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Config::sortRunLimit = thePrevLimit;
+      // the duplicate user_id stops the script at the unique index
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      std::stringstream theIgnored;
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::createTable, 1},
+          {Commands::insert, 14},
+          {Commands::select, 5},
+          {Commands::showIndexes, 3},
+      });
+      return !theResult && theCount && theExpected == theResponses;
+    }
+
+    bool doCustomParallelIndexTest() {
+      // runs sorted by separate workers merge into one ordered stream
+      ExternalSorter theFirst(5);
+      ExternalSorter theSecond(5);
+      for (uint32_t i = 0; i < 40; i++) {
+        (i % 3 ? theFirst : theSecond).add((i * 7) % 40, i);
+      }
+      theSecond.flush();
+      theFirst.merge(theSecond);
+      std::vector<uint32_t> theKeys;
+      theFirst.each([&](const IndexEntry& anEntry) {
+        theKeys.push_back(std::get<uint32_t>(anEntry.first));
+        return true;
+      });
+      if (40 != theFirst.getSize() || 0 != theSecond.getSize() ||
+          40 != theKeys.size() || !std::is_sorted(theKeys.begin(), theKeys.end())) {
+        return false;
+      }
+
+      // more workers than blocks, and workers whose sorts spill
+      size_t thePrevLimit = Config::sortRunLimit;
+      Config::sortRunLimit = 16;
+      std::string theDBName("ParallelIdx");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      insertFakeUsers(theScript, 50, 4);
+      addBooksTable(theScript);
+      insertBooks(theScript, 0, 14);
+      theScript << "create index by_age on Users (age, id) with "
+                   "(parallel = 4);\n";
+      theScript << "create index by_user on Books (user_id) include (title) "
+                   "with (parallel = 32);\n";
+      theScript << "show index age, id from Users;\n";
+      theScript << "select * from Users where age>=0;\n";
+      theScript << "select title from Books where user_id=4;\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select * from Users where age>=0;\n";
+      theScript << "select user_id, title from Books where user_id>1;\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "create index by_zip on Users (zipcode) with "
+                   "(parallel = 0);\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Config::sortRunLimit = thePrevLimit;
+      // at least one worker: the script stops at parallel = 0
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      std::stringstream theIgnored;
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 50},
+          {Commands::insert, 50},
+          {Commands::insert, 50},
+          {Commands::insert, 50},
+          {Commands::createTable, 1},
+          {Commands::insert, 14},
+          {Commands::showIndex, 200},
+          {Commands::select, 200},
+          {Commands::select, 5},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 200},
+          {Commands::select, 10},
+          {Commands::dropDB, 0},
+      });
+      return !theResult && theCount && theExpected == theResponses;
+    }
+
+    bool doCustomParallelScanTest() {
+      // the same selects, serial and then on workers with tiny morsels
+      std::string theDBName("ParallelScanDB");
+      std::stringstream theSetup;
+      theSetup << "create database " << theDBName << ";\n";
+      theSetup << "use " << theDBName << ";\n";
+      addUsersTable(theSetup);
+      insertFakeUsers(theSetup, 50, 4);
+      theSetup << "quit;\n";
+      std::stringstream theSetupInput(theSetup.str());
+      std::stringstream theIgnored;
+      bool theResult = doScriptTest(theSetupInput, theIgnored);
+
+      std::stringstream theQueries;
+      theQueries << "use " << theDBName << ";\n";
+      theQueries << "select * from Users where id>0;\n";  // builds zones
+      theQueries << "select * from Users where age>40;\n";
+      theQueries << "select * from Users where age<30 order by last_name;\n";
+      theQueries << "select first_name from Users where zipcode>0 limit 7;\n";
+      theQueries << "select * from Users where id>180 or age=33;\n";
+      theQueries << "select * from Users where age>100;\n";
+      theQueries << "quit;\n";
+      // the rows, without the timings
+      std::string theLastOutput;
+      auto runQueries = [&](size_t aWorkers) {
+        size_t thePrevWorkers = Config::scanWorkers;
+        size_t thePrevBlocks = Config::morselBlocks;
+        Config::scanWorkers = aWorkers;
+        Config::morselBlocks = 4;
+        std::stringstream theInput(theQueries.str());
+        std::stringstream theOutput;
+        theResult = doScriptTest(theInput, theOutput) && theResult;
+        Config::scanWorkers = thePrevWorkers;
+        Config::morselBlocks = thePrevBlocks;
+        theLastOutput = theOutput.str();
+        std::string theRows;
+        std::string theLine;
+        while (std::getline(theOutput, theLine)) {
+          theRows += (theLine.find(" sec)") == std::string::npos)
+                         ? theLine + "\n"
+                         : theLine.substr(0, theLine.find('(')) + "\n";
+        }
+        return theRows;
+      };
+      std::string theSerial = runQueries(1);
+      std::string theParallel = runQueries(4);
+
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      std::stringstream theOutput(theLastOutput);
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::useDB, 0},
+          {Commands::select, 200},
+          {Commands::select, 1, '>'},
+          {Commands::select, 0, '>'},
+          {Commands::select, 7},
+          {Commands::select, 19, '>'},
+          {Commands::select, 0},
+      });
+      return theResult && theCount && theSerial == theParallel &&
+             theExpected == theResponses;
+    }
+
+    bool doCustomSchedulerTest() {
+      // tasks that spawn tasks and wait for them, on a private scheduler
+      TaskScheduler theScheduler(3);
+      std::atomic<size_t> theSum{0};
+      {
+        TaskGroup theOuter(theScheduler);
+        for (size_t i = 0; i < 20; i++) {
+          theOuter.run([&, i] {
+            TaskGroup theInner(theScheduler);
+            for (size_t j = 0; j < 5; j++) {
+              theInner.run([&, i, j] { theSum += i * 5 + j; });
+            }
+            theInner.wait();
+          });
+        }
+        theOuter.wait();
+      }
+      TaskScheduler::Stats theStats = theScheduler.getStats();
+      if (theSum != 99 * 100 / 2 || theStats.threads != 3 ||
+          theStats.tasks != 120 || theStats.utilization > 1.0) {
+        return false;
+      }
+
+      // a cancel drops the queued tasks and the running one sees it
+      TaskScheduler theSingle(1);
+      std::atomic<bool> theStarted{false};
+      std::atomic<bool> theSawCancel{false};
+      std::atomic<size_t> theRan{0};
+      TaskGroup theGroup(theSingle);
+      theGroup.run([&] {
+        theStarted = true;
+        while (!theGroup.isCancelled()) {
+          std::this_thread::yield();
+        }
+        theSawCancel = true;
+      });
+      while (!theStarted) {
+        std::this_thread::yield();
+      }
+      for (size_t i = 0; i < 10; i++) {
+        theGroup.run([&] { theRan++; });
+      }
+      theGroup.cancel();
+      theGroup.wait();
+      if (!theSawCancel || 0 != theRan || 11 != theSingle.getStats().tasks) {
+        return false;
+      }
+
+      // a task that throws, here from a nested group, fails wait() once
+      // and the group still finishes
+      std::atomic<size_t> theFinished{0};
+      bool theCaught{false};
+      TaskGroup theFailing(theScheduler);
+      for (size_t i = 0; i < 8; i++) {
+        theFailing.run([&, i] {
+          TaskGroup theInner(theScheduler);
+          theInner.run([i] {
+            if (3 == i) {
+              throw std::runtime_error("task failed");
+            }
+          });
+          theInner.wait();
+          theFinished++;
+        });
+      }
+      try {
+        theFailing.wait();
+      } catch (const std::runtime_error &) {
+        theCaught = true;
+      }
+      theFailing.wait();  // already reported: returns quietly
+      if (!theCaught || theFinished > 7) {
+        return false;
+      }
+
+      // the engine's scheduler runs the scans; show workers reports on it
+      std::string theDBName("SchedulerDB");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      insertFakeUsers(theScript, 50, 4);
+      theScript << "select * from Users where id>0;\n";  // builds zones
+      theScript << "select * from Users where age>=0;\n";
+      theScript << "show workers;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+      size_t thePrevWorkers = Config::scanWorkers;
+      size_t thePrevBlocks = Config::morselBlocks;
+      Config::scanWorkers = 4;
+      Config::morselBlocks = 4;
+      size_t theTasksBefore = TaskScheduler::get().getStats().tasks;
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Config::scanWorkers = thePrevWorkers;
+      Config::morselBlocks = thePrevBlocks;
+      // 200 rows in 50 morsels of 4 blocks, one task each
+      size_t theTasks = TaskScheduler::get().getStats().tasks - theTasksBefore;
+      std::string theText = theOutput.str();
+      return theResult && theTasks >= 50 &&
+             theText.find("| threads") != std::string::npos &&
+             theText.find("| " + std::to_string(Config::workerThreads)) !=
+                 std::string::npos;
+    }
+
+    bool doCustomParallelSortTest() {
+      // rows with duplicate keys, mixed types and missing columns, sorted
+      // in slices of 7 rows, against a stable sort comparing the Values
+      struct RowsSource : public QueryOperator {
+        explicit RowsSource(const RowCollection &aRows) : source{aRows} {}
+        StatusResult open() override {
+          position = 0;
+          return {Errors::noError};
+        }
+        StatusResult next(std::unique_ptr<Row> &aRow) override {
+          aRow = (position < source.size())
+                     ? std::make_unique<Row>(*source[position++])
+                     : nullptr;
+          return {Errors::noError};
+        }
+        void close() override {}
+        const RowCollection &source;
+        size_t position{0};
+      };
+      std::mt19937 theRandom(49);
+      RowCollection theRows;
+      for (int i = 0; i < 500; i++) {
+        auto theRow = std::make_unique<Row>(0, static_cast<uint32_t>(i));
+        theRow->insert("id", i);
+        theRow->insert("a", static_cast<int>(theRandom() % 20) - 10);
+        if (theRandom() % 5) {
+          std::string theName(theRandom() % 3, 'x');
+          theName += std::string(1, static_cast<char>('a' + theRandom() % 3));
+          theRow->insert("b", theName);
+        }
+        if (i % 7) {
+          theRow->insert("c", static_cast<double>(theRandom() % 9) - 4.5);
+        } else {
+          theRow->insert("c", static_cast<int>(theRandom() % 9) - 4);
+        }
+        theRows.push_back(std::move(theRow));
+      }
+      const StringList theOrder{"a", "b", "c"};
+      std::vector<const Row*> theExpected;
+      for (const auto& theRow : theRows) {
+        theExpected.push_back(theRow.get());
+      }
+      std::stable_sort(
+          theExpected.begin(), theExpected.end(),
+          [&](const Row* aLHS, const Row* aRHS) {
+            for (const auto& theField : theOrder) {
+              auto theL = aLHS->getData().find(theField);
+              auto theR = aRHS->getData().find(theField);
+              bool hasL = theL != aLHS->getData().end();
+              bool hasR = theR != aRHS->getData().end();
+              if (hasL != hasR) {
+                return hasR;  // a missing column sorts first
+              }
+              if (hasL && theL->second != theR->second) {
+                return theL->second < theR->second;
+              }
+            }
+            return false;
+          });
+      size_t thePrevRows = Config::sortChunkRows;
+      Config::sortChunkRows = 7;
+      bool theResult = true;
+      for (size_t theLimit : {0, 25}) {
+        SortOperator theSort(std::make_unique<RowsSource>(theRows), theOrder,
+                             theLimit);
+        std::unique_ptr<Row> theRow;
+        size_t theCount{0};
+        theSort.open();
+        while (theSort.next(theRow) && theRow &&
+               (0 == theLimit || theCount < theLimit)) {
+          theResult = theResult && theRow->getData().at("id") ==
+                                       theExpected[theCount]->getData().at("id");
+          theCount++;
+        }
+        theSort.close();
+        theResult = theResult && theCount == (theLimit ? theLimit : 500);
+      }
+      Config::sortChunkRows = thePrevRows;
+      if (!theResult) {
+        return false;
+      }
+
+      // order by through the engine, in one slice and in many
+      std::string theDBName("ParallelSortDB");
+      std::stringstream theSetup;
+      theSetup << "create database " << theDBName << ";\n";
+      theSetup << "use " << theDBName << ";\n";
+      addUsersTable(theSetup);
+      insertFakeUsers(theSetup, 50, 2);
+      theSetup << "quit;\n";
+      std::stringstream theSetupInput(theSetup.str());
+      std::stringstream theIgnored;
+      theResult = doScriptTest(theSetupInput, theIgnored);
+      std::stringstream theQueries;
+      theQueries << "use " << theDBName << ";\n";
+      theQueries << "select * from Users order by last_name, age;\n";
+      theQueries << "select * from Users order by zipcode limit 9;\n";
+      theQueries << "quit;\n";
+      std::string theLastOutput;
+      auto runQueries = [&](size_t aSliceRows) {
+        Config::sortChunkRows = aSliceRows;
+        std::stringstream theInput(theQueries.str());
+        std::stringstream theOutput;
+        theResult = doScriptTest(theInput, theOutput) && theResult;
+        Config::sortChunkRows = thePrevRows;
+        theLastOutput = theOutput.str();
+        std::string theLines;
+        std::string theLine;
+        while (std::getline(theOutput, theLine)) {
+          theLines += theLine.substr(0, theLine.find(" rows in set")) + "\n";
+        }
+        return theLines;
+      };
+      std::string theWhole = runQueries(thePrevRows);
+      std::string theSliced = runQueries(3);
+
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      std::stringstream theOutput(theLastOutput);
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpectedResponses({
+          {Commands::useDB, 0},
+          {Commands::select, 100},
+          {Commands::select, 9},
+      });
+      return theResult && theCount && theWhole == theSliced &&
+             theExpectedResponses == theResponses;
+    }
+
+    bool doCustomExternalOrderByTest() {
+      // a loser tree merges sorted sources, some of them empty
+      std::vector<std::vector<int>> theSources{
+          {1, 4, 4, 9}, {}, {0, 2, 3, 10, 11}, {4}, {}, {-5, 20}};
+      std::vector<size_t> thePositions(theSources.size(), 0);
+      auto isEnded = [&](size_t aSource) {
+        return thePositions[aSource] >= theSources[aSource].size();
+      };
+      LoserTree theTree;
+      theTree.reset(theSources.size(), [&](size_t a, size_t b) {
+        if (isEnded(a) || isEnded(b)) {
+          return !isEnded(a);
+        }
+        return theSources[a][thePositions[a]] < theSources[b][thePositions[b]];
+      });
+      std::vector<int> theMerged;
+      while (!isEnded(theTree.winner())) {
+        size_t theWinner = theTree.winner();
+        theMerged.push_back(theSources[theWinner][thePositions[theWinner]++]);
+        theTree.replay(theWinner);
+      }
+      if (12 != theMerged.size() ||
+          !std::is_sorted(theMerged.begin(), theMerged.end())) {
+        return false;
+      }
+
+      // a budget of a few rows spills many runs, merged back in order
+      auto runFiles = [] {
+        size_t theCount{0};
+        for (const auto& theEntry :
+             std::filesystem::directory_iterator(Config::getStoragePath())) {
+          std::string theName = theEntry.path().filename().string();
+          theCount += (0 == theName.rfind("sort-", 0) &&
+                       theEntry.path().extension() == ".run");
+        }
+        return theCount;
+      };
+      std::mt19937 theRandom(50);
+      {
+        RowSorter theSorter({"name", "score"}, 2000);
+        for (int i = 0; i < 300; i++) {
+          auto theRow = std::make_unique<Row>(7, static_cast<uint32_t>(i));
+          std::string theName = "n" + std::to_string(theRandom() % 40);
+          theRow->insert("id", i);
+          theRow->insert("name", theName);
+          theRow->insert("score", static_cast<double>(theRandom() % 10) / 4);
+          theRow->insert("flag", 0 == i % 2);
+          if (!theSorter.add(std::move(theRow))) {
+            return false;
+          }
+        }
+        if (!theSorter.rewind() || theSorter.getRunCount() < 10 ||
+            theSorter.getRunCount() != runFiles()) {
+          return false;
+        }
+        std::unique_ptr<Row> theRow;
+        std::optional<std::pair<std::string, double>> thePrev;
+        size_t theCount{0};
+        while (theSorter.next(theRow) && theRow) {
+          const KeyValues& theData = theRow->getData();
+          std::pair<std::string, double> theKey{
+              std::get<std::string>(theData.at("name")),
+              std::get<double>(theData.at("score"))};
+          int theId = std::get<int>(theData.at("id"));
+          if ((thePrev && theKey < *thePrev) || 7 != theRow->getEntityId() ||
+              static_cast<uint32_t>(theId) != theRow->getBlockNum() ||
+              std::get<bool>(theData.at("flag")) != (0 == theId % 2)) {
+            return false;
+          }
+          thePrev = theKey;
+          theCount++;
+        }
+        if (300 != theCount) {
+          return false;
+        }
+      }
+      if (0 != runFiles()) {
+        return false;  // the runs are removed with the sorter
+      }
+
+      // order by through the engine, in memory and spilled
+      std::string theDBName("ExtOrderDB");
+      std::stringstream theSetup;
+      theSetup << "create database " << theDBName << ";\n";
+      theSetup << "use " << theDBName << ";\n";
+      addUsersTable(theSetup);
+      insertFakeUsers(theSetup, 50, 2);
+      theSetup << "quit;\n";
+      std::stringstream theSetupInput(theSetup.str());
+      std::stringstream theIgnored;
+      bool theResult = doScriptTest(theSetupInput, theIgnored);
+      std::stringstream theQueries;
+      theQueries << "use " << theDBName << ";\n";
+      theQueries << "select * from Users order by last_name, age;\n";
+      theQueries << "select first_name, zipcode from Users where age>30 "
+                    "order by zipcode, first_name;\n";
+      theQueries << "quit;\n";
+      std::string theLastOutput;
+      size_t thePrevBytes = Config::sortMemoryBytes;
+      auto runQueries = [&](size_t aMemoryBytes) {
+        Config::sortMemoryBytes = aMemoryBytes;
+        std::stringstream theInput(theQueries.str());
+        std::stringstream theOutput;
+        theResult = doScriptTest(theInput, theOutput) && theResult;
+        Config::sortMemoryBytes = thePrevBytes;
+        theLastOutput = theOutput.str();
+        std::string theLines;
+        std::string theLine;
+        while (std::getline(theOutput, theLine)) {
+          theLines += theLine.substr(0, theLine.find(" rows in set")) + "\n";
+        }
+        return theLines;
+      };
+      std::string theInMemory = runQueries(thePrevBytes);
+      std::string theSpilled = runQueries(4096);
+
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      std::stringstream theOutput(theLastOutput);
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpectedResponses({
+          {Commands::useDB, 0},
+          {Commands::select, 100},
+          {Commands::select, 0, '>'},
+      });
+      return theResult && theCount && theInMemory == theSpilled &&
+             theExpectedResponses == theResponses && 0 == runFiles();
+    }
+
+    bool doCustomMergeJoinTest() {
+      // the sorter also hands its entries out a pull at a time
+      ExternalSorter theSorter(3);
+      for (uint32_t i = 0; i < 10; i++) {
+        theSorter.add(IndexKey{(i * 7) % 10}, i);
+      }
+      for (size_t thePass{0}; thePass < 2; thePass++) {
+        theSorter.rewind();
+        IndexEntry theEntry;
+        uint32_t theExpected{0};
+        while (theSorter.next(theEntry)) {
+          if (IndexKey{theExpected++} != theEntry.first) {
+            return false;
+          }
+        }
+        if (10 != theExpected) {
+          return false;
+        }
+      }
+
+      // the merge join hands out the rows of the hash join, in key order:
+      // keys repeat on both sides and some rows have none
+      struct SortedSource : public QueryOperator {
+        SortedSource(std::string aField, std::vector<int> aKeys)
+            : field{std::move(aField)}, keys{std::move(aKeys)} {}
+        StatusResult open() override {
+          position = 0;
+          return {Errors::noError};
+        }
+        StatusResult next(std::unique_ptr<Row> &aRow) override {
+          aRow.reset();
+          if (position < keys.size()) {
+            aRow = std::make_unique<Row>(0, static_cast<uint32_t>(position));
+            aRow->insert(field + "_row", static_cast<int>(position));
+            if (keys[position] >= 0) {
+              aRow->insert(field, keys[position]);
+            }
+            position++;
+          }
+          return {Errors::noError};
+        }
+        void close() override {}
+        std::string field;
+        std::vector<int> keys;
+        size_t position{0};
+      };
+      auto makeJoin = [](Keywords aType) {
+        Join theJoin("Books", aType);
+        Value theNone;
+        Operand theUsers("id", TokenType::identifier, theNone,
+                         Helpers::hashString(std::string("Users")));
+        Operand theBooks("user_id", TokenType::identifier, theNone,
+                         Helpers::hashString(std::string("Books")));
+        Operators theOp{Operators::equal_op};
+        std::vector<Logical> theLogics;
+        theJoin.exprs.push_back(std::make_unique<Expression>(
+            theUsers, theOp, theBooks, theLogics));
+        return theJoin;
+      };
+      auto drain = [](QueryOperator &aPlan) {
+        std::vector<std::string> theRows;
+        std::unique_ptr<Row> theRow;
+        aPlan.open();
+        while (aPlan.next(theRow) && theRow) {
+          std::stringstream theText;
+          for (const auto &[theKey, theValue] : theRow->getData()) {
+            theText << theKey << '=';
+            std::visit([&](const auto &aValue) { theText << aValue; },
+                       theValue);
+            theText << ';';
+          }
+          theRows.push_back(theText.str());
+        }
+        aPlan.close();
+        std::sort(theRows.begin(), theRows.end());
+        return theRows;
+      };
+      std::vector<int> theUserIds{-1, 1, 2, 2, 4, 6, 6, 9};  // -1: no id
+      std::vector<int> theBookOwners{-1, -1, 0, 2, 2, 2, 3, 6, 7, 9, 9};
+      std::map<Keywords, size_t> theCounts{{Keywords::inner_kw, 10},
+                                           {Keywords::left_kw, 13},
+                                           {Keywords::right_kw, 15},
+                                           {Keywords::full_kw, 18}};
+      for (const auto &[theType, theCount] : theCounts) {
+        Join theJoin = makeJoin(theType);
+        MergeJoinOperator theMerge(
+            std::make_unique<SortedSource>("id", theUserIds),
+            std::make_unique<SortedSource>("user_id", theBookOwners), theJoin);
+        HashJoinOperator theHash(
+            std::make_unique<SortedSource>("id", theUserIds),
+            std::make_unique<SortedSource>("user_id", theBookOwners), theJoin);
+        std::vector<std::string> theMerged = drain(theMerge);
+        if (theCount != theMerged.size() || drain(theHash) != theMerged) {
+          return false;
+        }
+      }
+
+      // joins read in index order; without the index, a hash limit of 0
+      // sends both sides through the external sort
+      auto runJoins = [&](bool hasIndex) {
+        std::string theDBName("MergeJoinDB");
+        std::stringstream theScript;
+        theScript << "create database " << theDBName << ";\n";
+        theScript << "use " << theDBName << ";\n";
+        addUsersTable(theScript);
+        addBooksTable(theScript);
+        insertUsers(theScript, 0, 10);
+        insertBooks(theScript, 0, 14);
+        if (hasIndex) {
+          theScript << "create index owner on Books (user_id);\n";
+        }
+        theScript << "select first_name, title from Users left join Books on "
+                     "Users.id=Books.user_id order by title;\n";
+        theScript << "select first_name, title from Users inner join Books "
+                     "on Books.user_id=Users.id;\n";
+        theScript << "select first_name, title from Users right join Books "
+                     "on Users.id=Books.user_id;\n";
+        theScript << "select first_name, title from Users full join Books on "
+                     "Users.id=Books.user_id;\n";
+        theScript << "drop database " << theDBName << ";\n";
+        theScript << "quit;\n";
+
+        size_t thePrevLimit = Config::hashJoinLimit;
+        Config::hashJoinLimit = hasIndex ? thePrevLimit : 0;
+        std::stringstream theInput(theScript.str());
+        std::stringstream theOutput;
+        bool theResult = doScriptTest(theInput, theOutput);
+        Config::hashJoinLimit = thePrevLimit;
+        Responses theResponses;
+        size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+        Expected theExpected({
+            {Commands::createDB, 1},
+            {Commands::useDB, 0},
+            {Commands::createTable, 1},
+            {Commands::createTable, 1},
+            {Commands::insert, 10},
+            {Commands::insert, 14},
+            {Commands::select, 19},
+            {Commands::select, 14},
+            {Commands::select, 14},
+            {Commands::select, 19},
+            {Commands::dropDB, 0},
+        });
+        return theResult && theScriptCount && theExpected == theResponses;
+      };
+      return runJoins(true) && runJoins(false);
+    }
+
+    bool doCustomPipelineTest() {
+      // rows flow one at a time: a limit stops pulling from its source
+      struct CountingSource : public QueryOperator {
+        size_t pulls{0};
+        StatusResult open() override { return {Errors::noError}; }
+        StatusResult next(std::unique_ptr<Row> &aRow) override {
+          aRow.reset();
+          if (pulls < 100) {
+            aRow = std::make_unique<Row>(0, static_cast<uint32_t>(pulls));
+            aRow->insert("n", static_cast<int>(99 - pulls));
+            aRow->insert("odd", static_cast<int>(pulls % 2));
+            pulls++;
+          }
+          return {Errors::noError};
+        }
+        void close() override {}
+      };
+      auto *theSource = new CountingSource;
+      LimitOperator theLimit(OperatorPtr{theSource}, 3);
+      std::unique_ptr<Row> theRow;
+      size_t theCount{0};
+      theLimit.open();
+      while (theLimit.next(theRow) && theRow) {
+        theCount++;
+      }
+      theLimit.close();
+      if (3 != theCount || 3 != theSource->pulls) {
+        return false;
+      }
+      // top 2 of the sorted rows, trimmed to one column
+      ProjectOperator thePlan(
+          std::make_unique<LimitOperator>(
+              std::make_unique<SortOperator>(
+                  std::make_unique<CountingSource>(), StringList{"n"}, 2),
+              2),
+          StringList{"n"});
+      std::vector<int> theValues;
+      thePlan.open();
+      while (thePlan.next(theRow) && theRow) {
+        if (1 != theRow->getData().size()) {
+          return false;
+        }
+        theValues.push_back(std::get<int>(theRow->getData().at("n")));
+      }
+      thePlan.close();
+      if (std::vector<int>({0, 1}) != theValues) {
+        return false;
+      }
+
+      std::string theDBName("PipelineDB");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      addBooksTable(theScript);
+      insertUsers(theScript, 0, 10);
+      insertBooks(theScript, 0, 14);
+      theScript << "select * from Books order by title limit 3;\n";
+      theScript << "select title from Books where user_id=4 limit 2;\n";
+      theScript << "select first_name from Users limit 4;\n";
+      theScript << "select first_name, title from Users left join Books on "
+                   "Users.id=Books.user_id where age>60 order by title;\n";
+      theScript << "select * from Users where age>200;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::insert, 14},
+          {Commands::select, 3},
+          {Commands::select, 2},
+          {Commands::select, 4},
+          {Commands::select, 13},
+          {Commands::select, 0},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomBitmapIndexTest() {
+      // sparse containers, and a dense one (> 4096 values under one key)
+      RoaringBitmap theEvens;
+      RoaringBitmap theTriples;
+      for (uint32_t i = 0; i < 30000; i += 2) {
+        theEvens.add(i);
+      }
+      for (uint32_t i = 0; i < 30000; i += 3) {
+        theTriples.add(i);
+      }
+      theEvens.add(1u << 20);
+      theTriples.add(1u << 20);
+      RoaringBitmap theBoth{theEvens};
+      theBoth &= theTriples;
+      RoaringBitmap theEither{theEvens};
+      theEither |= theTriples;
+      RoaringBitmap theOnlyEvens{theEvens};
+      theOnlyEvens -= theTriples;
+      if (15001 != theEvens.cardinality() || 5001 != theBoth.cardinality() ||
+          20001 != theEither.cardinality() ||
+          10000 != theOnlyEvens.cardinality() || !theBoth.contains(6) ||
+          theBoth.contains(4) || !theEither.contains(9) ||
+          theOnlyEvens.contains(12) || theOnlyEvens.contains(1u << 20)) {
+        return false;
+      }
+      size_t theCount{0};
+      uint32_t thePrev{0};
+      bool theSorted = theEither.each([&](uint32_t aValue) {
+        bool theOk = 0 == theCount++ || thePrev < aValue;
+        thePrev = aValue;
+        return theOk;
+      });
+      theBoth.remove(6);
+      std::stringstream theStream;
+      RoaringBitmap theCopy;
+      if (!theSorted || theCount != theEither.cardinality() ||
+          theBoth.contains(6) || !theEither.encode(theStream) ||
+          !theCopy.decode(theStream) || !(theCopy == theEither)) {
+        return false;
+      }
+
+      // where clauses mixing AND/OR/NOT are answered by the bitmaps
+      std::string theDBName("BitmapDB");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      insertUsers(theScript, 0, 10);
+      theScript << "create bitmap index by_zip on Users (zipcode);\n";
+      theScript << "create bitmap index by_last on Users (last_name);\n";
+      insertUsers(theScript, 0, 10);
+      theScript << "select * from Users where zipcode=92120;\n";
+      theScript << "select * from Users where zipcode=92120 or "
+                   "zipcode=92124;\n";
+      theScript << "select * from Users where not zipcode=92120 and "
+                   "last_name=King;\n";
+      theScript << "select * from Users where zipcode<92123 or "
+                   "last_name=Tolkien;\n";
+      theScript << "select * from Users where zipcode>=92126 and age>100;\n";
+      theScript << "delete from Users where zipcode=92120;\n";
+      theScript << "update Users set zipcode=92120 where last_name=King;\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select * from Users where zipcode=92120;\n";
+      theScript << "select * from Users where not zipcode=92120 or "
+                   "last_name=Taylor;\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "create bitmap index by_name on Users (first_name, age);\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      // a bitmap index has exactly one column: the script stops there
+      bool theResult = doScriptTest(theInput, theOutput);
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      std::stringstream theIgnored;
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::insert, 10},
+          {Commands::select, 4},
+          {Commands::select, 6},
+          {Commands::select, 2},
+          {Commands::select, 10},
+          {Commands::select, 4},
+          {Commands::delet, 4},
+          {Commands::update, 2},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 2},
+          {Commands::select, 14},
+          {Commands::dropDB, 0},
+      });
+      return !theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomFrontCodingTest() {
+      // long shared prefixes, plus keys the old space separated image broke
+      std::vector<std::string> theKeys;
+      for (int i = 0; i < 100; i++) {
+        std::string theNum{std::to_string(1000 + i)};
+        theKeys.push_back("https://example.com/users/" + theNum);
+      }
+      theKeys.push_back("zz with spaces");
+      theKeys.push_back(std::string("zz\0nul", 6));
+      std::sort(theKeys.begin(), theKeys.end());
+      FrontCodedKeys thePage;
+      size_t theRawSize{0};
+      for (const auto& theKey : theKeys) {
+        thePage.add(theKey);
+        theRawSize += theKey.size();
+      }
+      std::stringstream theStream;
+      FrontCodedKeys theCopy;
+      if (!thePage.encode(theStream) || !theCopy.decode(theStream) ||
+          theKeys.size() != theCopy.size() ||
+          2 * thePage.getByteSize() > theRawSize ||
+          !theCopy.find("https://example.com/users/1000") ||
+          theCopy.find("https://example.com/users/10") || theCopy.find("a")) {
+        return false;
+      }
+      std::vector<std::string> theDecoded;
+      theCopy.each([&](const std::string& aKey, size_t) {
+        theDecoded.push_back(aKey);
+        return true;
+      });
+      for (size_t i = 0; i < theKeys.size(); i++) {
+        if (theCopy.find(theKeys[i]) != i) {
+          return false;
+        }
+      }
+      if (theDecoded != theKeys) {
+        return false;
+      }
+
+      // string primary keys with spaces survive a reload
+      std::string theDBName("FrontCodingDB");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "create table Sites (url varchar(60) primary key, "
+                   "hits int);\n";
+      theScript << "insert into Sites (url, hits) values "
+                   "(\"http://example.com/a b\",1), "
+                   "(\"http://example.com/a c\",2), "
+                   "(\"http://example.com/b\",3), (\"mailto:x@y.org\",4);\n";
+      theScript << "create index by_hits on Sites (hits, url);\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select * from Sites;\n";
+      theScript << "select * from Sites where url=\"http://example.com/a c\";\n";
+      theScript << "select * from Sites where hits=3;\n";
+      theScript << "delete from Sites where url=\"http://example.com/a b\";\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select * from Sites where hits<3;\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 4},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 4},
+          {Commands::select, 1},
+          {Commands::select, 1},
+          {Commands::delet, 1},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 1},
+          {Commands::dropDB, 0},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomGroupVarintTest() {
+      // every byte length, a partial last group, and gaps in both directions
+      std::vector<uint32_t> theValues{0,     1,        255,        256,
+                                      65535, 65536,    (1u << 24), 0xFFFFFFFF,
+                                      7,     1u << 31, 3};
+      std::string theBytes;
+      GroupVarint::append(theBytes, GroupVarint::toZigzagDeltas(theValues));
+      std::vector<uint32_t> theDecoded;
+      size_t thePos{0};
+      if (!GroupVarint::read(theBytes, thePos, theValues.size(), theDecoded) ||
+          thePos != theBytes.size()) {
+        return false;
+      }
+      std::vector<uint32_t> thePastEnd;
+      if (GroupVarint::read(theBytes, thePos, 1, thePastEnd)) {
+        return false;
+      }
+      GroupVarint::fromZigzagDeltas(theDecoded);
+      std::vector<uint32_t> theKeys;
+      for (uint32_t i = 1; i <= 1000; i++) {
+        theKeys.push_back(1000 + 3 * i);
+      }
+      std::string theKeyBytes;
+      GroupVarint::append(theKeyBytes, GroupVarint::toDeltas(theKeys));
+      std::vector<uint32_t> theKeyCopy;
+      thePos = 0;
+      // gaps of 3 take a byte each (the first key two), plus a tag per four
+      if (theDecoded != theValues || 1251 != theKeyBytes.size() ||
+          !GroupVarint::read(theKeyBytes, thePos, theKeys.size(),
+                             theKeyCopy)) {
+        return false;
+      }
+      GroupVarint::fromDeltas(theKeyCopy);
+      if (theKeyCopy != theKeys) {
+        return false;
+      }
+
+      // the primary key index round trips through the packed image
+      std::string theDBName("GroupVarintDB");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      insertFakeUsers(theScript, 50, 4);
+      theScript << "delete from Users where id<=50;\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select * from Users where id>150;\n";
+      theScript << "select * from Users where id=100;\n";
+      theScript << "select * from Users;\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 50},
+          {Commands::insert, 50},
+          {Commands::insert, 50},
+          {Commands::insert, 50},
+          {Commands::delet, 50},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 50},
+          {Commands::select, 1},
+          {Commands::select, 150},
+          {Commands::dropDB, 0},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomAdaptiveRadixTreeTest() {
+      // mirror every operation in a std::map and compare the ordered walks
+      AdaptiveRadixTree theTree;
+      std::map<std::string, uint32_t> theExpected;
+      auto sameAs = [&](const std::string &aLow) {
+        auto theIter = theExpected.lower_bound(aLow);
+        bool theResult = theTree.eachFrom(
+            aLow, [&](const std::string &aKey, uint32_t aValue) {
+              bool theMatch = theIter != theExpected.end() &&
+                              theIter->first == aKey &&
+                              theIter->second == aValue;
+              ++theIter;
+              return theMatch;
+            });
+        return theResult && theIter == theExpected.end() &&
+               theTree.size() == theExpected.size();
+      };
+      auto add = [&](const std::string &aKey, uint32_t aValue) {
+        bool theAdded = theExpected.emplace(aKey, aValue).second;
+        return theAdded == theTree.insert(aKey, aValue);
+      };
+
+      // keys that are prefixes of others, an empty key, embedded zeros
+      for (const char *theKey : {"abc", "ab", "abcd", "", "b", "abd", "a"}) {
+        if (!add(theKey, static_cast<uint32_t>(theExpected.size()))) {
+          return false;
+        }
+      }
+      if (!add(std::string("a\0b", 3), 99) || !add("ab", 42) ||
+          !theTree.find("ab") || 1 != *theTree.find("ab") ||
+          theTree.find("abe") || theTree.find("abcde") || !sameAs("") ||
+          !sameAs("ab") || !sameAs("abca") || !sameAs("c")) {
+        return false;
+      }
+
+      // fan-out past 4, 16, 48 under one byte, then random keys
+      for (uint32_t i = 0; i < 256; i++) {
+        std::string theKey{"k"};
+        KeyEncoder::appendBlockNum(theKey, i * 0x01000000u);
+        if (!add(theKey, i)) {
+          return false;
+        }
+      }
+      std::mt19937 theRandom(141);
+      for (uint32_t i = 0; i < 3000; i++) {
+        std::string theKey;
+        KeyEncoder::appendBlockNum(theKey, theRandom() % 5000);
+        if (!add(theKey, i)) {
+          return false;
+        }
+      }
+      if (!sameAs("") || !sameAs("k") || !sameAs(std::string("\0\0\x10", 3))) {
+        return false;
+      }
+
+      // erase shrinks nodes back down and collapses single children
+      std::vector<std::string> theKeys;
+      for (const auto &[theKey, theValue] : theExpected) {
+        theKeys.push_back(theKey);
+      }
+      std::shuffle(theKeys.begin(), theKeys.end(), theRandom);
+      for (size_t i = 0; i < theKeys.size(); i++) {
+        if (!theTree.erase(theKeys[i]) || theTree.erase(theKeys[i])) {
+          return false;
+        }
+        theExpected.erase(theKeys[i]);
+        if (0 == i % 500 && !sameAs("")) {
+          return false;
+        }
+      }
+      return theTree.isEmpty() && sameAs("") && !theTree.find("ab");
+    }
+
+    bool doCustomCoveringIndexTest() {
+      std::string theDBName("CoveringDB");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addBooksTable(theScript);
+      insertBooks(theScript, 0, 14);
+      theScript << "create index by_user on Books (user_id) include (title);\n";
+      // answered from the index entries alone
+      theScript << "select id from Books where id>10;\n";
+      theScript << "select title from Books where user_id=4;\n";
+      theScript << "select user_id, title from Books where user_id>1 and "
+                   "user_id<4 order by title;\n";
+      theScript << "select title from Books where title=Mort;\n";
+      theScript << "update Books set title=Wyrd where title=Thud;\n";
+      theScript << "select title from Books where user_id=1 and title=Wyrd;\n";
+      theScript << "delete from Books where user_id=5;\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select user_id, title from Books where user_id<3;\n";
+      // subtitle is not in the index: rows come from the data blocks
+      theScript << "select * from Books where user_id=4;\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "create unique index by_title on Books (title) include "
+                   "(user_id);\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      // a unique index can't include columns: the script stops there
+      bool theResult = doScriptTest(theInput, theOutput);
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      std::stringstream theIgnored;
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 14},
+          {Commands::select, 4},
+          {Commands::select, 5},
+          {Commands::select, 4},
+          {Commands::select, 1},
+          {Commands::update, 1},
+          {Commands::select, 1},
+          {Commands::delet, 1},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 7},
+          {Commands::select, 5},
+          {Commands::dropDB, 0},
+      });
+      return !theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomHashJoinTest() {
+      // rows made up on the fly: aCount of them, filled in by aFill
+      struct MadeUpSource : public QueryOperator {
+        MadeUpSource(size_t aCount, std::function<void(Row &, size_t)> aFill)
+            : count{aCount}, fill{std::move(aFill)} {}
+        StatusResult open() override {
+          position = 0;
+          return {Errors::noError};
+        }
+        StatusResult next(std::unique_ptr<Row> &aRow) override {
+          aRow.reset();
+          if (position < count) {
+            aRow = std::make_unique<Row>();
+            fill(*aRow, position++);
+          }
+          return {Errors::noError};
+        }
+        void close() override {}
+        size_t count;
+        size_t position{0};
+        std::function<void(Row &, size_t)> fill;
+      };
+      // Users.id=Books.user_id, written either way round
+      auto makeJoin = [](Keywords aType, bool isSwapped) {
+        Join theJoin("Books", aType);
+        Value theNone;
+        Operand theUsers("id", TokenType::identifier, theNone,
+                         Helpers::hashString(std::string("Users")));
+        Operand theBooks("user_id", TokenType::identifier, theNone,
+                         Helpers::hashString(std::string("Books")));
+        Operators theOp{Operators::equal_op};
+        std::vector<Logical> theLogics;
+        theJoin.exprs.push_back(std::make_unique<Expression>(
+            isSwapped ? theBooks : theUsers, theOp,
+            isSwapped ? theUsers : theBooks, theLogics));
+        return theJoin;
+      };
+      // either side may be the smaller one the table is built on; books
+      // point at users 0..users+9, so some books and some users go unmatched
+      for (auto [theUsers, theBooks] :
+           {std::pair<size_t, size_t>{2000, 50000}, {50000, 2000}}) {
+        size_t theOwners = std::min(theUsers, theBooks);
+        size_t theInner{0};
+        std::vector<bool> hasBooks(theUsers, false);
+        for (size_t i{0}; i < theBooks; i++) {
+          size_t theOwner = i % (theOwners + 10);
+          if (theOwner < theUsers) {
+            theInner++;
+            hasBooks[theOwner] = true;
+          }
+        }
+        auto theLonelyUsers = static_cast<size_t>(
+            std::count(hasBooks.begin(), hasBooks.end(), false));
+        std::map<Keywords, size_t> theExpected{
+            {Keywords::inner_kw, theInner},
+            {Keywords::left_kw, theInner + theLonelyUsers},
+            {Keywords::right_kw, theBooks},
+            {Keywords::full_kw, theBooks + theLonelyUsers},
+        };
+        for (const auto &[theType, theCount] : theExpected) {
+          Join theJoin = makeJoin(theType, Keywords::inner_kw == theType);
+          if (!JoinColumns::canHash(theJoin)) {
+            return false;
+          }
+          HashJoinOperator thePlan(
+              std::make_unique<MadeUpSource>(
+                  theUsers,
+                  [](Row &aRow, size_t i) {
+                    aRow.insert("id", static_cast<int>(i));
+                    aRow.insert("name", "user" + std::to_string(i));
+                  }),
+              std::make_unique<MadeUpSource>(
+                  theBooks,
+                  [theOwners](Row &aRow, size_t i) {
+                    aRow.insert("id", static_cast<int>(i));
+                    aRow.insert("user_id",
+                                static_cast<double>(i % (theOwners + 10)));
+                  }),
+              theJoin);
+          std::unique_ptr<Row> theRow;
+          size_t theRows{0};
+          bool isConsistent{true};
+          thePlan.open();
+          while (thePlan.next(theRow) && theRow) {
+            theRows++;
+            // matched pairs agree on the key; padded sides are NULL
+            const KeyValues &theData = theRow->getData();
+            Value theName = theData.at("name");
+            Value theOwner = theData.at("user_id");
+            if (auto *theUserId = std::get_if<double>(&theOwner)) {
+              isConsistent = isConsistent &&
+                             (Value{"user" + std::to_string(static_cast<int>(
+                                                 *theUserId))} == theName ||
+                              Value{std::string("NULL")} == theName);
+            }
+          }
+          thePlan.close();
+          if (theCount != theRows || !isConsistent) {
+            return false;
+          }
+        }
+      }
+      // a non-equality term can't be hashed (the nested loop handles it)
+      Join theJoin = makeJoin(Keywords::left_kw, false);
+      theJoin.exprs.front()->op = Operators::lt_op;
+      return !JoinColumns::canHash(theJoin);
+    }
+
+    bool doCustomIndexAdviceTest() {
+      // a = 1 and b > 2 kept 1 of 100 rows: each column alone would still
+      // read 10 of them, both together 1
+      IndexAdvisor theAdvisor;
+      theAdvisor.recordScan("T",
+                            {{"b", Operators::gt_op, 2},
+                             {"a", Operators::equal_op, 1},
+                             {"c", Operators::notequal_op, 3}},
+                            100, 1, 1.0);
+      theAdvisor.recordJoin("U", "x", 0.5);
+      theAdvisor.recordScan("V", {{"y", Operators::equal_op, 1}}, 10, 10, 1.0);
+      auto theAdvice = theAdvisor.advise(
+          [](const std::string &aTable, const StringList &aFields) {
+            return "T" == aTable && StringList{"b"} == aFields;
+          });
+      if (3 != theAdvice.size() ||
+          StringList({"a", "b"}) != theAdvice[0].fields ||
+          std::abs(theAdvice[0].savings - 0.99) > 1e-9 ||
+          StringList{"a"} != theAdvice[1].fields ||
+          std::abs(theAdvice[1].savings - 0.9) > 1e-9 ||
+          "U" != theAdvice[2].table || 1 != theAdvice[2].queries) {
+        return false;
+      }
+
+      std::string theDBName("AdviceDB");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      addBooksTable(theScript);
+      insertUsers(theScript, 0, 10);
+      insertBooks(theScript, 0, 14);
+      theScript << "select * from Users where age>60;\n";
+      theScript << "select * from Users where zipcode=92120 and age>50;\n";
+      // the primary key is indexed already
+      theScript << "select * from Users where id=3;\n";
+      theScript << "select first_name, title from Users left join Books on "
+                   "Users.id=Books.user_id;\n";
+      theScript << "create index by_age on Users (age);\n";
+      // zipcode, (zipcode, age) and Books.user_id; age has an index now
+      theScript << "show index advice;\n";
+      theScript << "drop table Books;\n";
+      theScript << "show index advice;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::insert, 14},
+          {Commands::select, 6},
+          {Commands::select, 1},
+          {Commands::select, 1},
+          {Commands::select, 19},
+          {Commands::showIndex, 3},
+          {Commands::dropTable, 15},
+          {Commands::showIndex, 2},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomIndexJoinTest() {
+      // a where clause on the left table narrows it, then each left row
+      // looks its books up in an index (or the primary key) of the other
+      std::string theDBName("IndexJoinDB");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      addBooksTable(theScript);
+      insertUsers(theScript, 0, 10);
+      insertBooks(theScript, 0, 14);
+      theScript << "create index owner on Books (user_id);\n";
+      theScript << "select first_name, title from Users left join Books on "
+                   "Users.id=Books.user_id where id=4;\n";
+      // no books: padded with the NULL row
+      theScript << "select * from Users left join Books on "
+                   "Users.id=Books.user_id where id=6;\n";
+      theScript << "select first_name, title from Users inner join Books on "
+                   "Books.user_id=Users.id where id=1;\n";
+      theScript << "select first_name, title from Users inner join Books on "
+                   "Books.user_id=Users.id where id=6;\n";
+      theScript << "select first_name, title from Users left join Books on "
+                   "Users.id=Books.user_id where id>=3 and id<=4;\n";
+      // the probe reads the primary index of Users
+      theScript << "select title, first_name from Books left join Users on "
+                   "Books.user_id=Users.id where id=14;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::insert, 14},
+          {Commands::select, 5},
+          {Commands::select, 1},
+          {Commands::select, 4},
+          {Commands::select, 0},
+          {Commands::select, 6},
+          {Commands::select, 1},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomFullTextTest() {
+      using Anchor = TextSearch::Anchor;
+      auto thePieces = TextSearch::likePieces("the gr%tion");
+      if (!TextSearch::like("The Green Mile", "%green%") ||
+          !TextSearch::like("Misery", "m_s%") ||
+          !TextSearch::like("abcbc", "a%c%c") ||
+          TextSearch::like("ac", "a_c") || TextSearch::like("Mort", "%x%") ||
+          StringList({"the", "green", "mile", "11", "22"}) !=
+              TextSearch::terms("The Green-Mile 11/22") ||
+          !TextSearch::matchesAll("The Green Mile", "mile GREEN") ||
+          TextSearch::matchesAll("The Green Mile", "mile red") ||
+          TextSearch::matchesAll("The Green Mile", "") ||
+          3 != thePieces.size() || Anchor::exact != thePieces[0].anchor ||
+          "gr" != thePieces[1].text || Anchor::prefix != thePieces[1].anchor ||
+          Anchor::suffix != thePieces[2].anchor) {
+        return false;
+      }
+
+      // LIKE / MATCH are answered from the posting lists, then re-checked
+      std::string theDBName("FullTextDB");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addBooksTable(theScript);
+      insertBooks(theScript, 0, 7);
+      theScript << "create fulltext index by_words on Books (title);\n";
+      insertBooks(theScript, 7, 7);
+      theScript << "select * from Books where title like '%the%';\n";
+      theScript << "select * from Books where title like '%is%';\n";
+      theScript << "select * from Books where title like 'the %';\n";
+      theScript << "select * from Books where title like '%tion';\n";
+      theScript << "select * from Books where title match 'the stand';\n";
+      theScript << "select * from Books where title not like '%the%';\n";
+      theScript << "select * from Books where title like '%the%' and "
+                   "user_id=2;\n";
+      theScript << "select * from Books where title match 'mort' or "
+                   "title match 'THUD';\n";
+      theScript << "select * from Books where title like '11/22%';\n";
+      theScript << "update Books set title='The Colour of Magic' where "
+                   "title match 'mort';\n";
+      theScript << "delete from Books where title like '%tion';\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      theScript << "select * from Books where title match 'the';\n";
+      theScript << "select * from Books where title like '%mort%';\n";
+      theScript << "select * from Books where title match 'magic';\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "create fulltext index by_user on Books (user_id);\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      // only a varchar column can be full-text indexed: the script stops there
+      bool theResult = doScriptTest(theInput, theOutput);
+      std::stringstream theCleanup("drop database " + theDBName + ";\nquit;\n");
+      std::stringstream theIgnored;
+      doScriptTest(theCleanup, theIgnored);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 7},
+          {Commands::insert, 7},
+          {Commands::select, 6},
+          {Commands::select, 2},
+          {Commands::select, 6},
+          {Commands::select, 2},
+          {Commands::select, 1},
+          {Commands::select, 8},
+          {Commands::select, 3},
+          {Commands::select, 2},
+          {Commands::select, 1},
+          {Commands::update, 1},
+          {Commands::delet, 2},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::select, 6},
+          {Commands::select, 0},
+          {Commands::select, 1},
+          {Commands::dropDB, 0},
+      });
+      return !theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomCompiledFilterTest() {
+      Entity theEntity("Users");
+      theEntity.addAttribute(Attribute("id", DataTypes::int_type, 0))
+          .addAttribute(Attribute("name", DataTypes::varchar_type, 20))
+          .addAttribute(Attribute("nick", DataTypes::varchar_type, 20))
+          .addAttribute(Attribute("age", DataTypes::int_type, 0))
+          .addAttribute(Attribute("score", DataTypes::float_type, 0));
+      KeyValues theRow{{"id", 5},
+                       {"name", std::string("Terry")},
+                       {"age", 70},
+                       {"score", 2.5}};
+      // AND binds tighter than OR; NOTs, constants on the left, mixed
+      // types and a field the row doesn't have (nick)
+      std::vector<std::pair<std::string, bool>> theClauses{
+          {"age > 40 and id < 3 or name = 'Terry';", true},
+          {"age > 40 and id < 3 or name = 'Ted';", false},
+          {"id = 5 or id = 1 and age < 50;", true},
+          {"id = 1 and age > 50 or id = 2;", false},
+          {"not age >= 70;", false},
+          {"not not age >= 70 and not name != 'Terry';", true},
+          {"100 > id and 2 <= score;", true},
+          {"score > 2 and age = 70.0;", true},
+          {"name < 'Tom' and name >= 'Terry';", true},
+          {"not nick = 'x';", true},
+      };
+      for (const auto &[theClause, theMatch] : theClauses) {
+        std::stringstream theStream(theClause);
+        Tokenizer theTokenizer(theStream);
+        Filters theFilters;
+        if (!theTokenizer.tokenize() ||
+            !theFilters.parse(theTokenizer, theEntity) ||
+            theMatch != theFilters.matches(theRow)) {
+          return false;
+        }
+        // each term alone agrees with the compiled clause's terms
+        const Expressions &theExprs = theFilters.getExpressions();
+        if (1 == theExprs.size() && theMatch != (*theExprs.front())(theRow)) {
+          return false;
+        }
+      }
+      // join terms take each side from its own row
+      std::stringstream theStream("id = age;");
+      Tokenizer theTokenizer(theStream);
+      Filters theFilters;
+      KeyValues theOther{{"id", 9}, {"age", 5}};
+      return theTokenizer.tokenize() &&
+             theFilters.parse(theTokenizer, theEntity) &&
+             Filters::matches(theFilters.getExpressions(), theRow, theOther) &&
+             !Filters::matches(theFilters.getExpressions(), theOther, theRow);
+    }
+
+    bool doCustomVectorizedTest() {
+      // rows with a NULL now and then and a float column holding some ints
+      struct MixedSource : public QueryOperator {
+        size_t count{0};
+        StatusResult open() override {
+          count = 0;
+          return {Errors::noError};
+        }
+        StatusResult next(std::unique_ptr<Row> &aRow) override {
+          aRow.reset();
+          if (count < 50) {
+            int i = static_cast<int>(count);
+            aRow = std::make_unique<Row>(0, static_cast<uint32_t>(count));
+            aRow->insert("id", i);
+            if (0 != i % 20) {
+              aRow->insert("name", std::string(1, 'a' + i % 7));
+            }
+            if (0 == i % 3) {
+              aRow->insert("score", i);
+            } else {
+              aRow->insert("score", i * 1.5);
+            }
+            count++;
+          }
+          return {Errors::noError};
+        }
+        void close() override {}
+      };
+      Entity theEntity("Mixed");
+      theEntity.addAttribute(Attribute("id", DataTypes::int_type, 0))
+          .addAttribute(Attribute("name", DataTypes::varchar_type, 8))
+          .addAttribute(Attribute("score", DataTypes::float_type, 0));
+
+      std::vector<std::string> theClauses{
+          "id > 20;",
+          "id >= 10 and name = 'c';",
+          "not name = 'c';",
+          "score < 30 and id != 6;",
+          "40 < id;",
+          "name >= 'd' and not id <= 35;",
+      };
+      for (const auto &theClause : theClauses) {
+        std::stringstream theStream(theClause);
+        Tokenizer theTokenizer(theStream);
+        Filters theFilters;
+        if (!theTokenizer.tokenize() ||
+            !theFilters.parse(theTokenizer, theEntity) ||
+            !BatchFilterOperator::canRun(theFilters)) {
+          return false;
+        }
+        std::vector<uint32_t> theExpected;
+        MixedSource theSource;
+        std::unique_ptr<Row> theRow;
+        theSource.open();
+        while (theSource.next(theRow) && theRow) {
+          if (theFilters.matches(theRow->getData())) {
+            theExpected.push_back(theRow->getBlockNum());
+          }
+        }
+        // batches of 7: the selection carries across partial batches
+        size_t theSeen{0};
+        UnbatchOperator thePlan(std::make_unique<BatchFilterOperator>(
+            std::make_unique<BatchScanOperator>(
+                std::make_unique<MixedSource>(), theEntity, 7),
+            theFilters,
+            [&](size_t aSeen, size_t, double) { theSeen = aSeen; }));
+        std::vector<uint32_t> theFound;
+        thePlan.open();
+        while (thePlan.next(theRow) && theRow) {
+          theFound.push_back(theRow->getBlockNum());
+        }
+        thePlan.close();
+        if (theExpected != theFound || 50 != theSeen) {
+          return false;
+        }
+      }
+      std::stringstream theStream("id = 1 or id = 2;");
+      Tokenizer theTokenizer(theStream);
+      Filters theFilters;
+      if (!theTokenizer.tokenize() ||
+          !theFilters.parse(theTokenizer, theEntity) ||
+          BatchFilterOperator::canRun(theFilters)) {
+        return false;
+      }
+
+      std::string theDBName("VectorizedDB");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      addBooksTable(theScript);
+      insertUsers(theScript, 0, 10);
+      insertBooks(theScript, 0, 14);
+      theScript << "select * from Users where age>60;\n";
+      theScript << "select title from Books where user_id>=2 and user_id<5 "
+                   "order by title;\n";
+      theScript << "select * from Users where not age>60 limit 3;\n";
+      theScript << "select * from Users where age>60 or age<30;\n";
+      theScript << "select * from Users where age>200;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Responses theResponses;
+      size_t theScriptCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::insert, 14},
+          {Commands::select, 6},
+          {Commands::select, 9},
+          {Commands::select, 3},
+          {Commands::select, 6},
+          {Commands::select, 0},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theScriptCount && theExpected == theResponses;
+    }
+
+    bool doCustomZoneMapTest() {
+      // 40 blocks, 4 per zone; ts grows with the block number and block 20
+      // has no ts at all
+      ZoneMap theMap(4);
+      for (uint32_t theBlock = 0; theBlock < 40; theBlock++) {
+        KeyValues theRow{{"kind", std::string(theBlock % 2 ? "a" : "b")}};
+        if (20 != theBlock) {
+          theRow["ts"] = static_cast<int>(10 * theBlock);
+        }
+        theMap.add(theRow, theBlock);
+      }
+      auto zonesOf = [&](const std::string& aField, Operators anOp,
+                         const Value& aValue) {
+        std::vector<uint32_t> theZones;
+        theMap.candidates({aField, anOp, aValue}).each([&](uint32_t aZone) {
+          theZones.push_back(aZone);
+          return true;
+        });
+        return theZones;
+      };
+      using Zones = std::vector<uint32_t>;
+      if (10 != theMap.getZoneCount() || 7 != theMap.zoneOf(29) ||
+          Zones({5, 7, 8, 9}) != zonesOf("ts", Operators::gt_op, 300) ||
+          Zones({1, 5}) != zonesOf("ts", Operators::equal_op, 55) ||
+          Zones({0, 5}) != zonesOf("ts", Operators::lte_op, 30) ||
+          !zonesOf("kind", Operators::equal_op, std::string("c")).empty() ||
+          10 != zonesOf("kind", Operators::notequal_op, std::string("a"))
+                    .size()) {
+        return false;
+      }
+
+      // one block per zone: stale bounds would lose rows here
+      size_t thePrevBlocks = Config::zoneBlocks;
+      Config::zoneBlocks = 1;
+      std::string theDBName("ZoneDB");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      insertUsers(theScript, 0, 10);
+      theScript << "select * from Users where age > 100;\n";
+      theScript << "select * from Users where age > 100 or "
+                   "zipcode = 92120;\n";
+      theScript << "update Users set age=200 where last_name=King;\n";
+      theScript << "select * from Users where age > 150;\n";
+      insertUsers(theScript, 0, 3);
+      theScript << "select * from Users where age >= 70;\n";
+      theScript << "delete from Users where zipcode=92120;\n";
+      theScript << "select * from Users where not age < 60;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      bool theResult = doScriptTest(theInput, theOutput);
+      Config::zoneBlocks = thePrevBlocks;
+      Responses theResponses;
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::select, 2},
+          {Commands::select, 4},
+          {Commands::update, 1},
+          {Commands::select, 1},
+          {Commands::insert, 3},
+          {Commands::select, 6},
+          {Commands::delet, 3},
+          {Commands::select, 7},
+          {Commands::dropDB, 0},
+      });
+      return theResult && theCount && theExpected == theResponses;
+    }
+
+    bool doCustomStatisticsTest() {
+      Entity theEntity("People");
+      theEntity.addAttribute(Attribute("age", DataTypes::int_type, 0))
+          .addAttribute(Attribute("name", DataTypes::varchar_type, 20))
+          .addAttribute(Attribute("zip", DataTypes::int_type, 0));
+      auto makeRows = [](RowCollection& aRows, int aFirst, int aLast) {
+        for (int i = aFirst; i < aLast; i++) {
+          auto theRow = std::make_unique<Row>();
+          theRow->insert("age", i);
+          theRow->insert("name", "name" + std::to_string(i % 100));
+          if (0 != i % 10) {
+            theRow->insert("zip", 92000 + i % 50);  // 10% null, 45 zips
+          }
+          aRows.push_back(std::move(theRow));
+        }
+      };
+      auto inRange = [](double aValue, double aLow, double aHigh) {
+        return aLow <= aValue && aValue <= aHigh;
+      };
+
+      RowCollection theRows;
+      makeRows(theRows, 0, 1000);
+      TableStats theStats;
+      theStats.analyze(theEntity, theRows);
+      const ColumnStats* theAge = theStats.getColumn("age");
+      const ColumnStats* theName = theStats.getColumn("name");
+      const ColumnStats* theZip = theStats.getColumn("zip");
+      if (1000 != theStats.getRowCount() || !theAge || !theName || !theZip ||
+          !inRange(theAge->getDistinct(), 850, 1000) ||
+          !inRange(theName->getDistinct(), 85, 115) ||
+          !inRange(theZip->getDistinct(), 38, 52) ||
+          100 != theZip->nullCount || Value{0} != theAge->min ||
+          Value{999} != theAge->max) {
+        return false;
+      }
+      if (!inRange(theStats.estimateRows("age", Operators::lt_op, 250), 200,
+                   300) ||
+          !inRange(theStats.estimateRows("age", Operators::gte_op, 900), 70,
+                   130) ||
+          !inRange(theStats.estimateRows("name", Operators::equal_op,
+                                         std::string("name7")),
+                   7, 13) ||
+          !inRange(theStats.estimateRows("zip", Operators::equal_op, 92010),
+                   12, 24) ||
+          0 != theStats.estimateRows("age", Operators::equal_op, 5000)) {
+        return false;
+      }
+
+      // inserts and deletes keep the histogram counts current
+      RowCollection theMore;
+      makeRows(theMore, 1000, 1500);
+      for (const auto& theRow : theMore) {
+        theStats.add(theRow->getData());
+      }
+      if (1500 != theStats.getRowCount() ||
+          !inRange(theStats.estimateRows("age", Operators::gte_op, 1000), 400,
+                   600)) {
+        return false;
+      }
+      for (size_t i = 0; i < 500; i++) {
+        theStats.remove(theRows[i]->getData());
+      }
+      if (1000 != theStats.getRowCount() ||
+          theStats.estimateRows("age", Operators::lt_op, 500) > 60) {
+        return false;
+      }
+
+      // survives an encode/decode round trip
+      std::stringstream theStream;
+      TableStats theCopy;
+      if (!theStats.encode(theStream) || !theCopy.decode(theStream)) {
+        return false;
+      }
+      for (int theAgeValue : {-5, 0, 250, 700, 1200, 2000}) {
+        if (theCopy.estimateRows("age", Operators::lt_op, theAgeValue) !=
+                theStats.estimateRows("age", Operators::lt_op, theAgeValue) ||
+            theCopy.estimateRows("zip", Operators::equal_op,
+                                 92000 + theAgeValue % 50) !=
+                theStats.estimateRows("zip", Operators::equal_op,
+                                      92000 + theAgeValue % 50)) {
+          return false;
+        }
+      }
+
+      // ANALYZE persists the statistics and the engine keeps them current
+      std::string theDBName("StatsDB");
+      std::string theDBName2("Dummy");
+      std::stringstream theScript;
+      theScript << "create database " << theDBName << ";\n";
+      theScript << "create database " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      addUsersTable(theScript);
+      insertUsers(theScript, 0, 10);
+      theScript << "analyze Users;\n";
+      theScript << "dump database " << theDBName << ";\n";
+      theScript << "use " << theDBName2 << ";\n";
+      theScript << "use " << theDBName << ";\n";
+      insertUsers(theScript, 0, 3);
+      theScript << "delete from Users where zipcode=92120;\n";
+      theScript << "create index by_zip on Users (zipcode);\n";
+      theScript << "create index by_last on Users (last_name);\n";
+      theScript << "select * from Users where zipcode=92124 and "
+                   "last_name=Pratchett;\n";
+      theScript << "analyze table Users;\n";
+      theScript << "drop table Users;\n";
+      theScript << "drop database " << theDBName << ";\n";
+      theScript << "drop database " << theDBName2 << ";\n";
+      theScript << "quit;\n";
+
+      std::stringstream theInput(theScript.str());
+      std::stringstream theOutput;
+      if (!doScriptTest(theInput, theOutput)) {
+        return false;
+      }
+      std::string theText = theOutput.str();
+      size_t theAnalyzed{0};
+      for (size_t thePos = theText.find("|zipcode");
+           std::string::npos != thePos;
+           thePos = theText.find("|zipcode", thePos + 1)) {
+        theAnalyzed++;
+      }
+      Responses theResponses;
+      size_t theCount = analyzeOutput(theOutput, theResponses);
+      Expected theExpected({
+          {Commands::createDB, 1},
+          {Commands::createDB, 1},
+          {Commands::useDB, 0},
+          {Commands::createTable, 1},
+          {Commands::insert, 10},
+          {Commands::dumpDB, 16},
+          {Commands::useDB, 0},
+          {Commands::useDB, 0},
+          {Commands::insert, 3},
+          {Commands::delet, 3},
+          {Commands::select, 2},
+          {Commands::dropTable, 11},
+          {Commands::dropDB, 0},
+          {Commands::dropDB, 0},
+      });
+      return 2 == theAnalyzed && theCount && theExpected == theResponses;
+    }
+
     // ----------------------------------------------------
     bool doALLTest() {
       using TestCall = std::function<bool()>;
@@ -1652,15 +3904,42 @@ namespace ECE141 {
       };
 
       static std::map<std::string, TestCall> theCustomCalls{
+          {"AdaptiveRadixTree",
+           [&]() { return doCustomAdaptiveRadixTreeTest(); }},
+          {"BitmapIndex", [&]() { return doCustomBitmapIndexTest(); }},
+          {"BloomFilter", [&]() { return doCustomBloomFilterTest(); }},
+          {"CompiledFilter", [&]() { return doCustomCompiledFilterTest(); }},
+          {"CompositeIndex", [&]() { return doCustomCompositeIndexTest(); }},
+          {"CoveringIndex", [&]() { return doCustomCoveringIndexTest(); }},
           {"CustomIndex", [&]() { return doCustomIndexTest(); }},
+          {"ExternalOrderBy",
+           [&]() { return doCustomExternalOrderByTest(); }},
+          {"ExternalSort", [&]() { return doCustomExternalSortTest(); }},
+          {"FrontCoding", [&]() { return doCustomFrontCodingTest(); }},
+          {"FullText", [&]() { return doCustomFullTextTest(); }},
+          {"GroupVarint", [&]() { return doCustomGroupVarintTest(); }},
+          {"HashJoin", [&]() { return doCustomHashJoinTest(); }},
+          {"IndexAdvice", [&]() { return doCustomIndexAdviceTest(); }},
+          {"IndexJoin", [&]() { return doCustomIndexJoinTest(); }},
+          {"LazyIndex", [&]() { return doCustomLazyIndexTest(); }},
           // {"LeftJoin", [&]() { return doCustomLeftJoinTest(); }},
           {"LogicalEdgeSelect",
            [&]() { return doCustomLogicalSelectEdgeTest(); }},
           {"LogicalSelect", [&]() { return doLogicSelectTest(); }},
+          {"MergeJoin", [&]() { return doCustomMergeJoinTest(); }},
+          {"ParallelIndex", [&]() { return doCustomParallelIndexTest(); }},
+          {"ParallelScan", [&]() { return doCustomParallelScanTest(); }},
+          {"ParallelSort", [&]() { return doCustomParallelSortTest(); }},
+          {"Pipeline", [&]() { return doCustomPipelineTest(); }},
           {"Save", [&]() { return doCustomSaveTest(); }},
           {"SaveAndLoad", [&]() { return doCustomLoadTest(); }},
+          {"Scheduler", [&]() { return doCustomSchedulerTest(); }},
           {"SelfSwitch", [&]() { return doSelfSwitchDBTest(); }},
+          {"Statistics", [&]() { return doCustomStatisticsTest(); }},
           {"Switch", [&]() { return doCustomSwitchDBTest(); }},
+          {"Unique", [&]() { return doCustomUniqueTest(); }},
+          {"Vectorized", [&]() { return doCustomVectorizedTest(); }},
+          {"ZoneMap", [&]() { return doCustomZoneMapTest(); }},
       };
       std::vector<std::pair<std::string, std::string>> theCustomMessages;
 
@@ -39,6 +39,8 @@ void showError(ECE141::StatusResult &aResult, std::ostream &anOutput) {
       {ECE141::Errors::integerExpected, "integer Expected"},
       {ECE141::Errors::invalidExpression, "invalid Expression"},
       {ECE141::Errors::fileDoesNotExist, "fileDoesNotExist"},
+      {ECE141::Errors::indexExists, "Index exists"},
+      {ECE141::Errors::uniqueViolation, "Duplicate entry for unique key"},
       
       
       };
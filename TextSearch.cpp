@@ -0,0 +1,134 @@
+/**
+ * @file TextSearch.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "TextSearch.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+
+namespace ECE141 {
+
+static bool isTermChar(char aChar) {
+  return std::isalnum(static_cast<unsigned char>(aChar)) != 0;
+}
+
+static char lower(char aChar) {
+  return static_cast<char>(std::tolower(static_cast<unsigned char>(aChar)));
+}
+
+StringList TextSearch::terms(const std::string &aText) {
+  StringList theTerms;
+  std::string theTerm;
+  for (char theChar : aText) {
+    if (isTermChar(theChar)) {
+      theTerm += lower(theChar);
+    } else if (!theTerm.empty()) {
+      theTerms.push_back(theTerm);
+      theTerm.clear();
+    }
+  }
+  if (!theTerm.empty()) {
+    theTerms.push_back(theTerm);
+  }
+  return theTerms;
+}
+
+bool TextSearch::like(const std::string &aText, const std::string &aPattern) {
+  // greedy wildcard match, backtracking to the last '%'
+  size_t theText{0}, thePattern{0};
+  size_t theStar{std::string::npos}, theResume{0};
+  while (theText < aText.size()) {
+    if (thePattern < aPattern.size() &&
+        (aPattern[thePattern] == '_' ||
+         (aPattern[thePattern] != '%' &&
+          lower(aPattern[thePattern]) == lower(aText[theText])))) {
+      theText++;
+      thePattern++;
+    } else if (thePattern < aPattern.size() && aPattern[thePattern] == '%') {
+      theStar = thePattern++;
+      theResume = theText;
+    } else if (theStar != std::string::npos) {
+      thePattern = theStar + 1;
+      theText = ++theResume;
+    } else {
+      return false;
+    }
+  }
+  while (thePattern < aPattern.size() && aPattern[thePattern] == '%') {
+    thePattern++;
+  }
+  return thePattern == aPattern.size();
+}
+
+bool TextSearch::matchesAll(const std::string &aText,
+                            const std::string &aQuery) {
+  StringList theWanted{terms(aQuery)};
+  if (theWanted.empty()) {
+    return false;
+  }
+  StringList theTerms{terms(aText)};
+  std::set<std::string> theHave(theTerms.begin(), theTerms.end());
+  return std::all_of(
+      theWanted.begin(), theWanted.end(),
+      [&](const std::string &aTerm) { return theHave.count(aTerm) > 0; });
+}
+
+std::vector<TextSearch::Piece> TextSearch::likePieces(
+    const std::string &aPattern) {
+  // a literal run of term characters lies inside one term of the text; it
+  // is that term's start when something that is not a term character (or
+  // the start of the pattern) comes before it, and its end likewise
+  std::vector<Piece> thePieces;
+  size_t thePos{0};
+  while (thePos < aPattern.size()) {
+    if (!isTermChar(aPattern[thePos])) {
+      thePos++;
+      continue;
+    }
+    size_t theEnd{thePos};
+    std::string theText;
+    while (theEnd < aPattern.size() && isTermChar(aPattern[theEnd])) {
+      theText += lower(aPattern[theEnd++]);
+    }
+    bool theStart{0 == thePos ||
+                  (aPattern[thePos - 1] != '%' && aPattern[thePos - 1] != '_')};
+    bool theStop{theEnd == aPattern.size() ||
+                 (aPattern[theEnd] != '%' && aPattern[theEnd] != '_')};
+    Anchor theAnchor{theStart && theStop ? Anchor::exact
+                     : theStart          ? Anchor::prefix
+                     : theStop           ? Anchor::suffix
+                                         : Anchor::substring};
+    thePieces.push_back({theText, theAnchor});
+    thePos = theEnd;
+  }
+  return thePieces;
+}
+
+bool TextSearch::fits(const std::string &aTerm, const Piece &aPiece) {
+  const std::string &thePiece = aPiece.text;
+  if (aTerm.size() < thePiece.size()) {
+    return false;
+  }
+  switch (aPiece.anchor) {
+    case Anchor::exact:
+      return aTerm == thePiece;
+    case Anchor::prefix:
+      return 0 == aTerm.compare(0, thePiece.size(), thePiece);
+    case Anchor::suffix:
+      return 0 == aTerm.compare(aTerm.size() - thePiece.size(),
+                                thePiece.size(), thePiece);
+    default:
+      return aTerm.find(thePiece) != std::string::npos;
+  }
+}
+
+}  // namespace ECE141
@@ -0,0 +1,47 @@
+/**
+ * @file TextSearch.hpp
+ * @author Yifan Wu
+ * @brief word-level text matching for LIKE / MATCH and full-text indexes
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef TextSearch_hpp
+#define TextSearch_hpp
+
+#include <string>
+#include <vector>
+
+#include "BasicTypes.hpp"
+
+namespace ECE141 {
+
+// USE: a term is a maximal run of letters and digits, lowercased. LIKE and
+//      MATCH compare case-insensitively, so a full-text index of the terms
+//      can answer both.
+class TextSearch {
+ public:
+  static StringList terms(const std::string &aText);
+
+  // SQL LIKE: '%' matches any run of characters, '_' exactly one
+  static bool like(const std::string &aText, const std::string &aPattern);
+  // every term of aQuery is a term of aText (an empty query matches nothing)
+  static bool matchesAll(const std::string &aText, const std::string &aQuery);
+
+  // where a piece of a LIKE pattern must sit inside one term of the text
+  enum class Anchor { exact, prefix, suffix, substring };
+  struct Piece {
+    std::string text;
+    Anchor anchor;
+  };
+  // pieces every text matching aPattern contains (empty: none known)
+  static std::vector<Piece> likePieces(const std::string &aPattern);
+  static bool fits(const std::string &aTerm, const Piece &aPiece);
+};
+
+}  // namespace ECE141
+
+#endif /* TextSearch_hpp */
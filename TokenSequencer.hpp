@@ -72,7 +72,11 @@ class TokenSequencer {
                            {Keywords::primary_kw, Keywords::key_kw})) {
               theAttr.setPrimaryKey(true);
               state = true;
+            } else if (clear().currentIs({Keywords::unique_kw})) {
+              theAttr.setUnique(true);
+              state = true;
             } else if (clear().currentIs({Keywords::default_kw})) {
+              theAttr.setDefaultValStr(tokenizer.current().data);
               theAttr.setDefaultVal(theAttr.toValue(tokenizer.current().data));
               tokenizer.next();
               state = true;
@@ -41,7 +41,8 @@ bool isPunctuation(char aChar) { return std::strchr("()[]{}:;,", aChar); }
 
 bool isUnknown(char aChar) {
   return !isWhitespace(aChar) && !isNumber(aChar) && !isAlphaNum(aChar) &&
-         !isQuote(aChar) && !isOperator(aChar) && !isPunctuation(aChar);
+         !isQuote(aChar) && apostrophe != aChar && !isOperator(aChar) &&
+         !isPunctuation(aChar);
 }
 
 //-----------------------------------
@@ -154,7 +155,7 @@ StatusResult Tokenizer::tokenize() {
       input.get();  // skip first quote...
       Token theToken{TokenType::identifier, Keywords::unknown_kw,
                      Operators::unknown_op};
-      theToken.data = readUntil(theChar);
+      theToken.data = readUntil(theChar, false);  // closing quote is eaten
       tokens.push_back(theToken);
     } else if (isAlphaNum(theChar)) {
       std::string theString = readWhile(isAlphaNum);
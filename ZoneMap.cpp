@@ -0,0 +1,86 @@
+/**
+ * @file ZoneMap.cpp
+ * @author Yifan Wu
+ * @brief
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "ZoneMap.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace ECE141 {
+
+ZoneMap::ZoneMap(uint32_t aZoneBlocks)
+    : zoneBlocks{std::max<uint32_t>(aZoneBlocks, 1)} {}
+
+ZoneMap &ZoneMap::add(const KeyValues &aRow, uint32_t aBlockNum) {
+  Zone &theZone = zones[zoneOf(aBlockNum)];
+  theZone.rows++;
+  for (const auto &[theField, theValue] : aRow) {
+    Value theCopy{theValue};
+    auto [theIter, theAdded] =
+        theZone.columns.emplace(theField, Range{theValue, theValue});
+    Range &theRange = theIter->second;
+    if (!theAdded) {
+      // the same comparisons the where clause applies to the rows
+      if (lessThan(theCopy, theRange.min)) {
+        theRange.min = theValue;
+      }
+      if (lessThan(theRange.max, theCopy)) {
+        theRange.max = theValue;
+      }
+    }
+    theRange.count++;
+  }
+  return *this;
+}
+
+bool ZoneMap::mayMatch(const Range &aRange, Operators anOp,
+                       const Value &aValue) {
+  Value theValue{aValue};
+  Value theMin{aRange.min};
+  Value theMax{aRange.max};
+  switch (anOp) {
+    case Operators::equal_op:
+      return !lessThan(theValue, theMin) && !lessThan(theMax, theValue);
+    case Operators::notequal_op:
+      return !(equals(theMin, theValue) && equals(theMax, theValue));
+    case Operators::lt_op:
+      return lessThan(theMin, theValue);
+    case Operators::lte_op:
+      return lessEquals(theMin, theValue);
+    case Operators::gt_op:
+      return greaterThan(theMax, theValue);
+    case Operators::gte_op:
+      return greaterEquals(theMax, theValue);
+    default:
+      return true;
+  }
+}
+
+RoaringBitmap ZoneMap::candidates(const Predicate &aPredicate) const {
+  RoaringBitmap theZones;
+  for (const auto &[theZoneNum, theZone] : zones) {
+    auto theIter = theZone.columns.find(aPredicate.field);
+    if (theIter == theZone.columns.end() ||
+        theIter->second.count < theZone.rows ||
+        mayMatch(theIter->second, aPredicate.op, aPredicate.value)) {
+      theZones.add(theZoneNum);
+    }
+  }
+  return theZones;
+}
+
+uint32_t ZoneMap::zoneOf(uint32_t aBlockNum) const {
+  return aBlockNum / zoneBlocks;
+}
+
+size_t ZoneMap::getZoneCount() const { return zones.size(); }
+
+}  // namespace ECE141
@@ -0,0 +1,65 @@
+/**
+ * @file ZoneMap.hpp
+ * @author Yifan Wu
+ * @brief per-extent min/max of a table's columns, for skipping blocks
+ * @version 0.9
+ * @date 2022-06-09
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef ZoneMap_hpp
+#define ZoneMap_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "BasicTypes.hpp"
+#include "Filters.hpp"
+#include "RoaringBitmap.hpp"
+
+namespace ECE141 {
+
+// USE: a zone is a run of zoneBlocks consecutive block numbers. For every
+//      zone holding rows of the table it keeps each column's min/max, so a
+//      scan can skip the zones a where clause rules out without reading
+//      their blocks. Bounds only widen (deletes leave them as they are).
+class ZoneMap {
+ public:
+  explicit ZoneMap(uint32_t aZoneBlocks);
+
+  // aRow was written to aBlockNum (insert, or the new image of an update)
+  ZoneMap &add(const KeyValues &aRow, uint32_t aBlockNum);
+
+  // zones that may hold a row where aPredicate holds; rows without a value
+  // for the field always may
+  [[nodiscard]] RoaringBitmap candidates(const Predicate &aPredicate) const;
+
+  [[nodiscard]] uint32_t zoneOf(uint32_t aBlockNum) const;
+  [[nodiscard]] size_t getZoneCount() const;
+
+ protected:
+  struct Range {
+    Value min;
+    Value max;
+    size_t count{0};  // rows with a value
+  };
+  struct Zone {
+    size_t rows{0};
+    std::map<std::string, Range> columns;
+  };
+
+  static bool mayMatch(const Range &aRange, Operators anOp,
+                       const Value &aValue);
+
+  uint32_t zoneBlocks;
+  std::map<uint32_t, Zone> zones;
+};
+
+}  // namespace ECE141
+
+#endif /* ZoneMap_hpp */
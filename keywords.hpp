@@ -22,14 +22,17 @@ namespace ECE141 {
 // languages...
 enum class Keywords {
   add_kw = 1,
+  advice_kw,
   all_kw,
   alter_kw,
+  analyze_kw,
   and_kw,
   as_kw,
   asc_kw,
   avg_kw,
   auto_increment_kw,
   between_kw,
+  bitmap_kw,
   boolean_kw,
   by_kw,
   change_kw,
@@ -60,9 +63,11 @@ enum class Keywords {
   foreign_kw,
   from_kw,
   full_kw,
+  fulltext_kw,
   group_kw,
   help_kw,
   in_kw,
+  include_kw,
   index_kw,
   indexes_kw,
   inner_kw,
@@ -75,6 +80,7 @@ enum class Keywords {
   left_kw,
   like_kw,
   limit_kw,
+  match_kw,
   max_kw,
   min_kw,
   modify_kw,
@@ -84,6 +90,7 @@ enum class Keywords {
   or_kw,
   order_kw,
   outer_kw,
+  parallel_kw,
   primary_kw,
   query_kw,
   quit_kw,
@@ -106,10 +113,12 @@ enum class Keywords {
   varchar_kw,
   version_kw,
   where_kw,
+  with_kw,
 
   // custom -----------------------
   default_kw,
   run_kw,
+  workers_kw,
 };
 
 // This enum defines operators that will be used in SQL commands...
@@ -132,6 +141,10 @@ enum class Operators {
   divide_op,
   power_op,
   mod_op,
+  like_op,
+  notlike_op,
+  match_op,
+  notmatch_op,
   unknown_op
 };
 
@@ -49,16 +49,49 @@ int main(int argc, const char* argv[]) {
 
         // ? custom-------------------------------------------------------
         {"Custom", [&]() { return theTests.doCustomTablesTest(); }},
+        {"AdaptiveRadixTree",
+         [&]() { return theTests.doCustomAdaptiveRadixTreeTest(); }},
+        {"BitmapIndex", [&]() { return theTests.doCustomBitmapIndexTest(); }},
+        {"BloomFilter", [&]() { return theTests.doCustomBloomFilterTest(); }},
+        {"CompiledFilter",
+         [&]() { return theTests.doCustomCompiledFilterTest(); }},
+        {"CompositeIndex",
+         [&]() { return theTests.doCustomCompositeIndexTest(); }},
+        {"CoveringIndex",
+         [&]() { return theTests.doCustomCoveringIndexTest(); }},
         {"CustomIndex", [&]() { return theTests.doCustomIndexTest(); }},
         {"DebugTable", [&]() { return theTests.doDebugTablesTest(); }},
+        {"ExternalOrderBy",
+         [&]() { return theTests.doCustomExternalOrderByTest(); }},
+        {"ExternalSort", [&]() { return theTests.doCustomExternalSortTest(); }},
+        {"FrontCoding", [&]() { return theTests.doCustomFrontCodingTest(); }},
+        {"FullText", [&]() { return theTests.doCustomFullTextTest(); }},
+        {"GroupVarint", [&]() { return theTests.doCustomGroupVarintTest(); }},
+        {"HashJoin", [&]() { return theTests.doCustomHashJoinTest(); }},
+        {"IndexAdvice", [&]() { return theTests.doCustomIndexAdviceTest(); }},
+        {"IndexJoin", [&]() { return theTests.doCustomIndexJoinTest(); }},
+        {"LazyIndex", [&]() { return theTests.doCustomLazyIndexTest(); }},
         {"LeftJoin", [&]() { return theTests.doCustomLeftJoinTest(); }},
         {"Load", [&]() { return theTests.doCustomLoadTest(); }},
         {"LogicalEdgeSelect",
          [&]() { return theTests.doCustomLogicalSelectEdgeTest(); }},
         {"LogicalSelect", [&]() { return theTests.doLogicSelectTest(); }},
+        {"MergeJoin", [&]() { return theTests.doCustomMergeJoinTest(); }},
+        {"ParallelIndex",
+         [&]() { return theTests.doCustomParallelIndexTest(); }},
+        {"ParallelScan",
+         [&]() { return theTests.doCustomParallelScanTest(); }},
+        {"ParallelSort",
+         [&]() { return theTests.doCustomParallelSortTest(); }},
+        {"Pipeline", [&]() { return theTests.doCustomPipelineTest(); }},
         {"Save", [&]() { return theTests.doCustomSaveTest(); }},
+        {"Scheduler", [&]() { return theTests.doCustomSchedulerTest(); }},
         {"SelfSwitch", [&]() { return theTests.doSelfSwitchDBTest(); }},
+        {"Statistics", [&]() { return theTests.doCustomStatisticsTest(); }},
         {"Switch", [&]() { return theTests.doCustomSwitchDBTest(); }},
+        {"Unique", [&]() { return theTests.doCustomUniqueTest(); }},
+        {"Vectorized", [&]() { return theTests.doCustomVectorizedTest(); }},
+        {"ZoneMap", [&]() { return theTests.doCustomZoneMapTest(); }},
 
         // All test combined
         {"All", [&]() { return theTests.doALLTest(); }},